@@ -27,6 +27,10 @@
 #include "thread_gthread.h"
 #include "condition_variable.h"
 #include "gthr_key.h"
+#include "freertos_lock_profiler.h"
+#include "freertos_mutex.h"
+#include "freertos_trace.h"
+#include "freertos_clock.h"
 
 #include <sys/time.h>
 
@@ -37,9 +41,34 @@ namespace free_rtos_std
   struct Once
   {
     bool v = false;
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    StaticSemaphore_t storage;
+    SemaphoreHandle_t m = xSemaphoreCreateMutexStatic(&storage);
+#else
     SemaphoreHandle_t m = xSemaphoreCreateMutex();
+#endif
     ~Once() { vSemaphoreDelete(m); }
   };
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  // Mutex with the kernel object embedded. std::mutex is neither copyable
+  // nor movable, so the handle pointing to 'storage' stays valid.
+  struct static_mutex
+  {
+    SemaphoreHandle_t handle;
+    StaticSemaphore_t storage;
+  };
+
+  inline SemaphoreHandle_t mutex_handle(static_mutex *mutex)
+  {
+    return mutex->handle;
+  }
+#else
+  inline SemaphoreHandle_t mutex_handle(SemaphoreHandle_t *mutex)
+  {
+    return *mutex;
+  }
+#endif
 }
 
 extern "C"
@@ -53,8 +82,18 @@ extern "C"
 
   typedef free_rtos_std::Key *__gthread_key_t;
   typedef free_rtos_std::Once __gthread_once_t;
+#if (configSTD_FAST_MUTEX == 1)
+  typedef free_rtos_std::fast_mutex __gthread_mutex_t;
+#elif (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  typedef free_rtos_std::static_mutex __gthread_mutex_t;
+#else
   typedef SemaphoreHandle_t __gthread_mutex_t;
+#endif
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  typedef free_rtos_std::static_mutex __gthread_recursive_mutex_t;
+#else
   typedef SemaphoreHandle_t __gthread_recursive_mutex_t;
+#endif
   typedef free_rtos_std::cv_task_list __gthread_cond_t;
 
 #define __GTHREAD_ONCE_INIT free_rtos_std::Once()
@@ -62,12 +101,30 @@ extern "C"
   static inline void __GTHREAD_RECURSIVE_MUTEX_INIT_FUNCTION(
       __gthread_recursive_mutex_t *mutex)
   {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    mutex->handle = xSemaphoreCreateRecursiveMutexStatic(&mutex->storage);
+#else
     *mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+  }
+#if (configSTD_FAST_MUTEX == 1)
+  // Nothing to create, std::mutex gets a constexpr constructor.
+#define __GTHREAD_MUTEX_INIT free_rtos_std::fast_mutex()
+
+  static inline void __GTHREAD_MUTEX_INIT_FUNCTION(__gthread_mutex_t *mutex)
+  {
+    *mutex = free_rtos_std::fast_mutex();
   }
+#else
   static inline void __GTHREAD_MUTEX_INIT_FUNCTION(__gthread_mutex_t *mutex)
   {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    mutex->handle = xSemaphoreCreateMutexStatic(&mutex->storage);
+#else
     *mutex = xSemaphoreCreateMutex();
+#endif
   }
+#endif
 
   static int __gthread_once(__gthread_once_t *once, void (*func)(void))
   {
@@ -78,7 +135,10 @@ extern "C"
     xSemaphoreTake(once->m, portMAX_DELAY);
     std::swap(once->v, flag);
     if (flag == false)
+    {
+      free_rtos_std::trace::record_event(free_rtos_std::trace::event::once, once);
       func();
+    }
     xSemaphoreGive(once->m);
 
     return 0;
@@ -101,6 +161,7 @@ extern "C"
 
   static int __gthread_setspecific(__gthread_key_t key, const void *ptr)
   {
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::key_set, key);
     return free_rtos_std::freertos_gthread_setspecific(key, ptr);
   }
   //////////
@@ -108,43 +169,43 @@ extern "C"
   //////////
   static inline int __gthread_mutex_destroy(__gthread_mutex_t *mutex)
   {
-    vSemaphoreDelete(*mutex);
+    free_rtos_std::mutex_delete(free_rtos_std::mutex_handle(mutex));
     return 0;
   }
   static inline int __gthread_recursive_mutex_destroy(
       __gthread_recursive_mutex_t *mutex)
   {
-    vSemaphoreDelete(*mutex);
+    free_rtos_std::mutex_delete(free_rtos_std::mutex_handle(mutex));
     return 0;
   }
 
   static inline int __gthread_mutex_lock(__gthread_mutex_t *mutex)
   {
-    return (xSemaphoreTake(*mutex, portMAX_DELAY) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::mutex_take(free_rtos_std::mutex_handle(mutex), portMAX_DELAY) == pdTRUE) ? 0 : 1;
   }
   static inline int __gthread_mutex_trylock(__gthread_mutex_t *mutex)
   {
-    return (xSemaphoreTake(*mutex, 0) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::mutex_take(free_rtos_std::mutex_handle(mutex), 0) == pdTRUE) ? 0 : 1;
   }
   static inline int __gthread_mutex_unlock(__gthread_mutex_t *mutex)
   {
-    return (xSemaphoreGive(*mutex) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::mutex_give(free_rtos_std::mutex_handle(mutex)) == pdTRUE) ? 0 : 1;
   }
 
   static inline int __gthread_recursive_mutex_lock(
       __gthread_recursive_mutex_t *mutex)
   {
-    return (xSemaphoreTakeRecursive(*mutex, portMAX_DELAY) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::recursive_mutex_take(free_rtos_std::mutex_handle(mutex), portMAX_DELAY) == pdTRUE) ? 0 : 1;
   }
   static inline int __gthread_recursive_mutex_trylock(
       __gthread_recursive_mutex_t *mutex)
   {
-    return (xSemaphoreTakeRecursive(*mutex, 0) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::recursive_mutex_take(free_rtos_std::mutex_handle(mutex), 0) == pdTRUE) ? 0 : 1;
   }
   static inline int __gthread_recursive_mutex_unlock(
       __gthread_recursive_mutex_t *mutex)
   {
-    return (xSemaphoreGiveRecursive(*mutex) == pdTRUE) ? 0 : 1;
+    return (free_rtos_std::recursive_mutex_give(free_rtos_std::mutex_handle(mutex)) == pdTRUE) ? 0 : 1;
   }
 ////////////
 
@@ -159,13 +220,17 @@ extern "C"
     {
       return int64_t(sec) * 1000 + nsec / 1'000'000;
     }
+    int64_t nanoseconds() const
+    {
+      return int64_t(sec) * 1'000'000'000 + nsec;
+    }
   };
 
   static inline __gthread_time_t operator-(
       const __gthread_time_t &lhs, const timeval &rhs)
   {
-    int32_t s{lhs.sec - rhs.tv_sec};
-    int32_t ns{lhs.nsec - rhs.tv_usec * 1000};
+    long s = lhs.sec - rhs.tv_sec;
+    long ns = lhs.nsec - rhs.tv_usec * 1000;
 
     return __gthread_time_t{s, ns};
   }
@@ -176,8 +241,8 @@ extern "C"
     timeval now{};
     gettimeofday(&now, NULL);
 
-    auto t = (*abs_timeout - now).milliseconds();
-    return (xSemaphoreTake(*m, pdMS_TO_TICKS(t)) == pdTRUE) ? 0 : 1;
+    auto ticks = free_rtos_std::timeout_ticks((*abs_timeout - now).nanoseconds());
+    return (free_rtos_std::mutex_take(free_rtos_std::mutex_handle(m), ticks) == pdTRUE) ? 0 : 1;
   }
 
   static inline int __gthread_recursive_mutex_timedlock(
@@ -186,9 +251,67 @@ extern "C"
     timeval now{};
     gettimeofday(&now, NULL);
 
-    auto t = (*abs_time - now).milliseconds();
-    return (xSemaphoreTakeRecursive(*m, pdMS_TO_TICKS(t)) == pdTRUE) ? 0 : 1;
+    auto ticks = free_rtos_std::timeout_ticks((*abs_time - now).nanoseconds());
+    return (free_rtos_std::recursive_mutex_take(free_rtos_std::mutex_handle(m), ticks) == pdTRUE) ? 0 : 1;
+  }
+
+#if (configSTD_SHARED_MUTEX == 1)
+  // Reader-writer lock, see freertos_mutex.h. libstdc++ builds
+  // std::shared_mutex from a mutex and two condition variables and has no
+  // hook for it. free_rtos_std::shared_mutex (freertos_shared_mutex.h) uses
+  // these functions instead.
+  typedef free_rtos_std::rwlock __gthread_rwlock_t;
+#define __GTHREAD_RWLOCK_INIT free_rtos_std::rwlock()
+
+  static inline int __gthread_rwlock_rdlock(__gthread_rwlock_t *rwlock)
+  {
+    return rwlock->lock_shared(portMAX_DELAY) ? 0 : 1;
+  }
+  static inline int __gthread_rwlock_tryrdlock(__gthread_rwlock_t *rwlock)
+  {
+    return rwlock->try_lock_shared() ? 0 : 1;
   }
+  static inline int __gthread_rwlock_timedrdlock(
+      __gthread_rwlock_t *rwlock, const __gthread_time_t *abs_timeout)
+  {
+    timeval now{};
+    gettimeofday(&now, NULL);
+
+    auto ticks = free_rtos_std::timeout_ticks((*abs_timeout - now).nanoseconds());
+    return rwlock->lock_shared(ticks) ? 0 : 1;
+  }
+  static inline int __gthread_rwlock_wrlock(__gthread_rwlock_t *rwlock)
+  {
+    return rwlock->lock(portMAX_DELAY) ? 0 : 1;
+  }
+  static inline int __gthread_rwlock_trywrlock(__gthread_rwlock_t *rwlock)
+  {
+    return rwlock->try_lock() ? 0 : 1;
+  }
+  static inline int __gthread_rwlock_timedwrlock(
+      __gthread_rwlock_t *rwlock, const __gthread_time_t *abs_timeout)
+  {
+    timeval now{};
+    gettimeofday(&now, NULL);
+
+    auto ticks = free_rtos_std::timeout_ticks((*abs_timeout - now).nanoseconds());
+    return rwlock->lock(ticks) ? 0 : 1;
+  }
+  // Like pthread_rwlock_unlock, for both the shared and the exclusive lock.
+  static inline int __gthread_rwlock_unlock(__gthread_rwlock_t *rwlock)
+  {
+    if (rwlock->locked_exclusive())
+      rwlock->unlock();
+    else
+      rwlock->unlock_shared();
+    return 0;
+  }
+  static inline int __gthread_rwlock_destroy(__gthread_rwlock_t *rwlock)
+  {
+    // nothing to do
+    return 0;
+  }
+#endif
 
   // All functions returning int should return zero on success or the error
   //    number.  If the operation is not supported, -1 is returned.
@@ -225,27 +348,15 @@ extern "C"
 
   static inline int __gthread_cond_signal(__gthread_cond_t *cond)
   {
-    cond->lock();
-    if (!cond->empty())
-    {
-      auto t = cond->front();
-      cond->pop();
-      xTaskNotifyGive(t);
-    }
-    cond->unlock();
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_signal, cond);
+    cond->notify_one();
     return 0;
   }
 
   static inline int __gthread_cond_broadcast(__gthread_cond_t *cond)
   {
-    cond->lock();
-    while (!cond->empty())
-    {
-      auto t = cond->front();
-      cond->pop();
-      xTaskNotifyGive(t);
-    }
-    cond->unlock();
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_broadcast, cond);
+    cond->notify_all();
     return 0;
   }
 
@@ -259,12 +370,13 @@ extern "C"
   {
     // Note: 'mutex' is taken before entering this function
 
-    cond->lock();
-    cond->push(__gthread_t::native_task_handle());
-    cond->unlock();
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_wait, cond);
+    __gthread_cond_t::waiter w;
+    cond->push(w);
 
     __gthread_mutex_unlock(mutex);
-    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    (void)cond->wait(w, portMAX_DELAY);
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_wake, cond);
     __gthread_mutex_lock(mutex); // lock and return
     return 0;
   }
@@ -273,30 +385,22 @@ extern "C"
       __gthread_cond_t *cond, __gthread_mutex_t *mutex,
       const __gthread_time_t *abs_timeout)
   {
-    auto this_thrd_hndl{__gthread_t::native_task_handle()};
-    cond->lock();
-    cond->push(this_thrd_hndl);
-    cond->unlock();
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_wait, cond);
+    __gthread_cond_t::waiter w;
+    cond->push(w);
 
     timeval now{};
     gettimeofday(&now, NULL);
 
-    auto ms{(*abs_timeout - now).milliseconds()};
+    auto ticks{free_rtos_std::timeout_ticks((*abs_timeout - now).nanoseconds())};
 
     __gthread_mutex_unlock(mutex);
-    auto fTimeout{0 == ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms))};
+    // On timeout the waiter has been removed from the waiting list.
+    auto fTimeout{!cond->wait(w, ticks)};
+    free_rtos_std::trace::record_event(free_rtos_std::trace::event::cv_wake, cond);
     __gthread_mutex_lock(mutex);
 
-    int result{0};
-    if (fTimeout)
-    { // timeout - remove the thread from the waiting list
-      cond->lock();
-      cond->remove(this_thrd_hndl);
-      cond->unlock();
-      result = 138; // posix ETIMEDOUT
-    }
-
-    return result;
+    return fTimeout ? 138 : 0; // posix ETIMEDOUT
   }
 
 } // extern "C"
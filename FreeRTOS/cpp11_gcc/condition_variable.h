@@ -23,83 +23,65 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
-#include "semphr.h"
-#include "thread_gthread.h"
-
-#include <list>
-#include <bits/functexcept.h>
+#include "critical_section.h"
+#include "freertos_wait_queue.h"
 
 namespace free_rtos_std
 {
 
-class semaphore
-{
-public:
-  semaphore() : _xSemaphore { xSemaphoreCreateBinary() }
-  {
-    if (!_xSemaphore)
-      std::__throw_system_error(12); // POSIX error: no memory
-    xSemaphoreGive(_xSemaphore);
-  }
-
-  void lock() { xSemaphoreTake(_xSemaphore, portMAX_DELAY); }
-  void unlock() { xSemaphoreGive(_xSemaphore); }
-
-  ~semaphore()
-  {
-    vSemaphoreDelete(_xSemaphore);
-  }
-
-  semaphore(const semaphore &) = delete;
-  semaphore(semaphore &&) = delete;
-  semaphore &operator=(semaphore &) = delete;
-  semaphore &operator=(semaphore &&) = delete;
-
-private:
-  SemaphoreHandle_t _xSemaphore;
-};
-
 // Internal free rtos task's container to support condition variable.
-// Condition variable must know all the threads waiting in a queue.
+// Condition variable must know all the threads waiting in a queue. A waiter
+// is a node on the stack of the waiting thread (freertos_wait_queue.h), so a
+// wait allocates nothing, and the queue can be notified from an ISR.
 //
 class cv_task_list
 {
 public:
-  using __gthread_t = free_rtos_std::gthr_freertos;
-  using thrd_type = __gthread_t::native_task_type;
-  using queue_type = std::list<thrd_type>;
+  using waiter = internal::wait_queue::waiter;
 
   cv_task_list() = default;
 
-  void remove(thrd_type thrd) { _que.remove(thrd); }
-  void push(thrd_type thrd) { _que.push_back(thrd); }
-  void pop() { _que.pop_front(); }
-  bool empty() const { return _que.empty(); }
-
-  ~cv_task_list()
-  {
-    lock();
-    _que = queue_type{};
-    unlock();
-  }
-
   // no copy and no move
   cv_task_list &operator=(const cv_task_list &r) = delete;
   cv_task_list &operator=(cv_task_list &&r) = delete;
   cv_task_list(cv_task_list &&) = delete;
   cv_task_list(const cv_task_list &) = delete;
 
-  thrd_type &front() { return _que.front(); }
-  const thrd_type &front() const { return _que.front(); }
-  thrd_type &back() { return _que.back(); }
-  const thrd_type &back() const { return _que.back(); }
+  void push(waiter &w)
+  {
+    critical_section critical;
+    _que.push(w);
+  }
+
+  void notify_one()
+  {
+    critical_section critical;
+    _que.wake_one(nullptr);
+  }
+
+  void notify_all()
+  {
+    critical_section critical;
+    _que.wake_all(nullptr);
+  }
+
+  void notify_one_from_isr(BaseType_t &woken)
+  {
+    isr_critical_section critical;
+    _que.wake_one(&woken);
+  }
+
+  void notify_all_from_isr(BaseType_t &woken)
+  {
+    isr_critical_section critical;
+    _que.wake_all(&woken);
+  }
 
-  void lock() { _sem.lock(); }
-  void unlock() { _sem.unlock(); }
+  // Returns false on timeout, 'w' is not queued any more then.
+  bool wait(waiter &w, TickType_t ticks) { return _que.wait(w, ticks); }
 
 private:
-  queue_type _que;
-  semaphore _sem;
+  internal::wait_queue _que;
 };
 } // namespace free_rtos_std
 
@@ -31,6 +31,15 @@ struct critical_section
   critical_section() { taskENTER_CRITICAL(); }
   ~critical_section() { taskEXIT_CRITICAL(); }
 };
+
+// The same in an interrupt handler.
+struct isr_critical_section
+{
+  isr_critical_section() : _state(taskENTER_CRITICAL_FROM_ISR()) {}
+  ~isr_critical_section() { taskEXIT_CRITICAL_FROM_ISR(_state); }
+
+  UBaseType_t _state;
+};
 } // namespace free_rtos_std
 
 #endif //GTHR_FREERTOS_INTERNAL_CRITICAL_H
@@ -0,0 +1,377 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_CHANNEL_H__
+#define FREERTOS_CHANNEL_H__
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "freertos_stop_token.h"
+#include "freertos_timeout.h"
+
+// Bounded message channels on kernel queues and stream buffers.
+//
+// channel<T, N> is a multi-producer multi-consumer FIFO of N elements of a
+// trivially copyable T, built directly on a FreeRTOS queue. Elements are
+// copied into the queue storage, there is no allocation per message. Larger
+// or non-trivial objects are passed by pointer: channel<std::unique_ptr<U>, N>
+// transfers the ownership, only the pointer goes through the queue.
+//
+// byte_stream<N> is a single-reader single-writer byte pipe on a stream
+// buffer. Reads copy straight into the caller's span.
+//
+// With configSUPPORT_STATIC_ALLOCATION the kernel object and its storage are
+// members of the channel. Otherwise they are allocated once, by the
+// constructor.
+//
+// Each operation has a blocking, a timed (_for, _until), a polling (try_) and
+// an ISR (_from_isr) form. The ISR forms report in 'woken' whether a task of
+// a higher priority has been woken; pass it to portYIELD_FROM_ISR. The
+// blocking and timed receive and read also come with a std::stop_token which
+// ends the wait when a stop is requested (freertos_stop_token.h).
+//
+// Example:
+// ```
+// free_rtos_std::channel<sample, 16> samples;
+//
+// void producer() { samples.send(read_sensor()); }
+// void consumer()
+// {
+//   if (auto s = samples.recv_for(100ms))
+//     process(*s);
+// }
+// ```
+
+namespace free_rtos_std
+{
+  template <typename T, std::size_t N>
+  class channel
+  {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Element is copied with memcpy, pass other types as std::unique_ptr");
+    static_assert(N > 0, "Channel must have room for one element");
+
+  public:
+    channel()
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+      _handle = xQueueCreateStatic(N, sizeof(T), _storage, &_queue);
+#else
+      _handle = xQueueCreate(N, sizeof(T));
+#endif
+      configASSERT(_handle);
+    }
+
+    ~channel() { vQueueDelete(_handle); }
+
+    channel(const channel &) = delete;
+    channel &operator=(const channel &) = delete;
+
+    void send(const T &v) { xQueueSendToBack(_handle, &v, portMAX_DELAY); }
+
+    template <typename Rep, typename Period>
+    bool send_for(const T &v, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return xQueueSendToBack(_handle, &v, block_ticks(rel)) == pdTRUE;
+    }
+
+    template <typename Clock, typename Duration>
+    bool send_until(const T &v, const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return xQueueSendToBack(_handle, &v, block_ticks(abs)) == pdTRUE;
+    }
+
+    bool try_send(const T &v) { return xQueueSendToBack(_handle, &v, 0) == pdTRUE; }
+
+    bool send_from_isr(const T &v, BaseType_t &woken)
+    {
+      return xQueueSendToBackFromISR(_handle, &v, &woken) == pdTRUE;
+    }
+
+    T recv()
+    {
+      T v;
+      xQueueReceive(_handle, &v, portMAX_DELAY);
+      return v;
+    }
+
+    template <typename Rep, typename Period>
+    std::optional<T> recv_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return receive(block_ticks(rel));
+    }
+
+    template <typename Clock, typename Duration>
+    std::optional<T> recv_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return receive(block_ticks(abs));
+    }
+
+    std::optional<T> try_recv() { return receive(0); }
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+    // Empty when a stop is requested first.
+    std::optional<T> recv(const std::stop_token &st) { return receive(portMAX_DELAY, st); }
+
+    template <typename Rep, typename Period>
+    std::optional<T> recv_for(const std::chrono::duration<Rep, Period> &rel, const std::stop_token &st)
+    {
+      return receive(block_ticks(rel), st);
+    }
+#endif
+
+    std::optional<T> recv_from_isr(BaseType_t &woken)
+    {
+      T v;
+      if (xQueueReceiveFromISR(_handle, &v, &woken) != pdTRUE)
+        return std::nullopt;
+      return v;
+    }
+
+    std::size_t size() const { return uxQueueMessagesWaiting(_handle); }
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return N; }
+
+    QueueHandle_t native_handle() const { return _handle; }
+
+  private:
+    std::optional<T> receive(TickType_t ticks)
+    {
+      T v;
+      if (xQueueReceive(_handle, &v, ticks) != pdTRUE)
+        return std::nullopt;
+      return v;
+    }
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+    std::optional<T> receive(TickType_t ticks, const std::stop_token &st)
+    {
+      return stoppable_block(st, ticks, [this](TickType_t t) { return receive(t); });
+    }
+#endif
+
+    QueueHandle_t _handle;
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StaticQueue_t _queue;
+    alignas(T) std::uint8_t _storage[N * sizeof(T)];
+#endif
+  };
+
+  // Ownership transfer. The pointer goes through the queue, the object stays
+  // where it is. Objects left in the channel are deleted with it.
+  template <typename U, std::size_t N>
+  class channel<std::unique_ptr<U>, N>
+  {
+  public:
+    using pointer = std::unique_ptr<U>;
+
+    channel() = default;
+
+    ~channel()
+    {
+      while (auto p = _raw.try_recv())
+        delete *p;
+    }
+
+    // The send functions take the object only on success. On failure the
+    // caller still owns it.
+    void send(pointer &&p) { _raw.send(p.release()); }
+
+    template <typename Rep, typename Period>
+    bool send_for(pointer &&p, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return released(p, _raw.send_for(p.get(), rel));
+    }
+
+    template <typename Clock, typename Duration>
+    bool send_until(pointer &&p, const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return released(p, _raw.send_until(p.get(), abs));
+    }
+
+    bool try_send(pointer &&p) { return released(p, _raw.try_send(p.get())); }
+
+    bool send_from_isr(pointer &&p, BaseType_t &woken)
+    {
+      return released(p, _raw.send_from_isr(p.get(), woken));
+    }
+
+    // The receive functions return an empty pointer on timeout.
+    pointer recv() { return pointer{_raw.recv()}; }
+
+    template <typename Rep, typename Period>
+    pointer recv_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return pointer{_raw.recv_for(rel).value_or(nullptr)};
+    }
+
+    template <typename Clock, typename Duration>
+    pointer recv_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return pointer{_raw.recv_until(abs).value_or(nullptr)};
+    }
+
+    pointer try_recv() { return pointer{_raw.try_recv().value_or(nullptr)}; }
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+    pointer recv(const std::stop_token &st) { return pointer{_raw.recv(st).value_or(nullptr)}; }
+
+    template <typename Rep, typename Period>
+    pointer recv_for(const std::chrono::duration<Rep, Period> &rel, const std::stop_token &st)
+    {
+      return pointer{_raw.recv_for(rel, st).value_or(nullptr)};
+    }
+#endif
+
+    pointer recv_from_isr(BaseType_t &woken) { return pointer{_raw.recv_from_isr(woken).value_or(nullptr)}; }
+
+    std::size_t size() const { return _raw.size(); }
+    bool empty() const { return _raw.empty(); }
+    static constexpr std::size_t capacity() { return N; }
+
+    QueueHandle_t native_handle() const { return _raw.native_handle(); }
+
+  private:
+    static bool released(pointer &p, bool sent)
+    {
+      if (sent)
+        (void)p.release();
+      return sent;
+    }
+
+    channel<U *, N> _raw;
+  };
+
+  // Byte pipe on a stream buffer. One writer and one reader at a time, as
+  // required by the kernel. A read returns as soon as 'trigger' bytes are
+  // available (at least one byte).
+  template <std::size_t N>
+  class byte_stream
+  {
+  public:
+    explicit byte_stream(std::size_t trigger = 1)
+    {
+      // The kernel keeps one byte free to tell full from empty. The dynamic
+      // version adds it by itself.
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+      _handle = xStreamBufferCreateStatic(sizeof(_storage), trigger, _storage, &_stream);
+#else
+      _handle = xStreamBufferCreate(N, trigger);
+#endif
+      configASSERT(_handle);
+    }
+
+    ~byte_stream() { vStreamBufferDelete(_handle); }
+
+    byte_stream(const byte_stream &) = delete;
+    byte_stream &operator=(const byte_stream &) = delete;
+
+    // Write functions return the number of bytes written. Blocking write
+    // returns when all of them are in.
+    std::size_t write(std::span<const std::byte> data)
+    {
+      return xStreamBufferSend(_handle, data.data(), data.size(), portMAX_DELAY);
+    }
+
+    template <typename Rep, typename Period>
+    std::size_t write_for(std::span<const std::byte> data, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return xStreamBufferSend(_handle, data.data(), data.size(), block_ticks(rel));
+    }
+
+    std::size_t try_write(std::span<const std::byte> data)
+    {
+      return xStreamBufferSend(_handle, data.data(), data.size(), 0);
+    }
+
+    std::size_t write_from_isr(std::span<const std::byte> data, BaseType_t &woken)
+    {
+      return xStreamBufferSendFromISR(_handle, data.data(), data.size(), &woken);
+    }
+
+    // Read functions fill the front of 'buf' and return that part of it.
+    std::span<std::byte> read(std::span<std::byte> buf)
+    {
+      return buf.first(xStreamBufferReceive(_handle, buf.data(), buf.size(), portMAX_DELAY));
+    }
+
+    template <typename Rep, typename Period>
+    std::span<std::byte> read_for(std::span<std::byte> buf, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return buf.first(xStreamBufferReceive(_handle, buf.data(), buf.size(), block_ticks(rel)));
+    }
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+    std::span<std::byte> read(std::span<std::byte> buf, const std::stop_token &st)
+    {
+      return read(buf, portMAX_DELAY, st);
+    }
+
+    template <typename Rep, typename Period>
+    std::span<std::byte> read_for(std::span<std::byte> buf, const std::chrono::duration<Rep, Period> &rel,
+                                  const std::stop_token &st)
+    {
+      return read(buf, block_ticks(rel), st);
+    }
+#endif
+
+    std::span<std::byte> try_read(std::span<std::byte> buf)
+    {
+      return buf.first(xStreamBufferReceive(_handle, buf.data(), buf.size(), 0));
+    }
+
+    std::span<std::byte> read_from_isr(std::span<std::byte> buf, BaseType_t &woken)
+    {
+      return buf.first(xStreamBufferReceiveFromISR(_handle, buf.data(), buf.size(), &woken));
+    }
+
+    std::size_t size() const { return xStreamBufferBytesAvailable(_handle); }
+    static constexpr std::size_t capacity() { return N; }
+
+    StreamBufferHandle_t native_handle() const { return _handle; }
+
+  private:
+#if (INCLUDE_xTaskAbortDelay == 1)
+    std::span<std::byte> read(std::span<std::byte> buf, TickType_t ticks, const std::stop_token &st)
+    {
+      return buf.first(stoppable_block(st, ticks, [&](TickType_t t) {
+        return xStreamBufferReceive(_handle, buf.data(), buf.size(), t);
+      }));
+    }
+#endif
+
+    StreamBufferHandle_t _handle;
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StaticStreamBuffer_t _stream;
+    std::uint8_t _storage[N + 1];
+#endif
+  };
+}
+
+#endif // FREERTOS_CHANNEL_H__
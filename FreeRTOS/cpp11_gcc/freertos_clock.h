@@ -0,0 +1,133 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_CLOCK_H__
+#define FREERTOS_CLOCK_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstdint>
+
+// Time base of std::chrono::steady_clock, system_clock and the
+// diagnostics (thread statistics, trace, lock profiler).
+//
+// A port provides a free running, monotonic 64 bit hardware counter in
+// FreeRTOSConfig.h:
+// ```
+// unsigned long long ullGlobalTimerCount( void );
+// #define configSTD_CLOCK_COUNTER()  ullGlobalTimerCount()
+// #define configSTD_CLOCK_COUNTER_HZ 100000000ULL
+// ```
+// The counter must be readable from any context without locks. Without it,
+// the tick count extended to 64 bits is used (tick_count64) and the clocks
+// resolve to one tick.
+//
+// Note: this header is included by gthr-default.h, keep it light.
+
+#ifdef configSTD_CLOCK_COUNTER
+#ifndef configSTD_CLOCK_COUNTER_HZ
+#error "configSTD_CLOCK_COUNTER_HZ must be defined together with configSTD_CLOCK_COUNTER"
+#endif
+#endif
+
+namespace free_rtos_std
+{
+  // Tick count extended with the number of its overflows, so it does not
+  // wrap after 2^32 ticks (~49.7 days at 1 kHz). Lock free.
+  inline std::uint64_t tick_count64()
+  {
+    // Kernel increments the overflow counter in the tick interrupt, after
+    // the tick count has wrapped to 0. If the overflow counter is the same
+    // before and after reading the tick count, the pair is consistent.
+    TimeOut_t first, second;
+    do
+    {
+      vTaskInternalSetTimeOutState(&first);
+      vTaskInternalSetTimeOutState(&second);
+    } while (first.xOverflowCount != second.xOverflowCount);
+
+    // A 64-bit tick count (e.g. the posix port) does not wrap in practice.
+    if constexpr (sizeof(TickType_t) >= sizeof(std::uint64_t))
+      return first.xTimeOnEntering;
+    else
+    {
+      constexpr unsigned TICK_BITS{sizeof(TickType_t) * 8};
+      return (static_cast<std::uint64_t>(static_cast<UBaseType_t>(first.xOverflowCount)) << TICK_BITS) |
+             first.xTimeOnEntering;
+    }
+  }
+
+  // Number of ticks covering 'ns', rounded up. Zero for negative values.
+  inline std::uint64_t ns_to_ticks(std::int64_t ns)
+  {
+    if (ns <= 0)
+      return 0;
+    constexpr std::int64_t NS{1'000'000'000LL};
+    constexpr std::int64_t HZ{configTICK_RATE_HZ};
+    return static_cast<std::uint64_t>((ns / NS) * HZ + ((ns % NS) * HZ + NS - 1) / NS);
+  }
+
+  // Block time for a kernel call waiting 'ns', zero (poll) if it has
+  // expired. A block of n ticks ends at the n-th tick interrupt from now,
+  // which can be little more than n-1 ticks away, so one tick is added for
+  // the part of the current tick that has passed. Values which do not fit are
+  // limited to the longest finite block time, portMAX_DELAY means forever.
+  inline TickType_t timeout_ticks(std::int64_t ns)
+  {
+    auto ticks = ns_to_ticks(ns);
+    if (ticks == 0)
+      return 0;
+    return ticks + 1 >= portMAX_DELAY ? portMAX_DELAY - 1 : static_cast<TickType_t>(ticks + 1);
+  }
+
+#ifdef configSTD_CLOCK_COUNTER
+  constexpr std::uint64_t CLOCK_COUNTER_HZ{configSTD_CLOCK_COUNTER_HZ};
+#else
+  constexpr std::uint64_t CLOCK_COUNTER_HZ{configTICK_RATE_HZ};
+#endif
+
+  inline std::uint64_t clock_counter()
+  {
+#ifdef configSTD_CLOCK_COUNTER
+    return static_cast<std::uint64_t>(configSTD_CLOCK_COUNTER());
+#else
+    return tick_count64();
+#endif
+  }
+
+  inline std::uint64_t clock_counter_to_ns(std::uint64_t count)
+  {
+    constexpr std::uint64_t NS{1'000'000'000ULL};
+    if constexpr (NS % CLOCK_COUNTER_HZ == 0)
+      return count * (NS / CLOCK_COUNTER_HZ); // no division at run time
+    else // split to avoid overflow of count * NS
+      return (count / CLOCK_COUNTER_HZ) * NS + ((count % CLOCK_COUNTER_HZ) * NS) / CLOCK_COUNTER_HZ;
+  }
+
+  // Number of counts covering 'ns', rounded up.
+  constexpr std::uint64_t ns_to_clock_counter(std::uint64_t ns)
+  {
+    constexpr std::uint64_t NS{1'000'000'000ULL};
+    return (ns / NS) * CLOCK_COUNTER_HZ + ((ns % NS) * CLOCK_COUNTER_HZ + NS - 1) / NS;
+  }
+}
+
+#endif // FREERTOS_CLOCK_H__
@@ -0,0 +1,56 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_condition_variable_any.h"
+
+#include "critical_section.h"
+
+namespace free_rtos_std
+{
+  void condition_variable_any::notify_one() noexcept
+  {
+    critical_section critical;
+    _waiters.wake_one(nullptr);
+  }
+
+  void condition_variable_any::notify_all() noexcept
+  {
+    critical_section critical;
+    _waiters.wake_all(nullptr);
+  }
+
+  void condition_variable_any::notify_one_from_isr(BaseType_t &woken) noexcept
+  {
+    isr_critical_section critical;
+    _waiters.wake_one(&woken);
+  }
+
+  void condition_variable_any::notify_all_from_isr(BaseType_t &woken) noexcept
+  {
+    isr_critical_section critical;
+    _waiters.wake_all(&woken);
+  }
+
+  void condition_variable_any::push(internal::wait_queue::waiter &w)
+  {
+    critical_section critical;
+    _waiters.push(w);
+  }
+}
@@ -0,0 +1,220 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_CONDITION_VARIABLE_ANY_H__
+#define FREERTOS_CONDITION_VARIABLE_ANY_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <stop_token>
+
+#include "freertos_stop_token.h"
+#include "freertos_timeout.h"
+#include "freertos_wait_queue.h"
+
+// Condition variable for any BasicLockable.
+//
+// std::condition_variable_any of libstdc++ is a std::condition_variable plus
+// a std::mutex held in a std::shared_ptr: a heap allocation per object and two
+// more mutex operations per wait. free_rtos_std::condition_variable_any has
+// the same interface and queues the waiting tasks directly. A waiter is a
+// node on the stack of the waiting task, linked in a critical section, and is
+// woken with a direct task notification. Nothing is allocated.
+//
+// The lock is any type with lock() and unlock(): std::unique_lock,
+// std::shared_lock, a spinlock. Waiters are woken in FIFO order.
+//
+// notify_one_from_isr and notify_all_from_isr wake the waiters from an
+// interrupt handler. They report in 'woken' whether a task of a higher
+// priority has been woken, pass it to portYIELD_FROM_ISR, or call the free
+// functions of the same name which do it.
+//
+// The wait functions taking a std::stop_token return when a stop is
+// requested, with the result of the predicate. The stop aborts the blocked
+// task, see freertos_stop_token.h, and requires INCLUDE_xTaskAbortDelay.
+//
+// Example:
+// ```
+// free_rtos_std::condition_variable_any cv;
+// std::shared_lock lock{config_mutex};
+// cv.wait(lock, st, [&] { return config.version != seen; });
+// ```
+
+namespace free_rtos_std
+{
+  class condition_variable_any
+  {
+  public:
+    condition_variable_any() = default;
+    ~condition_variable_any() = default;
+
+    condition_variable_any(const condition_variable_any &) = delete;
+    condition_variable_any &operator=(const condition_variable_any &) = delete;
+
+    void notify_one() noexcept;
+    void notify_all() noexcept;
+
+    void notify_one_from_isr(BaseType_t &woken) noexcept;
+    void notify_all_from_isr(BaseType_t &woken) noexcept;
+
+    template <typename Lock>
+    void wait(Lock &lock)
+    {
+      (void)wait_ticks(lock, portMAX_DELAY, nullptr);
+    }
+
+    template <typename Lock, typename Pred>
+    void wait(Lock &lock, Pred pred)
+    {
+      while (!pred())
+        wait(lock);
+    }
+
+    template <typename Lock, typename Rep, typename Period>
+    std::cv_status wait_for(Lock &lock, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return wait_ticks(lock, block_ticks(rel), nullptr) ? std::cv_status::no_timeout
+                                                         : std::cv_status::timeout;
+    }
+
+    template <typename Lock, typename Rep, typename Period, typename Pred>
+    bool wait_for(Lock &lock, const std::chrono::duration<Rep, Period> &rel, Pred pred)
+    {
+      return wait_until(lock, std::chrono::steady_clock::now() + rel, std::move(pred));
+    }
+
+    template <typename Lock, typename Clock, typename Duration>
+    std::cv_status wait_until(Lock &lock, const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return wait_ticks(lock, block_ticks(abs), nullptr) ? std::cv_status::no_timeout
+                                                         : std::cv_status::timeout;
+    }
+
+    template <typename Lock, typename Clock, typename Duration, typename Pred>
+    bool wait_until(Lock &lock, const std::chrono::time_point<Clock, Duration> &abs, Pred pred)
+    {
+      while (!pred())
+        if (wait_until(lock, abs) == std::cv_status::timeout)
+          return pred();
+      return true;
+    }
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+    template <typename Lock, typename Pred>
+    bool wait(Lock &lock, std::stop_token st, Pred pred)
+    {
+      while (!st.stop_requested())
+      {
+        if (pred())
+          return true;
+        (void)wait_ticks(lock, portMAX_DELAY, &st);
+      }
+      return pred();
+    }
+
+    template <typename Lock, typename Rep, typename Period, typename Pred>
+    bool wait_for(Lock &lock, std::stop_token st, const std::chrono::duration<Rep, Period> &rel, Pred pred)
+    {
+      return wait_until(lock, std::move(st), std::chrono::steady_clock::now() + rel, std::move(pred));
+    }
+
+    template <typename Lock, typename Clock, typename Duration, typename Pred>
+    bool wait_until(Lock &lock, std::stop_token st, const std::chrono::time_point<Clock, Duration> &abs,
+                    Pred pred)
+    {
+      while (!st.stop_requested())
+      {
+        if (pred())
+          return true;
+        if (!wait_ticks(lock, block_ticks(abs), &st))
+          break; // timeout or stop
+      }
+      return pred();
+    }
+#endif
+
+  private:
+    // Returns false on timeout, or when a stop is requested through 'st'.
+    template <typename Lock>
+    bool wait_ticks(Lock &lock, TickType_t ticks, const std::stop_token *st)
+    {
+      internal::wait_queue::waiter w;
+      push(w);
+      lock.unlock();
+      const bool notified = _waiters.wait(w, ticks, st);
+      lock.lock();
+      return notified;
+    }
+
+    void push(internal::wait_queue::waiter &w);
+
+    internal::wait_queue _waiters;
+  };
+
+  // In an interrupt handler, wakes a waiter and yields to it if it has a
+  // higher priority than the interrupted task.
+  inline void notify_one_from_isr(condition_variable_any &cv)
+  {
+    BaseType_t woken{pdFALSE};
+    cv.notify_one_from_isr(woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  inline void notify_all_from_isr(condition_variable_any &cv)
+  {
+    BaseType_t woken{pdFALSE};
+    cv.notify_all_from_isr(woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  // std::condition_variable queues its waiters the same way (see
+  // condition_variable.h) and can be notified from an ISR as well. The ISR
+  // cannot take the std::mutex: a notification between the check of the
+  // condition and the wait is lost, so notify a condition that the ISR sets
+  // again, or use condition_variable_any with a critical section lock.
+  inline void notify_one_from_isr(std::condition_variable &cv, BaseType_t &woken) noexcept
+  {
+    cv.native_handle()->notify_one_from_isr(woken);
+  }
+
+  inline void notify_all_from_isr(std::condition_variable &cv, BaseType_t &woken) noexcept
+  {
+    cv.native_handle()->notify_all_from_isr(woken);
+  }
+
+  inline void notify_one_from_isr(std::condition_variable &cv)
+  {
+    BaseType_t woken{pdFALSE};
+    notify_one_from_isr(cv, woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  inline void notify_all_from_isr(std::condition_variable &cv)
+  {
+    BaseType_t woken{pdFALSE};
+    notify_all_from_isr(cv, woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+#endif // FREERTOS_CONDITION_VARIABLE_ANY_H__
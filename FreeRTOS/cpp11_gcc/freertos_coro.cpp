@@ -0,0 +1,282 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_coro.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "thread_with_attributes.h"
+
+#include <new>
+
+namespace free_rtos_std::coro
+{
+  namespace
+  {
+    union frame_block
+    {
+      frame_block *next;
+      alignas(std::max_align_t) unsigned char bytes[configSTD_CORO_FRAME_SIZE];
+    };
+
+    frame_block s_frames[configSTD_CORO_FRAME_COUNT];
+    frame_block *s_free;   // released blocks
+    std::size_t s_unused;  // index of the first block never used
+    frame_pool_stats s_stats;
+
+    std::uint64_t deadline(const resumable *r)
+    {
+      return static_cast<const internal::timed_resumable *>(r)->deadline;
+    }
+
+    bool from_pool(const void *p)
+    {
+      return p >= &s_frames[0] && p < &s_frames[configSTD_CORO_FRAME_COUNT];
+    }
+  }
+
+  namespace internal
+  {
+    void *frame_allocate(std::size_t size)
+    {
+      {
+        critical_section critical;
+        frame_block *b = nullptr;
+        if (size <= sizeof(frame_block))
+        {
+          if (s_free)
+          {
+            b = s_free;
+            s_free = b->next;
+          }
+          else if (s_unused < configSTD_CORO_FRAME_COUNT)
+            b = &s_frames[s_unused++];
+        }
+
+        if (b)
+        {
+          if (++s_stats.in_use > s_stats.peak)
+            s_stats.peak = s_stats.in_use;
+          return b;
+        }
+        s_stats.heap++;
+      }
+      return ::operator new(size);
+    }
+
+    void frame_free(void *p)
+    {
+      if (!from_pool(p))
+      {
+        ::operator delete(p);
+        return;
+      }
+
+      critical_section critical;
+      auto b = static_cast<frame_block *>(p);
+      b->next = s_free;
+      s_free = b;
+      s_stats.in_use--;
+    }
+  }
+
+  frame_pool_stats frame_pool_statistics()
+  {
+    critical_section critical;
+    return s_stats;
+  }
+
+  executor::executor(std::size_t workers, const attributes &attr)
+      : _workers{std::make_unique<worker[]>(workers)}, _count{workers}
+  {
+    configASSERT(workers > 0 && workers <= 32);
+    for (std::size_t i = 0; i < workers; i++)
+      _workers[i].thread = std_thread(attr, [this, i] { run(i); });
+  }
+
+  executor::~executor()
+  {
+    join();
+
+    std::uint32_t parked;
+    {
+      critical_section critical;
+      _stop = true;
+      parked = _parked;
+      _parked = 0;
+    }
+    for (std::size_t i = 0; i < _count; i++)
+      if (parked & (1U << i))
+        xTaskNotifyGive(_workers[i].handle);
+
+    for (std::size_t i = 0; i < _count; i++)
+      _workers[i].thread.join();
+  }
+
+  void executor::spawn(task<> &&t)
+  {
+    auto h = t.release();
+    auto &p = h.promise();
+    p._self.handle = h;
+    p._self.exec = this;
+    p._detached = true;
+    {
+      critical_section critical;
+      _active++;
+    }
+    post(&p._self);
+  }
+
+  void executor::join()
+  {
+    for (;;)
+    {
+      {
+        critical_section critical;
+        if (_active == 0)
+          return;
+        _joiner = xTaskGetCurrentTaskHandle();
+      }
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+  }
+
+  std::size_t executor::active() const
+  {
+    critical_section critical;
+    return _active;
+  }
+
+  void executor::task_done()
+  {
+    TaskHandle_t joiner{};
+    {
+      critical_section critical;
+      if (--_active == 0)
+        joiner = std::exchange(_joiner, nullptr);
+    }
+    if (joiner)
+      xTaskNotifyGive(joiner);
+  }
+
+  // Called in a critical section. Clearing the bit here makes sure two
+  // posts do not wake the same worker.
+  TaskHandle_t executor::take_parked()
+  {
+    if (!_parked)
+      return nullptr;
+    unsigned i = __builtin_ctz(_parked);
+    _parked &= ~(1U << i);
+    return _workers[i].handle;
+  }
+
+  void executor::post(resumable *r)
+  {
+    TaskHandle_t worker;
+    {
+      critical_section critical;
+      _ready.push_back(r);
+      worker = take_parked();
+    }
+    if (worker)
+      xTaskNotifyGive(worker);
+  }
+
+  void executor::post_from_isr(resumable *r, BaseType_t &woken)
+  {
+    TaskHandle_t worker;
+    {
+      internal::isr_critical_section critical;
+      _ready.push_back(r);
+      worker = take_parked();
+    }
+    if (worker)
+      vTaskNotifyGiveFromISR(worker, &woken);
+  }
+
+  void executor::post_at(internal::timed_resumable *r)
+  {
+    TaskHandle_t worker{};
+    {
+      critical_section critical;
+      resumable **pp = &_sleepers;
+      while (*pp && deadline(*pp) <= r->deadline)
+        pp = &(*pp)->next;
+      r->next = *pp;
+      *pp = r;
+
+      // A parked worker has to shorten its timeout.
+      if (_sleepers == r)
+        worker = take_parked();
+    }
+    if (worker)
+      xTaskNotifyGive(worker);
+  }
+
+  // Called in a critical section.
+  void executor::wake_sleepers(std::uint64_t now)
+  {
+    while (_sleepers && deadline(_sleepers) <= now)
+    {
+      auto r = _sleepers;
+      _sleepers = r->next;
+      _ready.push_back(r);
+    }
+  }
+
+  void executor::run(std::size_t index)
+  {
+    _workers[index].handle = xTaskGetCurrentTaskHandle();
+
+    for (;;)
+    {
+      resumable *r;
+      TickType_t wait{portMAX_DELAY};
+      {
+        critical_section critical;
+        auto now = tick_count64();
+        wake_sleepers(now);
+        r = _ready.pop_front();
+        if (!r)
+        {
+          if (_stop)
+            return;
+          if (_sleepers)
+          {
+            auto ticks = deadline(_sleepers) - now;
+            wait = ticks < portMAX_DELAY ? static_cast<TickType_t>(ticks) : portMAX_DELAY - 1;
+          }
+          _parked |= 1U << index;
+        }
+      }
+
+      if (r)
+        r->handle.resume();
+      else
+      {
+        ulTaskNotifyTake(pdTRUE, wait);
+        critical_section critical;
+        _parked &= ~(1U << index);
+      }
+    }
+  }
+}
+
+#endif // __cpp_impl_coroutine
@@ -0,0 +1,863 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_CORO_H__
+#define FREERTOS_CORO_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+// C++20 coroutines run by FreeRTOS tasks.
+//
+// coro::executor runs coroutines on one or more worker tasks. A coroutine
+// that waits does not block its worker: it is suspended and parked in the
+// object it waits for, and queued to its executor again when that object is
+// ready. Hundreds of coroutines can share the stacks of a few workers; each
+// needs only its frame.
+//
+// coro::task<T> is the coroutine type. It starts when it is awaited, or when
+// it is handed to executor::spawn. Awaiting a task runs it on the same
+// worker, and the result is the value of its co_return.
+//
+// Awaitables:
+//   coro::sleep_for / sleep_until - timers of the executor, one tick resolution
+//   coro::yield                    - to the other ready coroutines
+//   coro::mutex::lock              - FIFO handoff to the next waiter
+//   coro::semaphore::acquire       - counting semaphore, released from a
+//                                    thread or an ISR
+//   coro::queue<T, N>::receive     - FreeRTOS queue, filled by threads or ISRs
+//   coro::event::wait              - auto-reset event, set by threads or ISRs
+//
+// Frames are taken from a pool of configSTD_CORO_FRAME_COUNT blocks of
+// configSTD_CORO_FRAME_SIZE bytes. A frame which does not fit, or does not
+// find a free block, comes from the heap. frame_pool_statistics() tells how
+// well the pool is sized.
+//
+// Coroutines need -fcoroutines with gcc 10. Without compiler support this
+// header declares nothing.
+//
+// Example:
+// ```
+// coro::task<> blink(coro::event *button)
+// {
+//   for (;;)
+//   {
+//     co_await button->wait();
+//     led_on();
+//     co_await coro::sleep_for(100ms);
+//     led_off();
+//   }
+// }
+//
+// coro::executor ex{2};
+// ex.spawn(blink(&button));
+// ```
+
+#if defined(__cpp_impl_coroutine)
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "critical_section.h"
+#include "freertos_clock.h"
+#include "freertos_thread_attributes.h"
+
+#ifndef configSTD_CORO_FRAME_SIZE
+#define configSTD_CORO_FRAME_SIZE 256U
+#endif
+
+#ifndef configSTD_CORO_FRAME_COUNT
+#define configSTD_CORO_FRAME_COUNT 32U
+#endif
+
+namespace free_rtos_std::coro
+{
+  class executor;
+
+  template <typename T>
+  class task;
+
+  // A suspended coroutine and the executor which resumes it. Awaitables keep
+  // it in the coroutine frame while the coroutine waits.
+  struct resumable
+  {
+    std::coroutine_handle<> handle;
+    executor *exec{};
+    resumable *next{};
+  };
+
+  struct frame_pool_stats
+  {
+    std::size_t in_use; // blocks of the pool
+    std::size_t peak;   // the most blocks in use at the same time
+    std::size_t heap;   // frames allocated from the heap so far
+  };
+
+  frame_pool_stats frame_pool_statistics();
+
+  namespace internal
+  {
+    void *frame_allocate(std::size_t size);
+    void frame_free(void *p);
+
+    // FIFO of resumables. Not synchronised, the owner locks it.
+    struct resumable_list
+    {
+      resumable *head{};
+      resumable *tail{};
+
+      bool empty() const { return !head; }
+
+      void push_back(resumable *r)
+      {
+        r->next = nullptr;
+        if (tail)
+          tail->next = r;
+        else
+          head = r;
+        tail = r;
+      }
+
+      void push_front(resumable *r)
+      {
+        r->next = head;
+        head = r;
+        if (!tail)
+          tail = r;
+      }
+
+      resumable *pop_front()
+      {
+        resumable *r = head;
+        if (r)
+        {
+          head = r->next;
+          if (!head)
+            tail = nullptr;
+        }
+        return r;
+      }
+    };
+
+    struct timed_resumable : resumable
+    {
+      std::uint64_t deadline; // tick
+    };
+
+    // Interrupt safe lock of the structures shared with ISRs.
+    using isr_critical_section = free_rtos_std::isr_critical_section;
+
+    class promise_base
+    {
+    public:
+      static void *operator new(std::size_t size) { return frame_allocate(size); }
+      static void operator delete(void *p) { frame_free(p); }
+
+      std::suspend_always initial_suspend() noexcept { return {}; }
+
+      struct final_awaiter
+      {
+        bool await_ready() noexcept { return false; }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+          return h.promise().finish(h);
+        }
+
+        void await_resume() noexcept {}
+      };
+
+      final_awaiter final_suspend() noexcept { return {}; }
+      void unhandled_exception() { std::terminate(); }
+
+      executor *exec() const { return _self.exec; }
+
+    private:
+      template <typename>
+      friend class free_rtos_std::coro::task;
+      friend class free_rtos_std::coro::executor;
+
+      // Continues the awaiting coroutine, or destroys a spawned one.
+      std::coroutine_handle<> finish(std::coroutine_handle<> h) noexcept;
+
+      resumable _self;
+      std::coroutine_handle<> _continuation;
+      bool _detached{false};
+    };
+
+    template <typename T>
+    class promise : public promise_base
+    {
+    public:
+      task<T> get_return_object();
+
+      template <typename U>
+      void return_value(U &&v) { _result.emplace(std::forward<U>(v)); }
+
+      T take() { return std::move(*_result); }
+
+    private:
+      std::optional<T> _result;
+    };
+
+    template <>
+    class promise<void> : public promise_base
+    {
+    public:
+      task<void> get_return_object();
+      void return_void() {}
+      void take() {}
+    };
+  }
+
+  template <typename T = void>
+  class [[nodiscard]] task
+  {
+  public:
+    using promise_type = internal::promise<T>;
+
+    task(task &&other) : _h{std::exchange(other._h, {})} {}
+    task &operator=(task &&other)
+    {
+      if (this != &other)
+      {
+        if (_h)
+          _h.destroy();
+        _h = std::exchange(other._h, {});
+      }
+      return *this;
+    }
+
+    ~task()
+    {
+      if (_h)
+        _h.destroy();
+    }
+
+    // Awaiting a task runs it to completion on the worker of the caller.
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<P> caller) noexcept
+    {
+      _h.promise()._self.exec = caller.promise().exec();
+      _h.promise()._continuation = caller;
+      return _h;
+    }
+
+    T await_resume() { return _h.promise().take(); }
+
+  private:
+    friend class internal::promise<T>;
+    friend class executor;
+
+    explicit task(std::coroutine_handle<promise_type> h) : _h{h} {}
+
+    std::coroutine_handle<promise_type> release() { return std::exchange(_h, {}); }
+
+    std::coroutine_handle<promise_type> _h;
+  };
+
+  template <typename T>
+  task<T> internal::promise<T>::get_return_object()
+  {
+    return task<T>{std::coroutine_handle<promise<T>>::from_promise(*this)};
+  }
+
+  inline task<void> internal::promise<void>::get_return_object()
+  {
+    return task<void>{std::coroutine_handle<promise<void>>::from_promise(*this)};
+  }
+
+  class executor
+  {
+  public:
+    // @param workers - number of tasks running coroutines, at most 32
+    // @param attr    - attributes of the worker tasks
+    explicit executor(std::size_t workers = 1, const attributes &attr = attr_name("coro"));
+
+    // Waits for the spawned coroutines (see join) and stops the workers.
+    ~executor();
+
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+
+    // Starts 't' on one of the workers. The executor owns it from now on and
+    // destroys its frame when it returns.
+    void spawn(task<> &&t);
+
+    // Blocks the calling thread until all spawned coroutines have returned.
+    // Only one thread may wait at a time.
+    void join();
+
+    // Number of spawned coroutines which have not returned yet.
+    std::size_t active() const;
+
+    // Queues a suspended coroutine to be resumed by a worker.
+    void post(resumable *r);
+    void post_from_isr(resumable *r, BaseType_t &woken);
+
+    // Queues 'r' when the tick count reaches r->deadline.
+    void post_at(internal::timed_resumable *r);
+
+  private:
+    friend class internal::promise_base;
+
+    struct worker
+    {
+      std::thread thread;
+      TaskHandle_t handle{};
+    };
+
+    void run(std::size_t index);
+    void task_done();
+    TaskHandle_t take_parked();
+    void wake_sleepers(std::uint64_t now);
+
+    std::unique_ptr<worker[]> _workers;
+    std::size_t _count;
+
+    internal::resumable_list _ready;
+    resumable *_sleepers{};                 // timed_resumable, sorted by deadline
+    std::uint32_t _parked{};                // bit of each worker waiting for work
+    std::size_t _active{};
+    TaskHandle_t _joiner{};
+    bool _stop{false};
+  };
+
+  inline std::coroutine_handle<> internal::promise_base::finish(std::coroutine_handle<> h) noexcept
+  {
+    if (_continuation)
+      return _continuation;
+
+    if (_detached)
+    {
+      executor *exec = _self.exec;
+      h.destroy();
+      exec->task_done();
+    }
+    return std::noop_coroutine();
+  }
+
+  class sleep_awaiter
+  {
+  public:
+    explicit sleep_awaiter(std::uint64_t ticks) : _ticks{ticks} {}
+
+    bool await_ready() const noexcept { return _ticks == 0; }
+
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> h)
+    {
+      _node.handle = h;
+      _node.exec = h.promise().exec();
+      _node.deadline = tick_count64() + _ticks;
+      _node.exec->post_at(&_node);
+    }
+
+    void await_resume() const noexcept {}
+
+  private:
+    std::uint64_t _ticks;
+    internal::timed_resumable _node;
+  };
+
+  // Resolution is one tick. The current tick has partly passed, one more
+  // makes sure the sleep is not shorter than requested.
+  template <typename Rep, typename Period>
+  sleep_awaiter sleep_for(const std::chrono::duration<Rep, Period> &rel)
+  {
+    auto ticks = ns_to_ticks(std::chrono::duration_cast<std::chrono::nanoseconds>(rel).count());
+    return sleep_awaiter{ticks ? ticks + 1 : 0};
+  }
+
+  template <typename Clock, typename Duration>
+  sleep_awaiter sleep_until(const std::chrono::time_point<Clock, Duration> &abs)
+  {
+    return sleep_for(abs - Clock::now());
+  }
+
+  class yield_awaiter
+  {
+  public:
+    bool await_ready() const noexcept { return false; }
+
+    template <typename P>
+    void await_suspend(std::coroutine_handle<P> h)
+    {
+      _node.handle = h;
+      _node.exec = h.promise().exec();
+      _node.exec->post(&_node);
+    }
+
+    void await_resume() const noexcept {}
+
+  private:
+    resumable _node;
+  };
+
+  // Lets the other ready coroutines of the executor run first.
+  inline yield_awaiter yield() { return {}; }
+
+  // Mutex for coroutines. The owner does not block its worker while other
+  // coroutines wait, and unlock hands the mutex to the first waiter. There is
+  // no owner tracking, so no priority inheritance and no recursion.
+  //
+  // ```
+  // co_await m.lock();
+  // std::lock_guard<coro::mutex> guard{m, std::adopt_lock};
+  // ```
+  class mutex
+  {
+  public:
+    class lock_awaiter
+    {
+    public:
+      explicit lock_awaiter(mutex &m) : _m{m} {}
+
+      bool await_ready() { return _m.try_lock(); }
+
+      template <typename P>
+      bool await_suspend(std::coroutine_handle<P> h)
+      {
+        _node.handle = h;
+        _node.exec = h.promise().exec();
+
+        critical_section critical;
+        if (!_m._locked)
+        {
+          _m._locked = true;
+          return false;
+        }
+        _m._waiters.push_back(&_node);
+        return true;
+      }
+
+      void await_resume() const noexcept {}
+
+    private:
+      mutex &_m;
+      resumable _node;
+    };
+
+    mutex() = default;
+    mutex(const mutex &) = delete;
+    mutex &operator=(const mutex &) = delete;
+
+    lock_awaiter lock() { return lock_awaiter{*this}; }
+
+    bool try_lock()
+    {
+      critical_section critical;
+      if (_locked)
+        return false;
+      _locked = true;
+      return true;
+    }
+
+    void unlock()
+    {
+      resumable *next;
+      {
+        critical_section critical;
+        next = _waiters.pop_front();
+        if (!next)
+          _locked = false;
+      }
+      if (next)
+        next->exec->post(next);
+    }
+
+  private:
+    internal::resumable_list _waiters;
+    bool _locked{false};
+  };
+
+  // Counting semaphore for coroutines. Threads and ISRs may release it.
+  class semaphore
+  {
+  public:
+    class acquire_awaiter
+    {
+    public:
+      explicit acquire_awaiter(semaphore &s) : _s{s} {}
+
+      bool await_ready() { return _s.try_acquire(); }
+
+      template <typename P>
+      bool await_suspend(std::coroutine_handle<P> h)
+      {
+        _node.handle = h;
+        _node.exec = h.promise().exec();
+
+        critical_section critical;
+        if (_s._count > 0)
+        {
+          _s._count--;
+          return false;
+        }
+        _s._waiters.push_back(&_node);
+        return true;
+      }
+
+      void await_resume() const noexcept {}
+
+    private:
+      semaphore &_s;
+      resumable _node;
+    };
+
+    explicit semaphore(std::ptrdiff_t initial = 0) : _count{initial} {}
+    semaphore(const semaphore &) = delete;
+    semaphore &operator=(const semaphore &) = delete;
+
+    acquire_awaiter acquire() { return acquire_awaiter{*this}; }
+
+    bool try_acquire()
+    {
+      critical_section critical;
+      if (_count == 0)
+        return false;
+      _count--;
+      return true;
+    }
+
+    // Each unit goes to a waiter, in FIFO order, or back to the count.
+    void release(std::ptrdiff_t n = 1)
+    {
+      internal::resumable_list woken;
+      {
+        critical_section critical;
+        for (; n > 0 && !_waiters.empty(); n--)
+          woken.push_back(_waiters.pop_front());
+        _count += n;
+      }
+      while (auto r = woken.pop_front())
+        r->exec->post(r);
+    }
+
+    void release_from_isr(BaseType_t &woken)
+    {
+      resumable *r;
+      {
+        internal::isr_critical_section critical;
+        r = _waiters.pop_front();
+        if (!r)
+          _count++;
+      }
+      if (r)
+        r->exec->post_from_isr(r, woken);
+    }
+
+    std::ptrdiff_t count() const
+    {
+      critical_section critical;
+      return _count;
+    }
+
+  private:
+    internal::resumable_list _waiters;
+    std::ptrdiff_t _count;
+  };
+
+  // Auto-reset event. set() resumes the first waiting coroutine, or, when
+  // nobody waits, keeps the event set until the next wait() consumes it.
+  class event
+  {
+  public:
+    class wait_awaiter
+    {
+    public:
+      explicit wait_awaiter(event &e) : _e{e} {}
+
+      bool await_ready() { return _e.try_consume(); }
+
+      template <typename P>
+      bool await_suspend(std::coroutine_handle<P> h)
+      {
+        _node.handle = h;
+        _node.exec = h.promise().exec();
+
+        critical_section critical;
+        if (_e._set)
+        {
+          _e._set = false;
+          return false;
+        }
+        _e._waiters.push_back(&_node);
+        return true;
+      }
+
+      void await_resume() const noexcept {}
+
+    private:
+      event &_e;
+      resumable _node;
+    };
+
+    event() = default;
+    event(const event &) = delete;
+    event &operator=(const event &) = delete;
+
+    wait_awaiter wait() { return wait_awaiter{*this}; }
+
+    void set()
+    {
+      resumable *r;
+      {
+        critical_section critical;
+        r = _waiters.pop_front();
+        if (!r)
+          _set = true;
+      }
+      if (r)
+        r->exec->post(r);
+    }
+
+    void set_from_isr(BaseType_t &woken)
+    {
+      resumable *r;
+      {
+        internal::isr_critical_section critical;
+        r = _waiters.pop_front();
+        if (!r)
+          _set = true;
+      }
+      if (r)
+        r->exec->post_from_isr(r, woken);
+    }
+
+    void reset()
+    {
+      critical_section critical;
+      _set = false;
+    }
+
+  private:
+    bool try_consume()
+    {
+      critical_section critical;
+      bool set = _set;
+      _set = false;
+      return set;
+    }
+
+    internal::resumable_list _waiters;
+    bool _set{false};
+  };
+
+  // FreeRTOS queue with coroutine receivers. Threads and ISRs send, and may
+  // also receive from native_handle(). A coroutine must not block its worker,
+  // so from a coroutine only try_send is allowed.
+  //
+  // A sender passes the element directly to the first waiting coroutine.
+  // Elements sent with the plain queue API on native_handle() do not wake
+  // the waiting coroutines.
+  template <typename T, std::size_t N>
+  class queue
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Element is copied by the kernel queue");
+    static_assert(std::is_default_constructible_v<T>, "Receiver keeps a T in the coroutine frame");
+    static_assert(N > 0, "Queue must have room for one element");
+
+    struct receiver : resumable
+    {
+      T value;
+    };
+
+  public:
+    class receive_awaiter
+    {
+    public:
+      explicit receive_awaiter(queue &q) : _q{q} {}
+
+      bool await_ready() { return xQueueReceive(_q._handle, &_node.value, 0) == pdTRUE; }
+
+      template <typename P>
+      bool await_suspend(std::coroutine_handle<P> h)
+      {
+        _node.handle = h;
+        _node.exec = h.promise().exec();
+
+        // Registers only if no element has been sent since the queue was
+        // seen empty. Otherwise that sender may have found no receiver.
+        for (;;)
+        {
+          std::uint32_t sent;
+          {
+            critical_section critical;
+            sent = _q._sent;
+          }
+          if (xQueueReceive(_q._handle, &_node.value, 0) == pdTRUE)
+            return false;
+
+          critical_section critical;
+          if (_q._sent == sent)
+          {
+            _q._waiters.push_back(&_node);
+            return true;
+          }
+        }
+      }
+
+      T await_resume() const noexcept { return _node.value; }
+
+    private:
+      queue &_q;
+      receiver _node;
+    };
+
+    queue()
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+      _handle = xQueueCreateStatic(N, sizeof(T), _storage, &_queue);
+#else
+      _handle = xQueueCreate(N, sizeof(T));
+#endif
+      configASSERT(_handle);
+    }
+
+    ~queue() { vQueueDelete(_handle); }
+
+    queue(const queue &) = delete;
+    queue &operator=(const queue &) = delete;
+
+    receive_awaiter receive() { return receive_awaiter{*this}; }
+
+    std::optional<T> try_receive()
+    {
+      T v;
+      if (xQueueReceive(_handle, &v, 0) != pdTRUE)
+        return std::nullopt;
+      return v;
+    }
+
+    // Blocks the calling thread while the queue is full.
+    void send(const T &v)
+    {
+      xQueueSendToBack(_handle, &v, portMAX_DELAY);
+      sent();
+    }
+
+    bool try_send(const T &v)
+    {
+      if (xQueueSendToBack(_handle, &v, 0) != pdTRUE)
+        return false;
+      sent();
+      return true;
+    }
+
+    bool send_from_isr(const T &v, BaseType_t &woken)
+    {
+      if (xQueueSendToBackFromISR(_handle, &v, &woken) != pdTRUE)
+        return false;
+      sent_from_isr(woken);
+      return true;
+    }
+
+    QueueHandle_t native_handle() const { return _handle; }
+
+  private:
+    // Moves the head of the queue to the first waiting receiver. Another
+    // receiver may have taken it in the meantime; then the waiter goes back
+    // and the loop repeats only if more has been sent since.
+    void sent()
+    {
+      {
+        critical_section critical;
+        _sent++;
+      }
+      for (;;)
+      {
+        receiver *r;
+        std::uint32_t sent;
+        {
+          critical_section critical;
+          r = static_cast<receiver *>(_waiters.pop_front());
+          sent = _sent;
+        }
+        if (!r)
+          return;
+        if (xQueueReceive(_handle, &r->value, 0) == pdTRUE)
+        {
+          r->exec->post(r);
+          return;
+        }
+
+        critical_section critical;
+        _waiters.push_front(r);
+        if (_sent == sent)
+          return;
+      }
+    }
+
+    void sent_from_isr(BaseType_t &woken)
+    {
+      {
+        internal::isr_critical_section critical;
+        _sent++;
+      }
+      for (;;)
+      {
+        receiver *r;
+        std::uint32_t sent;
+        {
+          internal::isr_critical_section critical;
+          r = static_cast<receiver *>(_waiters.pop_front());
+          sent = _sent;
+        }
+        if (!r)
+          return;
+        if (xQueueReceiveFromISR(_handle, &r->value, &woken) == pdTRUE)
+        {
+          r->exec->post_from_isr(r, woken);
+          return;
+        }
+
+        internal::isr_critical_section critical;
+        _waiters.push_front(r);
+        if (_sent == sent)
+          return;
+      }
+    }
+
+    QueueHandle_t _handle;
+    internal::resumable_list _waiters;
+    std::uint32_t _sent{0};
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StaticQueue_t _queue;
+    alignas(T) std::uint8_t _storage[N * sizeof(T)];
+#endif
+  };
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // FREERTOS_CORO_H__
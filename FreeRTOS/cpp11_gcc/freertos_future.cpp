@@ -0,0 +1,172 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_future.h"
+
+#include "critical_section.h"
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    union state_block
+    {
+      state_block *next;
+      alignas(std::max_align_t) unsigned char bytes[configSTD_FUTURE_STATE_SIZE];
+    };
+
+    state_block s_blocks[configSTD_FUTURE_STATE_COUNT];
+    state_block *s_free;   // released blocks
+    std::size_t s_unused;  // index of the first block never used
+    future_pool_stats s_stats;
+
+    bool from_pool(const void *p)
+    {
+      return p >= &s_blocks[0] && p < &s_blocks[configSTD_FUTURE_STATE_COUNT];
+    }
+  }
+
+  namespace internal
+  {
+    void *future_state_allocate(std::size_t size)
+    {
+      {
+        critical_section critical;
+        state_block *b = nullptr;
+        if (size <= sizeof(state_block))
+        {
+          if (s_free)
+          {
+            b = s_free;
+            s_free = b->next;
+          }
+          else if (s_unused < configSTD_FUTURE_STATE_COUNT)
+            b = &s_blocks[s_unused++];
+        }
+
+        if (b)
+        {
+          if (++s_stats.in_use > s_stats.peak)
+            s_stats.peak = s_stats.in_use;
+          return b;
+        }
+        s_stats.heap++;
+      }
+      return ::operator new(size);
+    }
+
+    void future_state_free(void *p)
+    {
+      if (!from_pool(p))
+      {
+        ::operator delete(p);
+        return;
+      }
+
+      critical_section critical;
+      auto b = static_cast<state_block *>(p);
+      b->next = s_free;
+      s_free = b;
+      s_stats.in_use--;
+    }
+
+    void future_signal::set()
+    {
+      std::uintptr_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+      while (state == 0 || (state & CONTINUATION))
+      {
+        if (!__atomic_compare_exchange_n(&_state, &state, READY, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+          continue;
+
+        // Nobody waits, or a continuation runs here. It is no longer
+        // registered, nothing else can run or withdraw it.
+        if (state)
+        {
+          auto c = reinterpret_cast<continuation *>(state & ~CONTINUATION);
+          c->run(c);
+        }
+        return;
+      }
+
+      // A task waits. It is notified in the same critical section which
+      // makes the state ready, see wait().
+      critical_section critical;
+      std::uintptr_t waiter = __atomic_exchange_n(&_state, READY, __ATOMIC_RELEASE);
+      if (waiter > READY)
+        xTaskNotifyGive(reinterpret_cast<TaskHandle_t>(waiter));
+    }
+
+    bool future_signal::then(continuation *c)
+    {
+      std::uintptr_t expected{0};
+      return __atomic_compare_exchange_n(&_state, &expected,
+                                         reinterpret_cast<std::uintptr_t>(c) | CONTINUATION,
+                                         false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    bool future_signal::withdraw(continuation *c)
+    {
+      std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(c) | CONTINUATION;
+      return __atomic_compare_exchange_n(&_state, &expected, 0, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    }
+
+    bool future_signal::wait(TickType_t ticks)
+    {
+      if (ready())
+        return true;
+      if (ticks == 0)
+        return false;
+
+      const auto self = reinterpret_cast<std::uintptr_t>(xTaskGetCurrentTaskHandle());
+      std::uintptr_t expected{0};
+      if (!__atomic_compare_exchange_n(&_state, &expected, self, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        return true; // ready in the meantime
+
+      TimeOut_t timeout;
+      vTaskSetTimeOutState(&timeout);
+      for (;;)
+      {
+        ulTaskNotifyTake(pdTRUE, ticks);
+
+        if (!ready() && xTaskCheckForTimeOut(&timeout, &ticks) == pdFALSE)
+          continue; // woken by another notification
+
+        expected = self;
+        if (__atomic_compare_exchange_n(&_state, &expected, 0, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+          return false; // timeout
+
+        // Ready. The notification has been given with it and is still
+        // pending if the task woke up for another reason.
+        ulTaskNotifyTake(pdTRUE, 0);
+        return true;
+      }
+    }
+  }
+
+  future_pool_stats future_pool_statistics()
+  {
+    critical_section critical;
+    return s_stats;
+  }
+}
@@ -0,0 +1,583 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_FUTURE_H__
+#define FREERTOS_FUTURE_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "freertos_timeout.h"
+
+// Light promise/future pair.
+//
+// free_rtos_std::promise<T> and free_rtos_std::future<T> have the interface
+// of the std ones. The shared state holds the result inline and comes from a
+// pool of configSTD_FUTURE_STATE_COUNT blocks of configSTD_FUTURE_STATE_SIZE
+// bytes. A state which does not fit, or does not find a free block, comes
+// from the heap. future_pool_statistics() tells how well the pool is sized.
+//
+// The state is one word: ready, or the task waiting in get(). set_value
+// makes it ready with a compare and swap and wakes the waiting task with a
+// direct task notification. There is no mutex and no condition variable.
+//
+// The library is built without exceptions. What the std types report with
+// a std::future_error (broken promise, a second set_value or get_future)
+// ends in std::terminate. There is no set_exception and no shared_future.
+//
+// Continuations, as in the Concurrency TS: f.then(g) returns a future of
+// g(ready f), without a task blocked in the meantime. g runs on the task
+// which makes f ready, inside its set_value, or is handed to an executor:
+// f.then(ex, g) calls ex.execute(c) with a callable 'c' of one pointer.
+// when_all(f...) becomes ready with a tuple of the ready futures once all
+// are ready, when_any(f...) as soon as one is, with its index. The objects
+// behind them come from the same pool as the shared states.
+//
+// Example:
+// ```
+// free_rtos_std::promise<int> p;
+// free_rtos_std::future<int> f = p.get_future();
+//
+// std::thread t{[&p] { p.set_value(measure()); }};
+// if (f.wait_for(100ms) == std::future_status::ready)
+//   show(f.get());
+//
+// auto shown = f.then([](free_rtos_std::future<int> v) { show(v.get()); });
+// ```
+
+#ifndef configSTD_FUTURE_STATE_SIZE
+#define configSTD_FUTURE_STATE_SIZE 64U
+#endif
+
+#ifndef configSTD_FUTURE_STATE_COUNT
+#define configSTD_FUTURE_STATE_COUNT 16U
+#endif
+
+namespace free_rtos_std
+{
+  template <typename T>
+  class future;
+
+  template <typename T>
+  class promise;
+
+  struct future_pool_stats
+  {
+    std::size_t in_use; // blocks of the pool
+    std::size_t peak;   // the most blocks in use at the same time
+    std::size_t heap;   // states allocated from the heap so far
+  };
+
+  future_pool_stats future_pool_statistics();
+
+  namespace internal
+  {
+    void *future_state_allocate(std::size_t size);
+    void future_state_free(void *p);
+
+    // Work to do when a state becomes ready, see future_signal::then.
+    struct continuation
+    {
+      void (*run)(continuation *self);
+    };
+
+    // Ready flag and the task or the continuation waiting for it.
+    class future_signal
+    {
+    public:
+      bool ready() const { return __atomic_load_n(&_state, __ATOMIC_ACQUIRE) == READY; }
+
+      // Makes the state ready and wakes the waiting task, or runs the
+      // continuation.
+      void set();
+
+      // Waits up to 'ticks' for the state to become ready. One task at a
+      // time.
+      bool wait(TickType_t ticks);
+
+      // Registers 'c' to run when the state becomes ready, instead of a
+      // waiting task. Returns false if the state is ready already, 'c' is
+      // not registered then.
+      bool then(continuation *c);
+
+      // Takes back 'c' registered by then(). Returns false if it has run or
+      // is about to run.
+      bool withdraw(continuation *c);
+
+    private:
+      static constexpr std::uintptr_t READY{1};
+      static constexpr std::uintptr_t CONTINUATION{2}; // tag of a continuation
+
+      std::uintptr_t _state{}; // 0, READY, the waiting task or a continuation
+    };
+
+    // The result of a future, with the void and reference forms.
+    template <typename T>
+    struct future_result
+    {
+      std::optional<T> value;
+
+      template <typename... Args>
+      void set(Args &&...args) { value.emplace(std::forward<Args>(args)...); }
+      T take() { return std::move(*value); }
+    };
+
+    template <typename T>
+    struct future_result<T &>
+    {
+      T *value{};
+
+      void set(T &v) { value = &v; }
+      T &take() { return *value; }
+    };
+
+    template <>
+    struct future_result<void>
+    {
+      void set() {}
+      void take() {}
+    };
+
+    template <typename T>
+    struct future_state
+    {
+      static void *operator new(std::size_t size) { return future_state_allocate(size); }
+      static void operator delete(void *p) { future_state_free(p); }
+
+      // Drops the reference of the promise or of the future.
+      static void release(future_state *s)
+      {
+        if (s && __atomic_sub_fetch(&s->refs, 1, __ATOMIC_ACQ_REL) == 0)
+          delete s;
+      }
+
+      future_signal signal;
+      future_result<T> result;
+      std::uint8_t refs{1};   // the promise, and the future once retrieved
+      bool retrieved{false};  // get_future has been called
+      bool broken{false};     // the promise is gone without a value
+    };
+
+    // Allocated from the pool of the shared states.
+    struct pooled
+    {
+      static void *operator new(std::size_t size) { return future_state_allocate(size); }
+      static void operator delete(void *p) { future_state_free(p); }
+    };
+
+    struct future_access
+    {
+      template <typename T>
+      static future_signal &signal(future<T> &f)
+      {
+        f.check();
+        return f._state->signal;
+      }
+    };
+  }
+
+  template <typename T>
+  class future
+  {
+  public:
+    future() noexcept = default;
+    future(future &&other) noexcept : _state{std::exchange(other._state, nullptr)} {}
+    future &operator=(future &&other) noexcept
+    {
+      if (this != &other)
+        internal::future_state<T>::release(std::exchange(_state, std::exchange(other._state, nullptr)));
+      return *this;
+    }
+    ~future() { internal::future_state<T>::release(_state); }
+
+    future(const future &) = delete;
+    future &operator=(const future &) = delete;
+
+    bool valid() const noexcept { return _state != nullptr; }
+
+    // Waits for the result and takes it, the future is not valid afterwards.
+    T get()
+    {
+      wait();
+      if (_state->broken)
+        std::terminate(); // std: future_error(broken_promise)
+
+      std::unique_ptr<internal::future_state<T>, release_state> s{std::exchange(_state, nullptr)};
+      return s->result.take();
+    }
+
+    void wait() const
+    {
+      check();
+      _state->signal.wait(portMAX_DELAY);
+    }
+
+    template <typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period> &rel) const
+    {
+      check();
+      return _state->signal.wait(block_ticks(rel)) ? std::future_status::ready
+                                                   : std::future_status::timeout;
+    }
+
+    template <typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration> &abs) const
+    {
+      check();
+      return _state->signal.wait(block_ticks(abs)) ? std::future_status::ready
+                                                   : std::future_status::timeout;
+    }
+
+    // Returns the future of f(ready *this). 'f' runs on the task which
+    // makes this future ready, or at once if it is ready. This future is
+    // not valid afterwards.
+    template <typename F>
+    auto then(F &&f);
+
+    // As above, but 'f' runs on 'ex', which must outlive the continuation.
+    template <typename Executor, typename F>
+    auto then(Executor &ex, F &&f);
+
+  private:
+    friend class promise<T>;
+    friend struct internal::future_access;
+
+    template <typename F>
+    auto then(void *ex, void (*post)(void *, internal::continuation *), F &&f);
+
+    struct release_state
+    {
+      void operator()(internal::future_state<T> *s) const { internal::future_state<T>::release(s); }
+    };
+
+    explicit future(internal::future_state<T> *s) : _state{s} {}
+
+    void check() const
+    {
+      if (!_state)
+        std::terminate(); // std: future_error(no_state)
+    }
+
+    internal::future_state<T> *_state{};
+  };
+
+  template <typename T>
+  class promise
+  {
+  public:
+    promise() : _state{new internal::future_state<T>} {}
+    promise(promise &&other) noexcept
+        : _state{std::exchange(other._state, nullptr)},
+          _satisfied{std::exchange(other._satisfied, false)} {}
+    promise &operator=(promise &&other) noexcept
+    {
+      // The state of this one is abandoned, as by the destructor.
+      promise(std::move(other)).swap(*this);
+      return *this;
+    }
+    ~promise()
+    {
+      if (_state && !_satisfied)
+      {
+        _state->broken = true;
+        _state->signal.set();
+      }
+      internal::future_state<T>::release(_state);
+    }
+
+    promise(const promise &) = delete;
+    promise &operator=(const promise &) = delete;
+
+    void swap(promise &other) noexcept
+    {
+      std::swap(_state, other._state);
+      std::swap(_satisfied, other._satisfied);
+    }
+
+    future<T> get_future()
+    {
+      if (!_state || _state->retrieved)
+        std::terminate(); // std: future_error(future_already_retrieved)
+      _state->retrieved = true;
+      __atomic_add_fetch(&_state->refs, 1, __ATOMIC_RELAXED);
+      return future<T>{_state};
+    }
+
+    // set_value(), set_value(const T &) or set_value(T &&), depending on T.
+    template <typename... Args>
+    void set_value(Args &&...args)
+    {
+      if (!_state || _satisfied)
+        std::terminate(); // std: future_error(promise_already_satisfied)
+      _satisfied = true;
+      _state->result.set(std::forward<Args>(args)...);
+      _state->signal.set();
+    }
+
+  private:
+    internal::future_state<T> *_state;
+    bool _satisfied{false};
+  };
+
+  template <typename T>
+  void swap(promise<T> &a, promise<T> &b) noexcept { a.swap(b); }
+
+  namespace internal
+  {
+    // Sets 'p' to the result of 'f(args...)'.
+    template <typename R, typename F, typename... Args>
+    void set_result(promise<R> &p, F &f, Args &&...args)
+    {
+      if constexpr (std::is_void_v<R>)
+      {
+        f(std::forward<Args>(args)...);
+        p.set_value();
+      }
+      else
+        p.set_value(f(std::forward<Args>(args)...));
+    }
+
+    template <typename T, typename F>
+    struct then_state : continuation, pooled
+    {
+      using result_type = std::invoke_result_t<F &, future<T>>;
+
+      then_state(future<T> &&src, F &&fun, void *ex, void (*post)(void *, continuation *))
+          : continuation{&then_state::ready}, source{std::move(src)},
+            f{std::forward<F>(fun)}, executor{ex}, post_to{post} {}
+
+      // On the task making 'source' ready.
+      static void ready(continuation *c)
+      {
+        auto self = static_cast<then_state *>(c);
+        if (self->post_to)
+        {
+          self->run = &then_state::invoke;
+          self->post_to(self->executor, self);
+        }
+        else
+          invoke(c);
+      }
+
+      static void invoke(continuation *c)
+      {
+        std::unique_ptr<then_state> self{static_cast<then_state *>(c)};
+        set_result(self->result, self->f, std::move(self->source));
+      }
+
+      future<T> source;
+      std::decay_t<F> f;
+      void *executor;
+      void (*post_to)(void *, continuation *);
+      promise<result_type> result;
+    };
+
+    // One input of when_all or when_any.
+    template <typename Owner>
+    struct input_continuation : continuation
+    {
+      Owner *owner;
+      std::size_t index;
+    };
+
+    template <typename... Ts>
+    struct when_all_state : pooled
+    {
+      using result_type = std::tuple<future<Ts>...>;
+
+      explicit when_all_state(future<Ts> &&...f) : inputs{std::move(f)...} {}
+
+      void start()
+      {
+        start(std::index_sequence_for<Ts...>{});
+      }
+
+      template <std::size_t... I>
+      void start(std::index_sequence<I...>)
+      {
+        (watch(std::get<I>(inputs), I), ...);
+      }
+
+      template <typename T>
+      void watch(future<T> &f, std::size_t i)
+      {
+        nodes[i] = {{&when_all_state::ready}, this, i};
+        if (!future_access::signal(f).then(&nodes[i]))
+          ready(&nodes[i]);
+      }
+
+      static void ready(continuation *c)
+      {
+        auto self = static_cast<input_continuation<when_all_state> *>(c)->owner;
+        if (__atomic_sub_fetch(&self->pending, 1, __ATOMIC_ACQ_REL) != 0)
+          return;
+
+        std::unique_ptr<when_all_state> s{self};
+        s->result.set_value(std::move(s->inputs));
+      }
+
+      result_type inputs;
+      input_continuation<when_all_state> nodes[sizeof...(Ts)];
+      std::size_t pending{sizeof...(Ts)};
+      promise<result_type> result;
+    };
+
+    template <typename... Ts>
+    struct when_any_state : pooled
+    {
+      using sequence_type = std::tuple<future<Ts>...>;
+
+      explicit when_any_state(future<Ts> &&...f) : inputs{std::move(f)...} {}
+
+      void start()
+      {
+        start(std::index_sequence_for<Ts...>{});
+        finish();
+        release();
+      }
+
+      template <std::size_t... I>
+      void start(std::index_sequence<I...>)
+      {
+        (watch(std::get<I>(inputs), I), ...);
+      }
+
+      template <typename T>
+      void watch(future<T> &f, std::size_t i)
+      {
+        nodes[i] = {{&when_any_state::ready}, this, i};
+        if (!future_access::signal(f).then(&nodes[i]))
+          ready(&nodes[i]);
+      }
+
+      static void ready(continuation *c)
+      {
+        auto node = static_cast<input_continuation<when_any_state> *>(c);
+        auto self = node->owner;
+        if (!__atomic_exchange_n(&self->won, true, __ATOMIC_ACQ_REL))
+        {
+          self->winner = node->index;
+          self->finish();
+        }
+        self->release();
+      }
+
+      // Called by the first input ready and by start(), the second one
+      // sets the result. All inputs are watched by then.
+      void finish()
+      {
+        if (__atomic_sub_fetch(&gate, 1, __ATOMIC_ACQ_REL) != 0)
+          return;
+
+        // The inputs go to the result, they must not call back any more.
+        withdraw(std::index_sequence_for<Ts...>{});
+        result.set_value(winner, std::move(inputs));
+      }
+
+      template <std::size_t... I>
+      void withdraw(std::index_sequence<I...>)
+      {
+        ((I != winner && future_access::signal(std::get<I>(inputs)).withdraw(&nodes[I])
+              ? release()
+              : void()),
+         ...);
+      }
+
+      void release()
+      {
+        if (__atomic_sub_fetch(&refs, 1, __ATOMIC_ACQ_REL) == 0)
+          delete this;
+      }
+
+      sequence_type inputs;
+      input_continuation<when_any_state> nodes[sizeof...(Ts)];
+      std::size_t winner{};
+      std::uint8_t gate{2};                // the winner and start()
+      std::size_t refs{sizeof...(Ts) + 1}; // the watched inputs and start()
+      bool won{false};
+      promise<std::pair<std::size_t, sequence_type>> result;
+    };
+  }
+
+  template <typename T>
+  template <typename F>
+  auto future<T>::then(F &&f)
+  {
+    return then(nullptr, nullptr, std::forward<F>(f));
+  }
+
+  template <typename T>
+  template <typename Executor, typename F>
+  auto future<T>::then(Executor &ex, F &&f)
+  {
+    return then(&ex, [](void *e, internal::continuation *c) {
+      static_cast<Executor *>(e)->execute([c] { c->run(c); });
+    },
+                std::forward<F>(f));
+  }
+
+  template <typename T>
+  template <typename F>
+  auto future<T>::then(void *ex, void (*post)(void *, internal::continuation *), F &&f)
+  {
+    check();
+    auto &signal = _state->signal;
+    auto s = new internal::then_state<T, F>{std::move(*this), std::forward<F>(f), ex, post};
+    auto r = s->result.get_future();
+    if (!signal.then(s))
+      s->run(s);
+    return r;
+  }
+
+  // Ready when all 'f' are, with the tuple of them.
+  template <typename... Ts>
+  future<std::tuple<future<Ts>...>> when_all(future<Ts> &&...f)
+  {
+    static_assert(sizeof...(Ts) > 0);
+    auto s = new internal::when_all_state<Ts...>{std::move(f)...};
+    auto r = s->result.get_future();
+    s->start();
+    return r;
+  }
+
+  // Ready when one of 'f' is, with its index and the tuple of all of them.
+  template <typename... Ts>
+  future<std::pair<std::size_t, std::tuple<future<Ts>...>>> when_any(future<Ts> &&...f)
+  {
+    static_assert(sizeof...(Ts) > 0);
+    auto s = new internal::when_any_state<Ts...>{std::move(f)...};
+    auto r = s->result.get_future();
+    s->start();
+    return r;
+  }
+}
+
+#endif // FREERTOS_FUTURE_H__
@@ -0,0 +1,287 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_lock_profiler.h"
+
+#if (configSTD_LOCK_PROFILING == 1)
+
+#include "critical_section.h"
+#include <algorithm>
+#include <bit>
+
+namespace free_rtos_std
+{
+  namespace lock_profiler
+  {
+    namespace
+    {
+      constexpr std::size_t TABLE_SIZE{configSTD_LOCK_PROFILING_TABLE_SIZE};
+
+      // Marks an entry of a destroyed mutex. Lookup continues past it.
+      const void *const REMOVED{reinterpret_cast<const void *>(1)};
+
+      lock_stats s_table[TABLE_SIZE];
+      std::uint32_t s_dropped;
+      lock_stats s_dumpBuffer[TABLE_SIZE];
+
+      std::size_t hash(const void *mutex)
+      {
+        // Kernel objects are at least pointer aligned, the low bits are zero.
+        constexpr int ALIGN_BITS{std::countr_zero(alignof(void *))};
+        return (reinterpret_cast<std::uintptr_t>(mutex) >> ALIGN_BITS) % TABLE_SIZE;
+      }
+
+      // Open addressing with linear probing. Must be called in a critical
+      // section. Returns nullptr if the mutex is not found and either
+      // 'insert' is false or the table is full.
+      lock_stats *find(const void *mutex, bool insert)
+      {
+        lock_stats *free{nullptr};
+        auto idx = hash(mutex);
+        for (std::size_t i = 0; i < TABLE_SIZE; ++i, idx = (idx + 1) % TABLE_SIZE)
+        {
+          auto &e = s_table[idx];
+          if (e.mutex == mutex)
+            return &e;
+          if (e.mutex == REMOVED)
+          {
+            if (!free)
+              free = &e;
+          }
+          else if (!e.mutex)
+          {
+            if (!free)
+              free = &e;
+            break;
+          }
+        }
+
+        if (!insert)
+          return nullptr;
+        if (!free)
+        {
+          ++s_dropped;
+          return nullptr;
+        }
+        *free = lock_stats{};
+        free->mutex = mutex;
+        return free;
+      }
+
+      bool more_contended(const lock_stats &lhs, const lock_stats &rhs)
+      {
+        if (lhs.contended != rhs.contended)
+          return lhs.contended > rhs.contended;
+        return lhs.totalWait > rhs.totalWait;
+      }
+
+      // Small formatter, printf is not always available.
+      struct line
+      {
+        char buf[128];
+        std::size_t len{0};
+
+        line &operator<<(const char *s)
+        {
+          while (*s && len < sizeof(buf) - 1)
+            buf[len++] = *s++;
+          buf[len] = '\0';
+          return *this;
+        }
+
+        line &operator<<(std::uint32_t v)
+        {
+          char tmp[11];
+          char *p = tmp + sizeof(tmp) - 1;
+          *p = '\0';
+          do
+          {
+            *--p = static_cast<char>('0' + v % 10);
+            v /= 10;
+          } while (v);
+          return *this << p;
+        }
+
+        line &hex(std::uintptr_t v)
+        {
+          char tmp[2 + 2 * sizeof(v) + 1];
+          char *p = tmp + sizeof(tmp) - 1;
+          *p = '\0';
+          do
+          {
+            *--p = "0123456789abcdef"[v & 0xFU];
+            v >>= 4;
+          } while (v);
+          *--p = 'x';
+          *--p = '0';
+          return *this << p;
+        }
+      };
+    }
+
+    BaseType_t take(SemaphoreHandle_t mutex, TickType_t ticks, bool recursive)
+    {
+      using take_fn = BaseType_t (*)(SemaphoreHandle_t, TickType_t);
+      take_fn takeFn = recursive ? [](SemaphoreHandle_t m, TickType_t t) { return xSemaphoreTakeRecursive(m, t); }
+                                 : take_fn{[](SemaphoreHandle_t m, TickType_t t) { return xSemaphoreTake(m, t); }};
+
+      std::uint32_t wait{0};
+      bool fContended{false};
+      auto result = takeFn(mutex, 0);
+      if (result != pdTRUE)
+      {
+        fContended = true;
+        if (ticks != 0)
+        {
+          auto t0 = static_cast<std::uint32_t>(configSTD_LOCK_PROFILING_CLOCK());
+          result = takeFn(mutex, ticks);
+          wait = static_cast<std::uint32_t>(configSTD_LOCK_PROFILING_CLOCK()) - t0;
+        }
+      }
+
+      critical_section critical;
+      auto e = find(mutex, true);
+      if (!e)
+        return result;
+
+      if (result == pdTRUE)
+      {
+        ++e->acquisitions;
+        e->holder = xTaskGetCurrentTaskHandle();
+        ++e->depth;
+      }
+      else
+        ++e->failures;
+
+      if (fContended)
+      {
+        ++e->contended;
+        e->totalWait += wait;
+        e->maxWait = std::max(e->maxWait, wait);
+      }
+      return result;
+    }
+
+    BaseType_t give(SemaphoreHandle_t mutex, bool recursive)
+    {
+      {
+        // Update before the mutex is given. Otherwise the next owner could
+        // be recorded first and then cleared here.
+        critical_section critical;
+        auto e = find(mutex, false);
+        if (e && e->depth && e->holder == xTaskGetCurrentTaskHandle())
+        {
+          if (--e->depth == 0)
+            e->holder = nullptr;
+        }
+      }
+
+      return recursive ? xSemaphoreGiveRecursive(mutex) : xSemaphoreGive(mutex);
+    }
+
+    void forget(SemaphoreHandle_t mutex)
+    {
+      critical_section critical;
+      auto e = find(mutex, false);
+      if (e)
+      {
+        *e = lock_stats{};
+        e->mutex = REMOVED;
+      }
+    }
+
+    std::size_t top_contended(lock_stats *out, std::size_t n)
+    {
+      std::size_t count{0};
+      critical_section critical;
+      for (auto &e : s_table)
+      {
+        if (!e.mutex || e.mutex == REMOVED || (!e.acquisitions && !e.failures))
+          continue;
+
+        // insertion into the sorted output
+        std::size_t pos = count;
+        while (pos > 0 && more_contended(e, out[pos - 1]))
+        {
+          if (pos < n)
+            out[pos] = out[pos - 1];
+          --pos;
+        }
+        if (pos < n)
+        {
+          out[pos] = e;
+          if (count < n)
+            ++count;
+        }
+      }
+      return count;
+    }
+
+    void dump(std::size_t topN, void (*write)(const char *))
+    {
+      auto n = top_contended(s_dumpBuffer, std::min(topN, TABLE_SIZE));
+      for (std::size_t i = 0; i < n; ++i)
+      {
+        const auto &e = s_dumpBuffer[i];
+        line l;
+        l << "LOCK ";
+        l.hex(reinterpret_cast<std::uintptr_t>(e.mutex));
+        l << " acq=" << e.acquisitions
+          << " contended=" << e.contended
+          << " failed=" << e.failures
+          << " wait_total=" << e.totalWait
+          << " wait_max=" << e.maxWait
+          << " holder=" << (e.holder ? pcTaskGetName(e.holder) : "-")
+          << "\n";
+        write(l.buf);
+      }
+
+      if (s_dropped)
+      {
+        line l;
+        l << "LOCK dropped=" << s_dropped << "\n";
+        write(l.buf);
+      }
+    }
+
+    std::uint32_t dropped()
+    {
+      return s_dropped;
+    }
+
+    void reset()
+    {
+      critical_section critical;
+      for (auto &e : s_table)
+      {
+        if (!e.mutex || e.mutex == REMOVED)
+          continue;
+        e.acquisitions = 0;
+        e.contended = 0;
+        e.failures = 0;
+        e.totalWait = 0;
+        e.maxWait = 0;
+      }
+      s_dropped = 0;
+    }
+  }
+}
+
+#endif // configSTD_LOCK_PROFILING == 1
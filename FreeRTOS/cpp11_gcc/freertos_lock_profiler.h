@@ -0,0 +1,165 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_LOCK_PROFILER_H__
+#define FREERTOS_LOCK_PROFILER_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "freertos_trace.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Lock contention profiler.
+//
+// With configSTD_LOCK_PROFILING set to 1 every lock, try_lock and timed lock
+// of std::mutex, std::timed_mutex and the recursive variants is recorded in
+// a fixed table, one entry per mutex handle. An entry holds:
+//  - number of acquisitions,
+//  - number of contended attempts (the mutex was not available at once),
+//  - number of failures (try_lock or timed lock gave up),
+//  - total and maximum wait time,
+//  - the task holding the mutex now.
+//
+// Wait time is measured with configSTD_LOCK_PROFILING_CLOCK(). By default
+// it is the clock counter of std::chrono clocks (freertos_clock.h), which
+// is the tick count unless the port provides a hardware counter.
+//
+// The table does not allocate. Mutexes that do not fit are counted in
+// lock_profiler::dropped(). Statistics of a mutex are discarded when it
+// is destroyed.
+
+#ifndef configSTD_LOCK_PROFILING
+#define configSTD_LOCK_PROFILING 0
+#endif
+
+#if (configSTD_LOCK_PROFILING == 1)
+
+#ifndef configSTD_LOCK_PROFILING_TABLE_SIZE
+#define configSTD_LOCK_PROFILING_TABLE_SIZE 32
+#endif
+
+#ifndef configSTD_LOCK_PROFILING_CLOCK
+#include "freertos_clock.h"
+#define configSTD_LOCK_PROFILING_CLOCK() free_rtos_std::clock_counter()
+#endif
+
+namespace free_rtos_std
+{
+  namespace lock_profiler
+  {
+    struct lock_stats
+    {
+      const void *mutex;
+      std::uint32_t acquisitions;
+      std::uint32_t contended;
+      std::uint32_t failures;
+      std::uint32_t totalWait;
+      std::uint32_t maxWait;
+      TaskHandle_t holder;
+      std::uint32_t depth; // ownership level of the holder
+    };
+
+    // Take the mutex and record the statistics.
+    BaseType_t take(SemaphoreHandle_t mutex, TickType_t ticks, bool recursive);
+    // Give the mutex and update the holder.
+    BaseType_t give(SemaphoreHandle_t mutex, bool recursive);
+    // Remove the mutex from the table.
+    void forget(SemaphoreHandle_t mutex);
+
+    // Copy up to 'n' entries, most contended first. Ties are ordered by
+    // the total wait time. Returns the number of copied entries.
+    std::size_t top_contended(lock_stats *out, std::size_t n);
+
+    // Print up to 'topN' most contended mutexes, one line each. Not thread
+    // safe, call it from one task only:
+    //   LOCK <handle> acq=.. contended=.. failed=.. wait_total=.. wait_max=.. holder=<name>
+    void dump(std::size_t topN, void (*write)(const char *));
+
+    // Number of mutexes not recorded because the table was full.
+    std::uint32_t dropped();
+
+    // Clear the counters. The holder information is kept.
+    void reset();
+  }
+}
+
+#endif // configSTD_LOCK_PROFILING == 1
+
+namespace free_rtos_std
+{
+  // Mutex operations used by the gthread layer. They go through the
+  // profiler and the event trace (freertos_trace.h) when enabled.
+  inline BaseType_t mutex_take(SemaphoreHandle_t mutex, TickType_t ticks)
+  {
+#if (configSTD_LOCK_PROFILING == 1)
+    auto result = lock_profiler::take(mutex, ticks, false);
+#else
+    auto result = xSemaphoreTake(mutex, ticks);
+#endif
+    if (result == pdTRUE)
+      trace::record_event(trace::event::mutex_take, mutex);
+    return result;
+  }
+
+  inline BaseType_t mutex_give(SemaphoreHandle_t mutex)
+  {
+    trace::record_event(trace::event::mutex_give, mutex);
+#if (configSTD_LOCK_PROFILING == 1)
+    return lock_profiler::give(mutex, false);
+#else
+    return xSemaphoreGive(mutex);
+#endif
+  }
+
+  inline BaseType_t recursive_mutex_take(SemaphoreHandle_t mutex, TickType_t ticks)
+  {
+#if (configSTD_LOCK_PROFILING == 1)
+    auto result = lock_profiler::take(mutex, ticks, true);
+#else
+    auto result = xSemaphoreTakeRecursive(mutex, ticks);
+#endif
+    if (result == pdTRUE)
+      trace::record_event(trace::event::mutex_take, mutex);
+    return result;
+  }
+
+  inline BaseType_t recursive_mutex_give(SemaphoreHandle_t mutex)
+  {
+    trace::record_event(trace::event::mutex_give, mutex);
+#if (configSTD_LOCK_PROFILING == 1)
+    return lock_profiler::give(mutex, true);
+#else
+    return xSemaphoreGiveRecursive(mutex);
+#endif
+  }
+
+  inline void mutex_delete(SemaphoreHandle_t mutex)
+  {
+#if (configSTD_LOCK_PROFILING == 1)
+    lock_profiler::forget(mutex);
+#endif
+    vSemaphoreDelete(mutex);
+  }
+}
+
+#endif // FREERTOS_LOCK_PROFILER_H__
@@ -0,0 +1,484 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_log.h"
+
+#if (configSTD_LOG == 1)
+
+#include "critical_section.h"
+#include "thread_with_attributes.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace free_rtos_std::log
+{
+  namespace
+  {
+    static_assert((configSTD_LOG_BUFFER_WORDS & (configSTD_LOG_BUFFER_WORDS - 1)) == 0,
+                  "configSTD_LOG_BUFFER_WORDS must be a power of two");
+
+    constexpr std::uint32_t WORDS{configSTD_LOG_BUFFER_WORDS};
+
+    // Single producer single consumer ring of record words. The producer is
+    // the owner thread, or anybody holding the critical section for the
+    // shared ring. The consumer is the drain task.
+    struct ring
+    {
+      std::uint32_t words[WORDS];
+      std::atomic<std::uint32_t> head{0};
+      std::atomic<std::uint32_t> tail{0};
+      std::uint32_t tailCache{0};  // producer's copy of tail
+      std::atomic<bool> orphan{false};
+      bool used{false};
+
+      bool reserve(std::uint32_t n)
+      {
+        auto h = head.load(std::memory_order_relaxed);
+        if (WORDS - (h - tailCache) >= n)
+          return true;
+        tailCache = tail.load(std::memory_order_acquire);
+        return WORDS - (h - tailCache) >= n;
+      }
+
+      bool empty() const
+      {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+      }
+    };
+
+    ring s_rings[configSTD_LOG_BUFFERS];
+    ring s_shared;
+
+    std::atomic<std::uint32_t> s_seq{0};     // records started
+    std::atomic<std::uint32_t> s_done{0};    // records written
+    std::atomic<std::uint32_t> s_dropped{0};
+    std::atomic<bool> s_parked{false};       // drain task waits for records
+    std::atomic<TaskHandle_t> s_flusher{nullptr}; // waits in flush()
+    std::mutex s_flushLock;                        // one flusher at a time
+    TaskHandle_t s_drain;
+    writer s_writer;
+
+    ring *thread_ring()
+    {
+      auto r = static_cast<ring *>(pvTaskGetThreadLocalStoragePointer(nullptr, configSTD_LOG_TLS_INDEX));
+      if (r)
+        return r;
+
+      r = &s_shared;
+      {
+        critical_section critical;
+        for (auto &candidate : s_rings)
+          if (!candidate.used)
+          {
+            candidate.used = true;
+            r = &candidate;
+            break;
+          }
+      }
+      // A thread without its own ring remembers the shared one, it does not
+      // search the pool on every write.
+      vTaskSetThreadLocalStoragePointer(nullptr, configSTD_LOG_TLS_INDEX, r);
+      return r;
+    }
+
+    // Called by producers after publishing. Pairs with the fence in drain().
+    void wake_drain(bool isr)
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!s_parked.load(std::memory_order_relaxed) || !s_parked.exchange(false))
+        return;
+      if (isr)
+      {
+        BaseType_t woken{pdFALSE}; // drain task has the lowest priority
+        vTaskNotifyGiveFromISR(s_drain, &woken);
+      }
+      else
+        xTaskNotifyGive(s_drain);
+    }
+
+    std::int32_t seq_at(const ring &r)
+    {
+      return static_cast<std::int32_t>(r.words[(r.tail.load(std::memory_order_relaxed) + 1) % WORDS]);
+    }
+
+    // Ring with the record of the lowest sequence number.
+    ring *oldest()
+    {
+      ring *best = s_shared.empty() ? nullptr : &s_shared;
+      for (auto &r : s_rings)
+        if (!r.empty() && (!best || seq_at(r) - seq_at(*best) < 0))
+          best = &r;
+      return best;
+    }
+
+    void release_orphans()
+    {
+      for (auto &r : s_rings)
+        if (r.orphan.load(std::memory_order_acquire) && r.empty())
+        {
+          critical_section critical;
+          r.head.store(0, std::memory_order_relaxed);
+          r.tail.store(0, std::memory_order_relaxed);
+          r.tailCache = 0;
+          r.orphan.store(false, std::memory_order_relaxed);
+          r.used = false;
+        }
+    }
+
+    void drain()
+    {
+      char line[configSTD_LOG_LINE_SIZE];
+      for (;;)
+      {
+        ring *r = oldest();
+        if (!r)
+        {
+          release_orphans();
+          if (auto f = s_flusher.load())
+          {
+            // The flusher does not run before the handle is cleared, see flush().
+            vTaskSuspendAll();
+            xTaskNotifyGive(f);
+            s_flusher.compare_exchange_strong(f, nullptr);
+            xTaskResumeAll();
+          }
+
+          s_parked.store(true, std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (!oldest())
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+          s_parked.store(false, std::memory_order_relaxed);
+          continue;
+        }
+
+        auto tail = r->tail.load(std::memory_order_relaxed);
+        auto size = r->words[tail % WORDS] >> 16;
+        if (internal::format_record(r->words, WORDS - 1, tail, line, sizeof(line), s_writer))
+          s_writer(line);
+        r->tail.store(tail + size, std::memory_order_release);
+        s_done.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    // Text output of format_record. Full chunks go to the writer, or the
+    // text is cut if there is none.
+    struct text
+    {
+      char *buf;
+      std::size_t size;
+      writer out;
+      std::size_t len{0};
+
+      void put(char c)
+      {
+        if (len + 1 >= size)
+        {
+          if (!out)
+            return;
+          buf[len] = '\0';
+          out(buf);
+          len = 0;
+        }
+        buf[len++] = c;
+      }
+
+      void put(const char *s, std::size_t n)
+      {
+        for (std::size_t i = 0; i < n; i++)
+          put(s[i]);
+      }
+
+      void put_unsigned(std::uint64_t v, unsigned base)
+      {
+        char digits[20];
+        unsigned n{0};
+        do
+        {
+          auto d = static_cast<unsigned>(v % base);
+          digits[n++] = static_cast<char>(d < 10 ? '0' + d : 'a' + d - 10);
+          v /= base;
+        } while (v);
+        while (n)
+          put(digits[--n]);
+      }
+
+      void put_signed(std::int64_t v, unsigned base)
+      {
+        if (v < 0)
+        {
+          put('-');
+          put_unsigned(0 - static_cast<std::uint64_t>(v), base);
+        }
+        else
+          put_unsigned(static_cast<std::uint64_t>(v), base);
+      }
+
+      void put_double(double v)
+      {
+        if (v != v)
+          return put("nan", 3);
+        if (v < 0)
+        {
+          put('-');
+          v = -v;
+        }
+        if (v >= 1.8e19)
+          return put("inf", 3);
+        auto milli = static_cast<std::uint64_t>(v * 1000 + 0.5);
+        put_unsigned(milli / 1000, 10);
+        put('.');
+        auto frac = static_cast<unsigned>(milli % 1000);
+        put(static_cast<char>('0' + frac / 100));
+        put(static_cast<char>('0' + frac / 10 % 10));
+        put(static_cast<char>('0' + frac % 10));
+      }
+    };
+  }
+
+  namespace internal
+  {
+    slot::slot(std::uint32_t words, bool isr) : _isr{isr}
+    {
+      ring *r;
+      if (isr)
+      {
+        _isrState = taskENTER_CRITICAL_FROM_ISR();
+        _locked = true;
+        r = &s_shared;
+        if (words > WORDS || !r->reserve(words))
+        {
+          taskEXIT_CRITICAL_FROM_ISR(_isrState);
+          _locked = false;
+          s_dropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+      }
+      else
+      {
+        r = thread_ring();
+        for (;;)
+        {
+          if (r == &s_shared)
+          {
+            taskENTER_CRITICAL();
+            _locked = true;
+          }
+          if (words <= WORDS && r->reserve(words))
+            break;
+          if (_locked)
+          {
+            taskEXIT_CRITICAL();
+            _locked = false;
+          }
+
+          if (!s_drain || words > WORDS)
+          {
+            s_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+          }
+          // Full, wait for the drain task.
+          xTaskNotifyGive(s_drain);
+          vTaskDelay(1);
+        }
+      }
+
+      _ring = r;
+      out = {r->words, WORDS - 1, r->head.load(std::memory_order_relaxed)};
+      seq = s_seq.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    slot::~slot()
+    {
+      if (!_ring)
+        return;
+
+      static_cast<ring *>(_ring)->head.store(out.pos, std::memory_order_release);
+      if (_locked)
+      {
+        if (_isr)
+          taskEXIT_CRITICAL_FROM_ISR(_isrState);
+        else
+          taskEXIT_CRITICAL();
+      }
+      if (s_drain)
+        wake_drain(_isr);
+    }
+
+    std::size_t format_record(const std::uint32_t *buf, std::uint32_t mask, std::uint32_t pos,
+                              char *out, std::size_t size, writer w)
+    {
+      if (size == 0)
+        return 0;
+
+      text t{out, size, w};
+      auto word = [&] { return buf[pos++ & mask]; };
+      auto raw = [&](auto &v) {
+        std::uint32_t tmp[(sizeof(v) + 3) / 4];
+        for (auto &x : tmp)
+          x = word();
+        std::memcpy(&v, tmp, sizeof(v));
+      };
+
+      auto nargs = word() & 0xFF;
+      (void)word(); // sequence number
+      auto types = word();
+      const char *fmt;
+      const void *p;
+      raw(p);
+      fmt = static_cast<const char *>(p);
+
+      // Values in the order of the arguments, strings are copied out as
+      // they are reached.
+      std::uint32_t next{0};
+      auto put_arg = [&](bool hex) {
+        if (next >= nargs)
+          return t.put("{?}", 3);
+        auto type = (types >> (4 * next++)) & 0xF;
+        unsigned base = hex ? 16 : 10;
+        switch (type)
+        {
+        case ARG_I32:
+          t.put_signed(static_cast<std::int32_t>(word()), base);
+          break;
+        case ARG_U32:
+          t.put_unsigned(word(), base);
+          break;
+        case ARG_I64:
+        case ARG_U64:
+        {
+          std::uint64_t v;
+          raw(v);
+          if (type == ARG_I64)
+            t.put_signed(static_cast<std::int64_t>(v), base);
+          else
+            t.put_unsigned(v, base);
+          break;
+        }
+        case ARG_BOOL:
+          word() ? t.put("true", 4) : t.put("false", 5);
+          break;
+        case ARG_CHAR:
+          t.put(static_cast<char>(word()));
+          break;
+        case ARG_DOUBLE:
+        {
+          double v;
+          raw(v);
+          t.put_double(v);
+          break;
+        }
+        case ARG_PTR:
+          raw(p);
+          t.put("0x", 2);
+          t.put_unsigned(reinterpret_cast<std::uintptr_t>(p), 16);
+          break;
+        case ARG_CSTR:
+          raw(p);
+          if (!p)
+            p = "(null)";
+          t.put(static_cast<const char *>(p), std::strlen(static_cast<const char *>(p)));
+          break;
+        case ARG_STR:
+        {
+          auto n = word();
+          for (std::uint32_t i = 0; i < n; i += 4)
+          {
+            auto v = word();
+            char c[4];
+            std::memcpy(c, &v, 4);
+            t.put(c, n - i < 4 ? n - i : 4);
+          }
+          break;
+        }
+        }
+      };
+
+      for (const char *f = fmt; *f; f++)
+      {
+        if (f[0] == '{' && f[1] == '}')
+        {
+          put_arg(false);
+          f++;
+        }
+        else if (f[0] == '{' && f[1] == ':' && f[2] == 'x' && f[3] == '}')
+        {
+          put_arg(true);
+          f += 3;
+        }
+        else
+          t.put(*f);
+      }
+
+      t.buf[t.len] = '\0';
+      return t.len;
+    }
+
+    void thread_exit()
+    {
+      auto r = static_cast<ring *>(pvTaskGetThreadLocalStoragePointer(nullptr, configSTD_LOG_TLS_INDEX));
+      if (!r)
+        return;
+      vTaskSetThreadLocalStoragePointer(nullptr, configSTD_LOG_TLS_INDEX, nullptr);
+      if (r != &s_shared)
+        r->orphan.store(true, std::memory_order_release);
+    }
+  }
+
+  void start(writer out, const attributes &attr)
+  {
+    if (s_drain)
+      return;
+    s_writer = out;
+
+    std::thread t = std_thread(attr, drain);
+    s_drain = t.native_handle().task_handle();
+    t.detach();
+  }
+
+  void flush()
+  {
+    if (!s_drain)
+      return;
+
+    std::lock_guard<std::mutex> lock{s_flushLock};
+    const auto self = xTaskGetCurrentTaskHandle();
+    const auto target = s_seq.load(std::memory_order_relaxed);
+    while (static_cast<std::int32_t>(s_done.load(std::memory_order_relaxed) - target) < 0)
+    {
+      s_flusher.store(self);
+      xTaskNotifyGive(s_drain);
+
+      // The drain task notifies and clears the handle with the scheduler
+      // suspended, once it has run out of records. A notification for
+      // anything else leaves the handle set.
+      do
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      while (s_flusher.load() == self);
+
+      // Its notification, if the wait has ended on another one.
+      ulTaskNotifyTake(pdTRUE, 0);
+    }
+  }
+
+  std::size_t dropped() { return s_dropped.load(std::memory_order_relaxed); }
+}
+
+#endif // configSTD_LOG == 1
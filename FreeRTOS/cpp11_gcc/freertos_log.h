@@ -0,0 +1,343 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_LOG_H__
+#define FREERTOS_LOG_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Deferred logging.
+//
+// log::write does not format anything. It stores the format string pointer
+// and the binary values of the arguments as one record in a ring buffer of
+// the calling thread, and returns. A drain task of low priority formats the
+// records and passes the text to the writer given to log::start, e.g. a
+// polled UART or semihosting output.
+//
+// Each thread gets its own buffer on the first write, taken from a pool of
+// configSTD_LOG_BUFFERS buffers of configSTD_LOG_BUFFER_WORDS words. Only the
+// thread writes to it and only the drain task reads it, so there is no lock.
+// The buffer goes back to the pool when a std::thread ends. Threads which
+// find the pool empty, and interrupts, share one more buffer guarded by a
+// critical section. The drain task merges the buffers in the order of the
+// write calls.
+//
+// A thread whose buffer is full waits for the drain task. An interrupt never
+// waits, its record is dropped and counted (see dropped()).
+//
+// Format: each {} is replaced by the next argument, {:x} prints it in hex.
+// Integers, bool, char, floating point (3 decimals), pointers and strings are
+// supported. A const char * is stored as a pointer, it must remain valid
+// until the record has been written: a literal, __func__ or __FILE__ are
+// fine. std::string and std::string_view are copied into the record, at most
+// configSTD_LOG_STRING_MAX characters. The format string itself is always a
+// pointer.
+//
+// Example:
+// ```
+// free_rtos_std::log::start(print);
+// free_rtos_std::log::write("adc {}: {} mV\n", channel, mv);
+// ```
+//
+// The thread buffer is kept in the thread local storage pointer
+// configSTD_LOG_TLS_INDEX.
+
+#ifndef configSTD_LOG
+#define configSTD_LOG 0
+#endif
+
+#if (configSTD_LOG == 1)
+
+#ifndef configSTD_LOG_TLS_INDEX
+#define configSTD_LOG_TLS_INDEX 2
+#endif
+
+static_assert(configSTD_LOG_TLS_INDEX > 0, "TLS slot 0 is used by std::thread");
+static_assert(configSTD_LOG_TLS_INDEX < configNUM_THREAD_LOCAL_STORAGE_POINTERS,
+              "Increase configNUM_THREAD_LOCAL_STORAGE_POINTERS");
+
+#ifndef configSTD_LOG_BUFFERS
+#define configSTD_LOG_BUFFERS 8
+#endif
+
+// Size of each buffer, a power of two.
+#ifndef configSTD_LOG_BUFFER_WORDS
+#define configSTD_LOG_BUFFER_WORDS 256
+#endif
+
+#ifndef configSTD_LOG_STRING_MAX
+#define configSTD_LOG_STRING_MAX 64
+#endif
+
+// Size of the text chunks passed to the writer.
+#ifndef configSTD_LOG_LINE_SIZE
+#define configSTD_LOG_LINE_SIZE 128
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "freertos_thread_attributes.h"
+
+namespace free_rtos_std::log
+{
+  // Receives null terminated pieces of the formatted text.
+  using writer = void (*)(const char *);
+
+  // Starts the drain task. Records written before are kept and written then.
+  void start(writer out, const attributes &attr = attributes{.taskName = "log", .priority = tskIDLE_PRIORITY});
+
+  // Waits until the records written so far, by any thread, have been passed
+  // to the writer. Returns immediately if the drain task is not running.
+  void flush();
+
+  // Number of records lost: written by an interrupt into the full shared
+  // buffer, written before start() into a full buffer, or too large.
+  std::size_t dropped();
+
+  namespace internal
+  {
+    enum arg_type : std::uint32_t
+    {
+      ARG_I32 = 1,
+      ARG_U32,
+      ARG_I64,
+      ARG_U64,
+      ARG_BOOL,
+      ARG_CHAR,
+      ARG_DOUBLE,
+      ARG_PTR,
+      ARG_CSTR,
+      ARG_STR,
+    };
+
+    constexpr std::size_t MAX_ARGS{8};
+    constexpr std::uint32_t PTR_WORDS{sizeof(void *) / sizeof(std::uint32_t)};
+    constexpr std::uint32_t HEADER_WORDS{3 + PTR_WORDS}; // size, seq, types, format
+    constexpr std::uint32_t STR_WORDS{1 + (configSTD_LOG_STRING_MAX + 3) / 4};
+
+    template <typename T>
+    constexpr arg_type type_of()
+    {
+      using U = std::remove_cv_t<T>;
+      if constexpr (std::is_same_v<U, bool>)
+        return ARG_BOOL;
+      else if constexpr (std::is_same_v<U, char>)
+        return ARG_CHAR;
+      else if constexpr (std::is_enum_v<U>)
+        return type_of<std::underlying_type_t<U>>();
+      else if constexpr (std::is_integral_v<U>)
+      {
+        if constexpr (sizeof(U) > 4)
+          return std::is_signed_v<U> ? ARG_I64 : ARG_U64;
+        else
+          return std::is_signed_v<U> ? ARG_I32 : ARG_U32;
+      }
+      else if constexpr (std::is_floating_point_v<U>)
+        return ARG_DOUBLE;
+      else if constexpr (std::is_array_v<U> &&
+                         std::is_same_v<std::remove_cv_t<std::remove_extent_t<U>>, char>)
+        return ARG_CSTR;
+      else if constexpr (std::is_pointer_v<U> &&
+                         std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char>)
+        return ARG_CSTR;
+      else if constexpr (std::is_pointer_v<U>)
+        return ARG_PTR;
+      else if constexpr (std::is_convertible_v<const U &, std::string_view>)
+        return ARG_STR;
+      else
+        static_assert(!sizeof(U), "Type cannot be logged");
+    }
+
+    template <typename T>
+    constexpr std::uint32_t max_words()
+    {
+      switch (type_of<T>())
+      {
+      case ARG_I64:
+      case ARG_U64:
+      case ARG_DOUBLE:
+        return 2;
+      case ARG_PTR:
+      case ARG_CSTR:
+        return PTR_WORDS;
+      case ARG_STR:
+        return STR_WORDS;
+      default:
+        return 1;
+      }
+    }
+
+    inline std::size_t str_length(std::string_view s)
+    {
+      return s.size() < configSTD_LOG_STRING_MAX ? s.size() : configSTD_LOG_STRING_MAX;
+    }
+
+    template <typename T>
+    std::uint32_t words_of(const T &v)
+    {
+      if constexpr (type_of<T>() == ARG_STR)
+        return 1 + (str_length(v) + 3) / 4;
+      else
+        return max_words<T>();
+    }
+
+    // Writes the words of a record. 'mask' wraps the position around the
+    // end of a ring buffer.
+    struct encoder
+    {
+      std::uint32_t *buf;
+      std::uint32_t mask;
+      std::uint32_t pos;
+
+      void put(std::uint32_t w) { buf[pos++ & mask] = w; }
+
+      template <typename T>
+      void put_raw(const T &v)
+      {
+        std::uint32_t w[(sizeof(T) + 3) / 4]{};
+        std::memcpy(w, &v, sizeof(T));
+        for (auto x : w)
+          put(x);
+      }
+
+      template <typename T>
+      void put_arg(const T &v)
+      {
+        constexpr auto type = type_of<T>();
+        if constexpr (type == ARG_I64 || type == ARG_U64)
+          put_raw(static_cast<std::uint64_t>(v));
+        else if constexpr (type == ARG_DOUBLE)
+          put_raw(static_cast<double>(v));
+        else if constexpr (type == ARG_CSTR || type == ARG_PTR)
+          put_raw(static_cast<const void *>(v));
+        else if constexpr (type == ARG_STR)
+        {
+          std::string_view s{v};
+          auto n = str_length(s);
+          put(n);
+          for (std::size_t i = 0; i < n; i += 4)
+          {
+            std::uint32_t w{};
+            std::memcpy(&w, s.data() + i, n - i < 4 ? n - i : 4);
+            put(w);
+          }
+        }
+        else
+          put(static_cast<std::uint32_t>(v));
+      }
+    };
+
+    template <typename... Args>
+    constexpr std::uint32_t types_of()
+    {
+      std::uint32_t types{0};
+      unsigned i{0};
+      ((types |= static_cast<std::uint32_t>(type_of<Args>()) << (4 * i++)), ...);
+      return types;
+    }
+
+    template <typename... Args>
+    void encode(encoder &e, std::uint32_t words, std::uint32_t seq, const char *fmt, const Args &...args)
+    {
+      e.put(words << 16 | sizeof...(Args));
+      e.put(seq);
+      e.put(types_of<Args...>());
+      e.put_raw(static_cast<const void *>(fmt));
+      (e.put_arg(args), ...);
+    }
+
+    // Room for one record in a buffer. The constructor reserves it and takes
+    // the next sequence number, or fails (see operator bool). The destructor
+    // publishes the record.
+    class slot
+    {
+    public:
+      slot(std::uint32_t words, bool isr);
+      ~slot();
+
+      slot(const slot &) = delete;
+      slot &operator=(const slot &) = delete;
+
+      explicit operator bool() const { return _ring != nullptr; }
+
+      encoder out;
+      std::uint32_t seq{};
+
+    private:
+      void *_ring{};
+      UBaseType_t _isrState{};
+      bool _isr;
+      bool _locked{false};
+    };
+
+    template <typename... Args>
+    void emit(bool isr, const char *fmt, const Args &...args)
+    {
+      static_assert(sizeof...(Args) <= MAX_ARGS, "Too many arguments");
+      std::uint32_t words = HEADER_WORDS + (0 + ... + words_of(args));
+      slot s{words, isr};
+      if (s)
+        encode(s.out, words, s.seq, fmt, args...);
+    }
+
+    // Formats the record at 'pos' of a buffer into 'out', at most size - 1
+    // characters. With a writer, full chunks are passed to it instead of
+    // being cut off. Returns the length of the text left in 'out'.
+    std::size_t format_record(const std::uint32_t *buf, std::uint32_t mask, std::uint32_t pos,
+                              char *out, std::size_t size, writer w);
+
+    // Called when a std::thread ends, gives its buffer back to the pool.
+    void thread_exit();
+  }
+
+  template <typename... Args>
+  void write(const char *fmt, const Args &...args)
+  {
+    internal::emit(false, fmt, args...);
+  }
+
+  template <typename... Args>
+  void write_from_isr(const char *fmt, const Args &...args)
+  {
+    internal::emit(true, fmt, args...);
+  }
+
+  // Formats immediately into 'out', the same way the drain task does.
+  // Returns the length, the text is cut to size - 1 characters.
+  template <typename... Args>
+  std::size_t format(char *out, std::size_t size, const char *fmt, const Args &...args)
+  {
+    static_assert(sizeof...(Args) <= internal::MAX_ARGS, "Too many arguments");
+    std::uint32_t rec[internal::HEADER_WORDS + (0 + ... + internal::max_words<Args>())];
+    internal::encoder e{rec, ~0U, 0};
+    internal::encode(e, internal::HEADER_WORDS + (0 + ... + internal::words_of(args)), 0, fmt, args...);
+    return internal::format_record(rec, ~0U, 0, out, size, nullptr);
+  }
+}
+
+#endif // configSTD_LOG == 1
+
+#endif // FREERTOS_LOG_H__
@@ -0,0 +1,315 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_mutex.h"
+
+#if (configSTD_FAST_MUTEX == 1) || (configSTD_SHARED_MUTEX == 1)
+
+#include "critical_section.h"
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    // The lock word is written with an exclusive store also inside a
+    // critical section. The ports do not clear the exclusive monitor on a
+    // context switch, so a task preempted in the middle of its compare and
+    // swap must find its store failed.
+    template <typename T>
+    void store(T *state, T v)
+    {
+      T old = __atomic_load_n(state, __ATOMIC_RELAXED);
+      while (!__atomic_compare_exchange_n(state, &old, v, true,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+        ;
+    }
+
+    // Called in a critical section.
+    void enqueue(internal::lock_waiter **list, internal::lock_waiter *w)
+    {
+      // Behind the waiters of the same priority.
+      while (*list && (*list)->priority >= w->priority)
+        list = &(*list)->next;
+      w->next = *list;
+      *list = w;
+    }
+
+    // Called in a critical section.
+    void dequeue(internal::lock_waiter **list, internal::lock_waiter *w)
+    {
+      for (; *list; list = &(*list)->next)
+        if (*list == w)
+        {
+          *list = w->next;
+          return;
+        }
+    }
+
+    // Called in a critical section.
+    void grant(internal::lock_waiter *w)
+    {
+      w->granted = true;
+      xTaskNotifyGiveIndexed(w->task, configSTD_LOCK_NOTIFY_INDEX);
+    }
+
+    internal::lock_waiter make_waiter()
+    {
+      return {xTaskGetCurrentTaskHandle(), uxTaskPriorityGet(nullptr), nullptr, false};
+    }
+
+    // Waits until the lock is handed over to the queued 'w'. When the time
+    // runs out, 'give_up' is called in a critical section to take 'w' off
+    // its list.
+    template <typename F>
+    bool wait(internal::lock_waiter &w, TimeOut_t &timeout, TickType_t ticks, F give_up)
+    {
+      for (;;)
+      {
+        ulTaskNotifyTakeIndexed(configSTD_LOCK_NOTIFY_INDEX, pdTRUE, ticks);
+
+        critical_section critical;
+        if (w.granted)
+        {
+          // The notification is not pending if the wait timed out just
+          // before the handover.
+          ulTaskNotifyTakeIndexed(configSTD_LOCK_NOTIFY_INDEX, pdTRUE, 0);
+          return true;
+        }
+
+        if (xTaskCheckForTimeOut(&timeout, &ticks) == pdTRUE)
+        {
+          give_up();
+          return false;
+        }
+      }
+    }
+  }
+}
+
+#endif
+
+#if (configSTD_FAST_MUTEX == 1)
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    constexpr std::uintptr_t CONTENDED{1};
+
+    TaskHandle_t owner(std::uintptr_t state)
+    {
+      return reinterpret_cast<TaskHandle_t>(state & ~CONTENDED);
+    }
+  }
+
+  void fast_mutex::uncount_held()
+  {
+    if (!counted())
+      return;
+
+    // Gives back the inherited priority if this was the last mutex held.
+    BaseType_t yield;
+    {
+      critical_section critical;
+      yield = xTaskPriorityDisinherit(xTaskGetCurrentTaskHandle());
+    }
+    if (yield == pdTRUE)
+      taskYIELD();
+  }
+
+  bool fast_mutex::lock_slow(TickType_t ticks)
+  {
+    internal::lock_waiter w{make_waiter()};
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+    bool inherited{false};
+
+    {
+      critical_section critical;
+      std::uintptr_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+      if (state == 0) // unlocked in the meantime, nobody waits
+      {
+        store(&_state, reinterpret_cast<std::uintptr_t>(w.task));
+        count_held();
+        return true;
+      }
+
+      // From now on the owner unlocks in the slow path, also if this
+      // task gives up waiting.
+      store(&_state, state | CONTENDED);
+      enqueue(&_waiters, &w);
+      inherited = xTaskPriorityInherit(owner(state)) == pdTRUE;
+    }
+
+    const bool taken = wait(w, timeout, ticks, [&] {
+      dequeue(&_waiters, &w);
+
+      // The owner drops to the priority of the remaining waiters, unless
+      // it holds another mutex. A task handed the mutex is counted as
+      // holding it only once it runs, it keeps what it has inherited.
+      if (inherited && !_handover)
+        vTaskPriorityDisinheritAfterTimeout(owner(__atomic_load_n(&_state, __ATOMIC_RELAXED)),
+                                            _waiters ? _waiters->priority : tskIDLE_PRIORITY);
+    });
+    if (!taken)
+      return false;
+
+    critical_section critical;
+    _handover = nullptr;
+    count_held();
+    return true;
+  }
+
+  void fast_mutex::unlock_slow()
+  {
+    BaseType_t yield{pdFALSE};
+    {
+      critical_section critical;
+      if (counted())
+        yield = xTaskPriorityDisinherit(xTaskGetCurrentTaskHandle());
+
+      internal::lock_waiter *w = _waiters;
+      if (w)
+      {
+        // The new owner has the highest priority of the waiters, there
+        // is nothing for the others to lend it.
+        _waiters = w->next;
+        _handover = w;
+        store(&_state, reinterpret_cast<std::uintptr_t>(w->task) | (_waiters ? CONTENDED : 0));
+        grant(w);
+      }
+      else
+        store(&_state, std::uintptr_t{0});
+    }
+
+    if (yield == pdTRUE)
+      taskYIELD();
+  }
+}
+
+#endif // configSTD_FAST_MUTEX == 1
+
+#if (configSTD_SHARED_MUTEX == 1)
+
+namespace free_rtos_std
+{
+  bool rwlock::lock_shared_slow(TickType_t ticks)
+  {
+    internal::lock_waiter w{make_waiter()};
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+
+    {
+      critical_section critical;
+      std::uint32_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+      if ((state & (WRITER | WRITER_WAITING)) == 0)
+      {
+        store(&_state, state + 1);
+        return true;
+      }
+
+      // Readers are granted all at once, the order does not matter.
+      store(&_state, state | READER_WAITING);
+      w.next = _readers;
+      _readers = &w;
+    }
+
+    return wait(w, timeout, ticks, [&] {
+      dequeue(&_readers, &w);
+      if (!_readers)
+        __atomic_fetch_and(&_state, ~READER_WAITING, __ATOMIC_RELAXED);
+    });
+  }
+
+  bool rwlock::lock_slow(TickType_t ticks)
+  {
+    internal::lock_waiter w{make_waiter()};
+    TimeOut_t timeout;
+    vTaskSetTimeOutState(&timeout);
+
+    {
+      critical_section critical;
+      std::uint32_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+      if (state == 0)
+      {
+        store(&_state, WRITER);
+        return true;
+      }
+
+      // New readers wait from now on.
+      store(&_state, state | WRITER_WAITING);
+      enqueue(&_writers, &w);
+    }
+
+    return wait(w, timeout, ticks, [&] {
+      dequeue(&_writers, &w);
+      if (!_writers)
+        __atomic_fetch_and(&_state, ~WRITER_WAITING, __ATOMIC_RELAXED);
+      // The readers queued behind this writer may enter now.
+      wake();
+    });
+  }
+
+  void rwlock::unlock_shared_slow()
+  {
+    critical_section critical;
+    wake();
+  }
+
+  void rwlock::unlock_slow()
+  {
+    critical_section critical;
+    __atomic_fetch_and(&_state, ~WRITER, __ATOMIC_RELEASE);
+    wake();
+  }
+
+  // Called in a critical section. Hands the lock over to the first writer
+  // or, with no writer waiting, to all readers.
+  void rwlock::wake()
+  {
+    std::uint32_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+    if (state & WRITER)
+      return;
+
+    if (internal::lock_waiter *w = _writers)
+    {
+      if (state & READERS)
+        return; // the last reader leaving calls again
+
+      _writers = w->next;
+      store(&_state, (state & READER_WAITING) | WRITER | (_writers ? WRITER_WAITING : 0));
+      grant(w);
+      return;
+    }
+
+    std::uint32_t readers{0};
+    for (internal::lock_waiter *w = _readers; w; readers++)
+    {
+      // Read 'next' first, a granted waiter leaves.
+      internal::lock_waiter *next = w->next;
+      grant(w);
+      w = next;
+    }
+    _readers = nullptr;
+    store(&_state, (state & ~READER_WAITING) + readers);
+  }
+}
+
+#endif // configSTD_SHARED_MUTEX == 1
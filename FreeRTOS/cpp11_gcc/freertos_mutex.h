@@ -0,0 +1,269 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_MUTEX_H__
+#define FREERTOS_MUTEX_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "freertos_trace.h"
+
+#include <cstdint>
+
+// User space locks: the fast path of std::mutex and the reader-writer lock
+// behind free_rtos_std::shared_mutex (freertos_shared_mutex.h).
+//
+// With configSTD_FAST_MUTEX set to 1 the mutex is a word holding the owner
+// task. Locking a free mutex and unlocking a mutex nobody waits for is one
+// compare and swap (LDREX/STREX on ARM, LR/SC on RISC-V). There is no kernel
+// object behind it. The kernel counts it among the mutexes the task holds,
+// so an inherited priority lasts until the last kernel or fast mutex is
+// given. Unlock updates that count in a short critical section.
+//
+// A task finding the mutex taken enters a critical section, marks the mutex
+// contended, queues itself by priority on a list kept on the stacks of the
+// waiting tasks and lends its priority to the owner, as the kernel mutex
+// does. Then it waits for a task notification. Unlock of a contended mutex
+// gives the owner back its base priority and hands the mutex directly to the
+// first waiter. A timed lock that gives up lowers the owner to the priority
+// of the remaining waiters, as the kernel mutex does after a timeout.
+//
+// With configSTD_SHARED_MUTEX set to 1 there is the reader-writer lock
+// 'rwlock'. The word holds the number of readers and flags for a writer
+// owning or waiting. Readers enter and leave with a compare and swap while
+// no writer owns or waits for the lock. Waiting writers are preferred, new
+// readers queue behind them. The waiters are queued and woken like the ones
+// of the mutex, there is no priority inheritance.
+//
+// The waits use task notification index configSTD_LOCK_NOTIFY_INDEX, so
+// configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 2. The lock
+// profiler records kernel mutexes only and cannot be used with the fast
+// mutex.
+
+#ifndef configSTD_FAST_MUTEX
+#define configSTD_FAST_MUTEX 0
+#endif
+
+#ifndef configSTD_SHARED_MUTEX
+#define configSTD_SHARED_MUTEX 0
+#endif
+
+#if (configSTD_FAST_MUTEX == 1) || (configSTD_SHARED_MUTEX == 1)
+
+#ifndef configSTD_LOCK_NOTIFY_INDEX
+#define configSTD_LOCK_NOTIFY_INDEX (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+
+#if (configSTD_LOCK_NOTIFY_INDEX == 0)
+#error "the user space locks need configTASK_NOTIFICATION_ARRAY_ENTRIES of at least 2"
+#endif
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    // A task waiting for a lock. It lives on the stack of that task.
+    struct lock_waiter
+    {
+      TaskHandle_t task;
+      UBaseType_t priority;
+      lock_waiter *next;
+      bool granted; // the lock has been handed over to the task
+    };
+  }
+}
+
+#endif
+
+#if (configSTD_FAST_MUTEX == 1)
+
+#if (configUSE_MUTEXES == 0)
+#error "configSTD_FAST_MUTEX needs configUSE_MUTEXES for the priority inheritance"
+#endif
+
+#if (configSTD_LOCK_PROFILING == 1)
+#error "configSTD_LOCK_PROFILING cannot be used with configSTD_FAST_MUTEX"
+#endif
+
+#if (INCLUDE_xTaskGetSchedulerState == 0)
+#error "configSTD_FAST_MUTEX needs INCLUDE_xTaskGetSchedulerState"
+#endif
+
+namespace free_rtos_std
+{
+  class fast_mutex
+  {
+  public:
+    constexpr fast_mutex() = default;
+
+    bool try_lock()
+    {
+      std::uintptr_t expected{0};
+      if (!__atomic_compare_exchange_n(&_state, &expected, self(), false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return false;
+      count_held();
+      return true;
+    }
+
+    // Returns false if the mutex was not taken within 'ticks'.
+    bool lock(TickType_t ticks) { return try_lock() || (ticks != 0 && lock_slow(ticks)); }
+
+    void unlock()
+    {
+      std::uintptr_t expected{self()};
+      if (__atomic_compare_exchange_n(&_state, &expected, 0, false,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        uncount_held();
+      else
+        unlock_slow();
+    }
+
+  private:
+    static std::uintptr_t self()
+    {
+      return reinterpret_cast<std::uintptr_t>(xTaskGetCurrentTaskHandle());
+    }
+
+    // The kernel counts the mutexes held by the running task, also before
+    // the scheduler runs. Those are not counted.
+    static bool counted()
+    {
+      return xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+    }
+
+    static void count_held()
+    {
+      if (counted())
+        pvTaskIncrementMutexHeldCount();
+    }
+
+    static void uncount_held();
+    bool lock_slow(TickType_t ticks);
+    void unlock_slow();
+
+    std::uintptr_t _state{};             // owner task | contended bit, 0 when free
+    internal::lock_waiter *_waiters{};   // highest priority first
+    internal::lock_waiter *_handover{};  // granted, not counted by its task yet
+  };
+
+  // Mutex operations used by the gthread layer, see freertos_lock_profiler.h
+  // for the kernel mutex ones.
+  inline fast_mutex *mutex_handle(fast_mutex *mutex)
+  {
+    return mutex;
+  }
+
+  inline BaseType_t mutex_take(fast_mutex *mutex, TickType_t ticks)
+  {
+    if (!mutex->lock(ticks))
+      return pdFALSE;
+    trace::record_event(trace::event::mutex_take, mutex);
+    return pdTRUE;
+  }
+
+  inline BaseType_t mutex_give(fast_mutex *mutex)
+  {
+    trace::record_event(trace::event::mutex_give, mutex);
+    mutex->unlock();
+    return pdTRUE;
+  }
+
+  inline void mutex_delete(fast_mutex *)
+  {
+  }
+}
+
+#endif // configSTD_FAST_MUTEX == 1
+
+#if (configSTD_SHARED_MUTEX == 1)
+
+namespace free_rtos_std
+{
+  class rwlock
+  {
+  public:
+    constexpr rwlock() = default;
+
+    bool try_lock_shared()
+    {
+      std::uint32_t state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+      do
+      {
+        if (state & (WRITER | WRITER_WAITING))
+          return false;
+      } while (!__atomic_compare_exchange_n(&_state, &state, state + 1, true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+      return true;
+    }
+
+    // Returns false if the lock was not taken within 'ticks'.
+    bool lock_shared(TickType_t ticks) { return try_lock_shared() || (ticks != 0 && lock_shared_slow(ticks)); }
+
+    void unlock_shared()
+    {
+      // The last reader leaving hands the lock to a waiting writer.
+      std::uint32_t state = __atomic_sub_fetch(&_state, 1, __ATOMIC_RELEASE);
+      if ((state & READERS) == 0 && (state & WRITER_WAITING))
+        unlock_shared_slow();
+    }
+
+    bool try_lock()
+    {
+      std::uint32_t expected{0};
+      return __atomic_compare_exchange_n(&_state, &expected, WRITER, false,
+                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+    }
+
+    // Returns false if the lock was not taken within 'ticks'.
+    bool lock(TickType_t ticks) { return try_lock() || (ticks != 0 && lock_slow(ticks)); }
+
+    // True while a writer owns the lock.
+    bool locked_exclusive() const { return __atomic_load_n(&_state, __ATOMIC_RELAXED) & WRITER; }
+
+    void unlock()
+    {
+      std::uint32_t expected{WRITER};
+      if (!__atomic_compare_exchange_n(&_state, &expected, 0, false,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        unlock_slow();
+    }
+
+  private:
+    static constexpr std::uint32_t WRITER{1u << 31};         // a writer owns the lock
+    static constexpr std::uint32_t WRITER_WAITING{1u << 30}; // _writers is not empty
+    static constexpr std::uint32_t READER_WAITING{1u << 29}; // _readers is not empty
+    static constexpr std::uint32_t READERS{READER_WAITING - 1};
+
+    bool lock_shared_slow(TickType_t ticks);
+    bool lock_slow(TickType_t ticks);
+    void unlock_shared_slow();
+    void unlock_slow();
+    void wake();
+
+    std::uint32_t _state{};              // flags | number of readers
+    internal::lock_waiter *_readers{};   // in order of arrival
+    internal::lock_waiter *_writers{};   // highest priority first
+  };
+}
+
+#endif // configSTD_SHARED_MUTEX == 1
+
+#endif // FREERTOS_MUTEX_H__
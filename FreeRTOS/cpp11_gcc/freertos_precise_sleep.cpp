@@ -0,0 +1,157 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_precise_sleep.h"
+
+#if (configSTD_PRECISE_SLEEP == 1)
+
+#include "freertos_clock.h"
+#include "critical_section.h"
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    constexpr std::uint64_t TICK_COUNT{CLOCK_COUNTER_HZ / configTICK_RATE_HZ};
+    constexpr std::uint64_t SPIN_COUNT{ns_to_clock_counter(configSTD_PRECISE_SLEEP_SPIN_NS)};
+
+    static_assert(TICK_COUNT > 0, "Clock counter must be faster than the tick");
+
+    void spin_until(std::uint64_t deadline)
+    {
+      while (clock_counter() < deadline)
+        ;
+    }
+
+#ifdef configSTD_PRECISE_SLEEP_TIMER_ARM
+    // A sleeper lives on the stack of its task. The list is sorted by the
+    // deadline and guarded by a critical section.
+    struct sleeper
+    {
+      std::uint64_t deadline;
+      TaskHandle_t task;
+      sleeper *next;
+      volatile bool expired;
+    };
+
+    sleeper *s_head{nullptr};
+
+    void insert(sleeper &s)
+    {
+      critical_section critical;
+      sleeper **pp = &s_head;
+      while (*pp && (*pp)->deadline <= s.deadline)
+        pp = &(*pp)->next;
+      s.next = *pp;
+      *pp = &s;
+      if (s_head == &s)
+        configSTD_PRECISE_SLEEP_TIMER_ARM(s.deadline);
+    }
+
+    void remove(sleeper &s)
+    {
+      critical_section critical;
+      for (sleeper **pp = &s_head; *pp; pp = &(*pp)->next)
+        if (*pp == &s)
+        {
+          *pp = s.next;
+          break;
+        }
+    }
+
+    void block_until(std::uint64_t deadline)
+    {
+      sleeper s{deadline, xTaskGetCurrentTaskHandle(), nullptr, false};
+      insert(s);
+
+      // The timeout only protects against a timer which never fires. Any
+      // other wakeup (e.g. a notification left by a condition variable)
+      // is ignored.
+      while (!s.expired && clock_counter() < deadline)
+        ulTaskNotifyTake(pdTRUE, 2);
+
+      // Once removed, the timer cannot expire it any more. If it has, it
+      // has given the notification too, which may still be pending when the
+      // loop ended on the clock. It must not be left for the next wait.
+      remove(s);
+      if (s.expired)
+        ulTaskNotifyTake(pdTRUE, 0);
+    }
+#endif
+  }
+
+  void precise_sleep_until(std::uint64_t deadline)
+  {
+    auto now = clock_counter();
+    if (deadline <= now)
+      return;
+
+    // vTaskDelay(n) returns at the n-th tick interrupt from now, that is
+    // after more than n-1 and at most n ticks.
+    auto ticks = (deadline - now) / TICK_COUNT;
+    while (ticks)
+    {
+      auto delay = ticks < portMAX_DELAY ? static_cast<TickType_t>(ticks) : portMAX_DELAY - 1;
+      vTaskDelay(delay);
+      ticks -= delay;
+    }
+
+#ifdef configSTD_PRECISE_SLEEP_TIMER_ARM
+    now = clock_counter();
+    if (deadline > now && deadline - now > SPIN_COUNT)
+      block_until(deadline);
+#endif
+
+    spin_until(deadline);
+  }
+
+  void precise_sleep_for(std::int64_t ns)
+  {
+    if (ns > 0)
+      precise_sleep_until(clock_counter() + ns_to_clock_counter(ns));
+  }
+}
+
+extern "C" void vStdPreciseSleepTimerISR(void)
+{
+#ifdef configSTD_PRECISE_SLEEP_TIMER_ARM
+  using namespace free_rtos_std;
+
+  BaseType_t woken = pdFALSE;
+  auto saved = taskENTER_CRITICAL_FROM_ISR();
+
+  auto now = clock_counter();
+  while (s_head && s_head->deadline <= now)
+  {
+    sleeper *s = s_head;
+    s_head = s->next;
+    TaskHandle_t task = s->task;
+    s->expired = true; // 's' may be gone once the task runs
+    vTaskNotifyGiveFromISR(task, &woken);
+  }
+  if (s_head)
+    configSTD_PRECISE_SLEEP_TIMER_ARM(s_head->deadline);
+
+  taskEXIT_CRITICAL_FROM_ISR(saved);
+  portYIELD_FROM_ISR(woken);
+#endif
+}
+
+#endif // configSTD_PRECISE_SLEEP == 1
@@ -0,0 +1,78 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_PRECISE_SLEEP_H__
+#define FREERTOS_PRECISE_SLEEP_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstdint>
+
+// Sub-tick std::this_thread::sleep_for.
+//
+// With configSTD_PRECISE_SLEEP set to 1 a sleep is split in two parts. The
+// task blocks in vTaskDelay for the whole ticks that surely end before the
+// deadline. The rest, shorter than two ticks, is measured with the clock
+// counter (freertos_clock.h), so configSTD_CLOCK_COUNTER is required.
+//
+// A port with a spare one-shot timer can block for the rest as well. The
+// timer is shared by all sleeping tasks, the library always arms it for the
+// earliest deadline. FreeRTOSConfig.h gives a function programming the timer
+// to fire when the clock counter reaches the value (or at once if it already
+// has):
+// ```
+// void vPreciseSleepTimerArm( unsigned long long ullCount );
+// #define configSTD_PRECISE_SLEEP_TIMER_ARM( ullCount ) vPreciseSleepTimerArm( ullCount )
+// ```
+// and the timer interrupt calls vStdPreciseSleepTimerISR(). Without the
+// timer, and for remainders shorter than configSTD_PRECISE_SLEEP_SPIN_NS,
+// the task spins on the clock counter.
+
+#ifndef configSTD_PRECISE_SLEEP
+#define configSTD_PRECISE_SLEEP 0
+#endif
+
+#if (configSTD_PRECISE_SLEEP == 1)
+
+#ifndef configSTD_CLOCK_COUNTER
+#error "configSTD_PRECISE_SLEEP requires configSTD_CLOCK_COUNTER"
+#endif
+
+// Remainders shorter than this are not worth an interrupt and two context
+// switches.
+#ifndef configSTD_PRECISE_SLEEP_SPIN_NS
+#define configSTD_PRECISE_SLEEP_SPIN_NS 20000
+#endif
+
+namespace free_rtos_std
+{
+  // Sleeps until the clock counter reaches 'deadline'.
+  void precise_sleep_until(std::uint64_t deadline);
+
+  // Sleeps for 'ns' nanoseconds. Nothing happens for ns <= 0.
+  void precise_sleep_for(std::int64_t ns);
+}
+
+extern "C" void vStdPreciseSleepTimerISR(void);
+
+#endif // configSTD_PRECISE_SLEEP == 1
+
+#endif // FREERTOS_PRECISE_SLEEP_H__
@@ -0,0 +1,258 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_SELECT_H__
+#define FREERTOS_SELECT_H__
+
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <stop_token>
+
+#include "freertos_channel.h"
+#include "freertos_timeout.h"
+
+// Waiting for any of several sources at once, on a FreeRTOS queue set.
+//
+// selector<Sources, Events> is a queue set for up to 'Sources' sources.
+// 'Events' is the room of the set: the sum of the lengths of the queues and
+// of the maximum counts of the semaphores added, one for each select_signal
+// and stop token. wait() blocks until one of
+// the sources is ready and returns its index, the order of add() calls.
+//
+// Sources:
+//  - a channel or a kernel queue, ready when it has an element. Each send
+//    posts the queue to the set once, and wait() reports each post once.
+//    The reported element must be received; one that is left is not
+//    reported again, and the next report is for an element already there.
+//  - a kernel semaphore (binary, counting, mutex), ready when it can be
+//    taken. Each give is reported once, the same way: take it after wait()
+//    has reported it. A task blocked in wait() does not lend its priority
+//    to the holder of a mutex, only a task blocked taking it does.
+//  - a select_signal, raised by a task or an ISR. wait() takes it, it is
+//    reported once per raise. It can stand for anything else: event bits
+//    set, a future completed (raise it from a continuation), a job done.
+//  - a std::stop_token, ready once a stop is requested. Reported once.
+//
+// As required by the kernel a source must be empty when it is added, and
+// can be a member of one selector only. The kernel takes only an empty
+// member out of a set: drain the queues and semaphores before the selector
+// is destroyed. An event group cannot be in a queue set, raise a
+// select_signal together with its bits.
+//
+// Requires configUSE_QUEUE_SETS set to 1.
+//
+// Example:
+// ```
+// free_rtos_std::selector<3, 8 + 4 + 1> sel;
+// const auto rx = sel.add(rx_frames);     // channel of 8
+// const auto cmd = sel.add(commands);     // channel of 4
+// const auto stop = sel.add(stop_token);
+//
+// for (;;)
+// {
+//   auto i = sel.wait();
+//   if (i == rx) handle(*rx_frames.try_recv());
+//   else if (i == cmd) execute(*commands.try_recv());
+//   else if (i == stop) break;
+// }
+// ```
+
+#if (configUSE_QUEUE_SETS == 1)
+
+namespace free_rtos_std
+{
+  template <std::size_t Sources, std::size_t Events>
+  class selector;
+
+  // Binary flag a selector can wait for.
+  class select_signal
+  {
+  public:
+    select_signal()
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+      _handle = xSemaphoreCreateBinaryStatic(&_storage);
+#else
+      _handle = xSemaphoreCreateBinary();
+#endif
+      configASSERT(_handle);
+    }
+
+    ~select_signal() { vSemaphoreDelete(_handle); }
+
+    select_signal(const select_signal &) = delete;
+    select_signal &operator=(const select_signal &) = delete;
+
+    // Raising a raised signal does nothing.
+    void raise() { xSemaphoreGive(_handle); }
+    void raise_from_isr(BaseType_t &woken) { xSemaphoreGiveFromISR(_handle, &woken); }
+
+    SemaphoreHandle_t native_handle() const { return _handle; }
+
+  private:
+    SemaphoreHandle_t _handle;
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StaticSemaphore_t _storage;
+#endif
+  };
+
+  template <std::size_t Sources, std::size_t Events>
+  class selector
+  {
+    static_assert(Sources > 0 && Events >= Sources, "Set must have room for each source");
+
+  public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    selector()
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+      _set = xQueueGenericCreateStatic(Events, sizeof(QueueSetMemberHandle_t), _storage, &_queue,
+                                       queueQUEUE_TYPE_SET);
+#else
+      _set = xQueueCreateSet(Events);
+#endif
+      configASSERT(_set);
+    }
+
+    // The members stay, they must be empty.
+    ~selector()
+    {
+      _stop.reset();
+      for (std::size_t i = 0; i < _count; i++)
+      {
+        if (_signal[i])
+          xSemaphoreTake(_members[i], 0);
+        const BaseType_t removed = xQueueRemoveFromSet(_members[i], _set);
+        configASSERT(removed == pdPASS);
+        (void)removed;
+      }
+      vQueueDelete(_set);
+    }
+
+    selector(const selector &) = delete;
+    selector &operator=(const selector &) = delete;
+
+    // Adds a source and returns its index, npos if it cannot be added: the
+    // selector is full, or the source is not empty or in another set.
+    std::size_t add(QueueHandle_t queue_or_semaphore)
+    {
+      if (_count == Sources || xQueueAddToSet(queue_or_semaphore, _set) != pdPASS)
+        return npos;
+      _members[_count] = queue_or_semaphore;
+      _signal[_count] = false;
+      return _count++;
+    }
+
+    template <typename T, std::size_t N>
+    std::size_t add(const channel<T, N> &ch) { return add(ch.native_handle()); }
+
+    std::size_t add(select_signal &s)
+    {
+      const std::size_t i = add(s.native_handle());
+      if (i != npos)
+        _signal[i] = true;
+      return i;
+    }
+
+    // One stop token per selector.
+    std::size_t add(const std::stop_token &st)
+    {
+      if (_stop)
+        return npos;
+      const std::size_t i = add(_stop_signal);
+      if (i != npos)
+        _stop.emplace(st, raise_stop{&_stop_signal}); // runs at once if requested
+      return i;
+    }
+
+    // Index of a ready source.
+    std::size_t wait() { return select(portMAX_DELAY); }
+
+    // Empty on timeout.
+    template <typename Rep, typename Period>
+    std::optional<std::size_t> wait_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return ready(select(block_ticks(rel)));
+    }
+
+    template <typename Clock, typename Duration>
+    std::optional<std::size_t> wait_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return ready(select(block_ticks(abs)));
+    }
+
+    std::optional<std::size_t> try_wait() { return ready(select(0)); }
+
+    QueueSetHandle_t native_handle() const { return _set; }
+
+  private:
+    struct raise_stop
+    {
+      select_signal *signal;
+      void operator()() const { signal->raise(); }
+    };
+
+    static std::optional<std::size_t> ready(std::size_t i)
+    {
+      if (i == npos)
+        return std::nullopt;
+      return i;
+    }
+
+    std::size_t select(TickType_t ticks)
+    {
+      QueueSetMemberHandle_t m = xQueueSelectFromSet(_set, ticks);
+      if (!m)
+        return npos;
+
+      for (std::size_t i = 0; i < _count; i++)
+        if (_members[i] == m)
+        {
+          if (_signal[i])
+            xSemaphoreTake(m, 0);
+          return i;
+        }
+      return npos; // not reached, only members are in the set
+    }
+
+    QueueSetHandle_t _set;
+    QueueSetMemberHandle_t _members[Sources];
+    bool _signal[Sources]; // taken by the selector
+    std::size_t _count{0};
+
+    select_signal _stop_signal;
+    std::optional<std::stop_callback<raise_stop>> _stop;
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StaticQueue_t _queue;
+    std::uint8_t _storage[Events * sizeof(QueueSetMemberHandle_t)];
+#endif
+  };
+}
+
+#endif // configUSE_QUEUE_SETS == 1
+
+#endif // FREERTOS_SELECT_H__
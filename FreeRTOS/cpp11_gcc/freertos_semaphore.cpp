@@ -0,0 +1,97 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_semaphore.h"
+
+#include "critical_section.h"
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    void semaphore_base::release(std::ptrdiff_t update)
+    {
+      critical_section critical;
+      give(update, nullptr);
+    }
+
+    void semaphore_base::release_from_isr(std::ptrdiff_t update, BaseType_t &woken)
+    {
+      isr_critical_section critical;
+      give(update, &woken);
+    }
+
+    // In a critical section. A woken task owns its count already.
+    void semaphore_base::give(std::ptrdiff_t update, BaseType_t *woken)
+    {
+      while (update > 0 && _waiters.wake_one(woken))
+        update--;
+      _count += update;
+    }
+
+    bool semaphore_base::acquire(TickType_t ticks)
+    {
+      wait_queue::waiter w;
+      {
+        critical_section critical;
+        if (_count > 0)
+        {
+          _count--;
+          return true;
+        }
+        if (ticks == 0)
+          return false;
+        _waiters.push(w);
+      }
+      return _waiters.wait(w, ticks);
+    }
+  }
+
+  void latch::count_down(std::ptrdiff_t update)
+  {
+    critical_section critical;
+    arrive(update, nullptr);
+  }
+
+  void latch::count_down_from_isr(std::ptrdiff_t update, BaseType_t &woken)
+  {
+    isr_critical_section critical;
+    arrive(update, &woken);
+  }
+
+  // In a critical section.
+  void latch::arrive(std::ptrdiff_t update, BaseType_t *woken)
+  {
+    if (__atomic_sub_fetch(&_count, update, __ATOMIC_RELEASE) == 0)
+      _waiters.wake_all(woken);
+  }
+
+  void latch::wait() const
+  {
+    internal::wait_queue::waiter w;
+    {
+      critical_section critical;
+      if (try_wait())
+        return;
+      _waiters.push(w);
+    }
+    (void)_waiters.wait(w, portMAX_DELAY);
+  }
+}
@@ -0,0 +1,168 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_SEMAPHORE_H__
+#define FREERTOS_SEMAPHORE_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include "freertos_timeout.h"
+#include "freertos_wait_queue.h"
+
+// Semaphore and latch which can be signalled from an interrupt handler.
+//
+// std::counting_semaphore and std::latch of libstdc++ wait on atomics, which
+// on this port go through a mutex and a condition variable. Neither can be
+// used in an ISR. free_rtos_std::counting_semaphore, binary_semaphore and
+// latch have the interface of the std ones plus release_from_isr and
+// count_down_from_isr. The waiting tasks are queued on their own stacks
+// (freertos_wait_queue.h) and woken with a direct task notification.
+// release hands the count straight to the first waiting task.
+//
+// The _from_isr functions report in 'woken' whether a task of a higher
+// priority has been woken; pass it to portYIELD_FROM_ISR, or call the free
+// functions of the same name which do it. The interrupt priority must allow
+// FreeRTOS API calls (configMAX_SYSCALL_INTERRUPT_PRIORITY).
+//
+// Example:
+// ```
+// free_rtos_std::binary_semaphore rx_done{0};
+//
+// void uart_isr() { free_rtos_std::release_from_isr(rx_done); }
+// void reader() { if (rx_done.try_acquire_for(10ms)) process(); }
+// ```
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    class semaphore_base
+    {
+    public:
+      explicit semaphore_base(std::ptrdiff_t count) : _count{count} {}
+
+      void release(std::ptrdiff_t update);
+      void release_from_isr(std::ptrdiff_t update, BaseType_t &woken);
+
+      // Zero ticks is a try.
+      bool acquire(TickType_t ticks);
+
+    private:
+      void give(std::ptrdiff_t update, BaseType_t *woken);
+
+      std::ptrdiff_t _count;
+      wait_queue _waiters;
+    };
+  }
+
+  template <std::ptrdiff_t LeastMaxValue = std::numeric_limits<std::ptrdiff_t>::max()>
+  class counting_semaphore
+  {
+    static_assert(LeastMaxValue >= 0);
+
+  public:
+    static constexpr std::ptrdiff_t max() noexcept { return LeastMaxValue; }
+
+    explicit counting_semaphore(std::ptrdiff_t desired) : _base{desired} {}
+
+    counting_semaphore(const counting_semaphore &) = delete;
+    counting_semaphore &operator=(const counting_semaphore &) = delete;
+
+    void release(std::ptrdiff_t update = 1) { _base.release(update); }
+
+    void release_from_isr(std::ptrdiff_t update, BaseType_t &woken)
+    {
+      _base.release_from_isr(update, woken);
+    }
+
+    void acquire() { (void)_base.acquire(portMAX_DELAY); }
+    bool try_acquire() noexcept { return _base.acquire(0); }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return _base.acquire(block_ticks(rel));
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_acquire_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return _base.acquire(block_ticks(abs));
+    }
+
+  private:
+    internal::semaphore_base _base;
+  };
+
+  using binary_semaphore = counting_semaphore<1>;
+
+  class latch
+  {
+  public:
+    static constexpr std::ptrdiff_t max() noexcept { return std::numeric_limits<std::ptrdiff_t>::max(); }
+
+    explicit latch(std::ptrdiff_t expected) : _count{expected} {}
+
+    latch(const latch &) = delete;
+    latch &operator=(const latch &) = delete;
+
+    void count_down(std::ptrdiff_t update = 1);
+    void count_down_from_isr(std::ptrdiff_t update, BaseType_t &woken);
+
+    bool try_wait() const noexcept { return __atomic_load_n(&_count, __ATOMIC_ACQUIRE) == 0; }
+    void wait() const;
+
+    void arrive_and_wait(std::ptrdiff_t update = 1)
+    {
+      count_down(update);
+      wait();
+    }
+
+  private:
+    void arrive(std::ptrdiff_t update, BaseType_t *woken);
+
+    std::ptrdiff_t _count;
+    mutable internal::wait_queue _waiters;
+  };
+
+  // In an interrupt handler, the same as the members and a yield to a woken
+  // task of a higher priority than the interrupted one.
+  template <std::ptrdiff_t LeastMaxValue>
+  void release_from_isr(counting_semaphore<LeastMaxValue> &sem, std::ptrdiff_t update = 1)
+  {
+    BaseType_t woken{pdFALSE};
+    sem.release_from_isr(update, woken);
+    portYIELD_FROM_ISR(woken);
+  }
+
+  inline void count_down_from_isr(latch &l, std::ptrdiff_t update = 1)
+  {
+    BaseType_t woken{pdFALSE};
+    l.count_down_from_isr(update, woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+#endif // FREERTOS_SEMAPHORE_H__
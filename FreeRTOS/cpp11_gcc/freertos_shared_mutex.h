@@ -0,0 +1,119 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_SHARED_MUTEX_H__
+#define FREERTOS_SHARED_MUTEX_H__
+
+#include <chrono>
+#include <mutex>
+
+#include "freertos_timeout.h"
+
+// std::shared_mutex and std::shared_timed_mutex on the reader-writer lock of
+// the gthread layer (configSTD_SHARED_MUTEX, see freertos_mutex.h).
+//
+// libstdc++ takes a std::mutex and two condition variables for every shared
+// lock of std::shared_mutex. These take a reader in and out with a single
+// compare and swap while no writer owns or waits for the lock. They are
+// drop-in replacements, std::shared_lock and std::unique_lock work with
+// them.
+//
+// Example:
+// ```
+// free_rtos_std::shared_mutex config_mtx;
+//
+// int read_setting() { std::shared_lock lock{config_mtx}; return config.x; }
+// void write_setting(int x) { std::lock_guard lock{config_mtx}; config.x = x; }
+// ```
+
+#if (configSTD_SHARED_MUTEX == 1)
+
+namespace free_rtos_std
+{
+  class shared_mutex
+  {
+  public:
+    shared_mutex() = default;
+    ~shared_mutex() { __gthread_rwlock_destroy(&_rwlock); }
+
+    shared_mutex(const shared_mutex &) = delete;
+    shared_mutex &operator=(const shared_mutex &) = delete;
+
+    // Exclusive ownership
+
+    void lock() { __gthread_rwlock_wrlock(&_rwlock); }
+    bool try_lock() { return __gthread_rwlock_trywrlock(&_rwlock) == 0; }
+    void unlock() { __gthread_rwlock_unlock(&_rwlock); }
+
+    // Shared ownership
+
+    void lock_shared() { __gthread_rwlock_rdlock(&_rwlock); }
+    bool try_lock_shared() { return __gthread_rwlock_tryrdlock(&_rwlock) == 0; }
+    void unlock_shared() { __gthread_rwlock_unlock(&_rwlock); }
+
+    typedef __gthread_rwlock_t *native_handle_type;
+    native_handle_type native_handle() { return &_rwlock; }
+
+  protected:
+    __gthread_rwlock_t _rwlock = __GTHREAD_RWLOCK_INIT;
+  };
+
+  class shared_timed_mutex : private shared_mutex
+  {
+  public:
+    using shared_mutex::lock;
+    using shared_mutex::try_lock;
+    using shared_mutex::unlock;
+
+    using shared_mutex::lock_shared;
+    using shared_mutex::try_lock_shared;
+    using shared_mutex::unlock_shared;
+
+    // The timeouts go to the lock as ticks. A relative one does not depend
+    // on system_clock, which can be set.
+    template <typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return _rwlock.lock(block_ticks(rel));
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return _rwlock.lock(block_ticks(abs));
+    }
+
+    template <typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period> &rel)
+    {
+      return _rwlock.lock_shared(block_ticks(rel));
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return _rwlock.lock_shared(block_ticks(abs));
+    }
+  };
+}
+
+#endif // configSTD_SHARED_MUTEX == 1
+
+#endif // FREERTOS_SHARED_MUTEX_H__
@@ -0,0 +1,261 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_SPSC_RING_H__
+#define FREERTOS_SPSC_RING_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+#include "freertos_timeout.h"
+
+// Lock-free single-producer single-consumer ring buffer.
+//
+// spsc_ring<T, N> hands data over from one producer (typically an interrupt)
+// to one consumer thread without a kernel object in the data path. The
+// producer only writes the head index, the consumer only writes the tail
+// index. Both live on their own cache line, so the two sides do not share a
+// written line except for the elements themselves.
+//
+// The consumer parks on its task notification (ulTaskNotifyTake) when the
+// ring is empty, and only then. The producer gives the notification only
+// when it finds the consumer parked, that is on the transition from empty to
+// not empty. A burst of N elements costs one wakeup, not N. The consumer
+// takes that notification before it returns, also when it has found the
+// elements without it, so no notification is left for other waits of the task.
+//
+// Push and pop move as many elements as fit, in at most two memcpy-like
+// copies. The number of moved elements is returned.
+//
+// Example:
+// ```
+// free_rtos_std::spsc_ring<char, 64> rx;
+//
+// void uart_isr()
+// {
+//   BaseType_t woken{pdFALSE};
+//   rx.push_from_isr(read_data_register(), woken);
+//   portYIELD_FROM_ISR(woken);
+// }
+//
+// void reader()
+// {
+//   char buf[16];
+//   auto n = rx.wait_pop(buf);
+//   process(buf, n);
+// }
+// ```
+
+// Distance between the producer and the consumer indices.
+#ifndef configSTD_CACHE_LINE_SIZE
+#define configSTD_CACHE_LINE_SIZE 64
+#endif
+
+namespace free_rtos_std
+{
+  template <typename T, std::size_t N>
+  class spsc_ring
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Elements are copied as raw memory");
+    static_assert(N > 1 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+    static_assert(N <= (1UL << 31), "Indices are 32 bit");
+
+    static constexpr std::uint32_t MASK = N - 1;
+
+  public:
+    spsc_ring() = default;
+    spsc_ring(const spsc_ring &) = delete;
+    spsc_ring &operator=(const spsc_ring &) = delete;
+
+    // --- producer side ---
+
+    bool push(const T &v) { return push(std::span<const T>{&v, 1}) == 1; }
+
+    std::size_t push(std::span<const T> in)
+    {
+      auto n = publish(in);
+      if (n && consumer_parked())
+        xTaskNotifyGive(_consumer);
+      return n;
+    }
+
+    bool push_from_isr(const T &v, BaseType_t &woken)
+    {
+      return push_from_isr(std::span<const T>{&v, 1}, woken) == 1;
+    }
+
+    std::size_t push_from_isr(std::span<const T> in, BaseType_t &woken)
+    {
+      auto n = publish(in);
+      if (n && consumer_parked())
+        vTaskNotifyGiveFromISR(_consumer, &woken);
+      return n;
+    }
+
+    // --- consumer side ---
+
+    std::size_t pop(std::span<T> out)
+    {
+      auto tail = _tail.load(std::memory_order_relaxed);
+      auto avail = _headCache - tail;
+      if (avail < out.size())
+      {
+        _headCache = _head.load(std::memory_order_acquire);
+        avail = _headCache - tail;
+      }
+
+      std::size_t n = avail < out.size() ? avail : out.size();
+      copy(out.data(), n, tail);
+      _tail.store(tail + n, std::memory_order_release);
+      return n;
+    }
+
+    std::optional<T> try_pop()
+    {
+      T v;
+      if (pop(std::span<T>{&v, 1}) == 0)
+        return std::nullopt;
+      return v;
+    }
+
+    // Blocks until at least one element is available.
+    std::size_t wait_pop(std::span<T> out) { return wait(out, portMAX_DELAY); }
+
+    // Returns 0 on timeout.
+    template <typename Rep, typename Period>
+    std::size_t wait_pop_for(std::span<T> out, const std::chrono::duration<Rep, Period> &rel)
+    {
+      return wait(out, block_ticks(rel));
+    }
+
+    template <typename Clock, typename Duration>
+    std::size_t wait_pop_until(std::span<T> out, const std::chrono::time_point<Clock, Duration> &abs)
+    {
+      return wait(out, block_ticks(abs));
+    }
+
+    // Exact only when called by one of the two sides.
+    std::size_t size() const
+    {
+      return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr std::size_t capacity() { return N; }
+
+  private:
+    std::size_t publish(std::span<const T> in)
+    {
+      auto head = _head.load(std::memory_order_relaxed);
+      auto room = N - (head - _tailCache);
+      if (room < in.size())
+      {
+        _tailCache = _tail.load(std::memory_order_acquire);
+        room = N - (head - _tailCache);
+      }
+
+      std::size_t n = room < in.size() ? room : in.size();
+      auto first = head & MASK;
+      auto part = N - first < n ? N - first : n;
+      for (std::size_t i = 0; i < part; ++i)
+        _buf[first + i] = in[i];
+      for (std::size_t i = part; i < n; ++i)
+        _buf[i - part] = in[i];
+
+      _head.store(head + n, std::memory_order_release);
+      return n;
+    }
+
+    void copy(T *out, std::size_t n, std::uint32_t tail) const
+    {
+      auto first = tail & MASK;
+      auto part = N - first < n ? N - first : n;
+      for (std::size_t i = 0; i < part; ++i)
+        out[i] = _buf[first + i];
+      for (std::size_t i = part; i < n; ++i)
+        out[i] = _buf[i - part];
+    }
+
+    // Pairs with the fence in wait(): either the producer sees the flag, or
+    // the consumer sees the new head after setting it.
+    bool consumer_parked()
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return _parked.load(std::memory_order_relaxed) &&
+             _parked.exchange(false, std::memory_order_acq_rel);
+    }
+
+    // Ends a park. A producer that has cleared the flag gives the
+    // notification once; it is taken here unless the wait was woken by it.
+    void unpark(bool notified)
+    {
+      if (!_parked.exchange(false, std::memory_order_acq_rel) && !notified)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    std::size_t wait(std::span<T> out, TickType_t ticks)
+    {
+      if (auto n = pop(out); n || out.empty())
+        return n;
+
+      _consumer = xTaskGetCurrentTaskHandle();
+      TimeOut_t timeout;
+      vTaskSetTimeOutState(&timeout);
+      for (;;)
+      {
+        _parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (auto n = pop(out))
+        {
+          unpark(false);
+          return n;
+        }
+
+        if (xTaskCheckForTimeOut(&timeout, &ticks) == pdTRUE)
+          break;
+        unpark(ulTaskNotifyTake(pdTRUE, ticks) != 0);
+      }
+
+      unpark(false);
+      return pop(out);
+    }
+
+    // Producer writes, consumer reads.
+    alignas(configSTD_CACHE_LINE_SIZE) std::atomic<std::uint32_t> _head{0};
+    std::uint32_t _tailCache{0};
+
+    // Consumer writes, producer reads.
+    alignas(configSTD_CACHE_LINE_SIZE) std::atomic<std::uint32_t> _tail{0};
+    std::uint32_t _headCache{0};
+    std::atomic<bool> _parked{false};
+    TaskHandle_t _consumer{nullptr};
+
+    alignas(configSTD_CACHE_LINE_SIZE) T _buf[N];
+  };
+}
+
+#endif // FREERTOS_SPSC_RING_H__
@@ -0,0 +1,168 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_static_alloc.h"
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+
+#include "critical_section.h"
+#include <cstddef>
+#include <exception> // std::terminate
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    struct task_storage
+    {
+      // TCB must be the first member. portCLEAN_UP_TCB gives back the
+      // address of the TCB and it is used to find the slot.
+      StaticTask_t tcb;
+      StackType_t stack[configSTD_THREAD_POOL_STACK_SIZE];
+    };
+  }
+
+  namespace
+  {
+    // Pool of fixed size blocks. It is expected to be small (a few
+    // dozens of slots), so a linear search is good enough.
+    template <typename T, std::size_t N>
+    class static_pool
+    {
+    public:
+      T *allocate()
+      {
+        critical_section critical;
+        for (std::size_t i = 0; i < N; ++i)
+          if (!_used[i])
+          {
+            _used[i] = true;
+            return &_slots[i];
+          }
+        return nullptr;
+      }
+
+      // Returns false if 'p' does not belong to this pool.
+      bool release(const void *p)
+      {
+        critical_section critical;
+        for (std::size_t i = 0; i < N; ++i)
+          if (p == &_slots[i])
+          {
+            _used[i] = false;
+            return true;
+          }
+        return false;
+      }
+
+      // True if a used slot satisfies 'pred'.
+      template <typename Pred>
+      bool any_used(Pred pred)
+      {
+        critical_section critical;
+        for (std::size_t i = 0; i < N; ++i)
+          if (_used[i] && pred(_slots[i]))
+            return true;
+        return false;
+      }
+
+    private:
+      T _slots[N];
+      bool _used[N]{};
+    };
+
+    using internal::task_storage;
+
+    static_pool<task_storage, configSTD_THREAD_POOL_SIZE> s_taskPool;
+    static_pool<StaticEventGroup_t, configSTD_THREAD_POOL_SIZE> s_evPool;
+
+    // A task that has deleted itself keeps its slot until the idle task has
+    // run portCLEAN_UP_TCB for it. The handle of a static task is the address
+    // of its TCB, and the kernel reports a task waiting for the clean up as
+    // deleted.
+    bool cleanup_pending()
+    {
+      if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+        return false;
+      return s_taskPool.any_used([](task_storage &slot) {
+        return eTaskGetState(reinterpret_cast<TaskHandle_t>(&slot.tcb)) == eDeleted;
+      });
+    }
+  }
+
+  namespace internal
+  {
+    task_storage *static_task_reserve(configSTACK_DEPTH_TYPE stackWordCount, bool wait)
+    {
+      if (stackWordCount > configSTD_THREAD_POOL_STACK_SIZE)
+        std::terminate();
+
+      // A thread joined just now may still hold its slot, let the idle task
+      // run until it is given back.
+      auto slot = s_taskPool.allocate();
+      while (!slot)
+      {
+        if (!wait || !cleanup_pending())
+          std::terminate();
+        vTaskDelay(1);
+        slot = s_taskPool.allocate();
+      }
+      return slot;
+    }
+
+    void static_task_release(task_storage *slot)
+    {
+      if (slot)
+        s_taskPool.release(slot);
+    }
+
+    TaskHandle_t static_task_create(task_storage *slot, TaskFunction_t foo, const char *name,
+                                    void *arg, UBaseType_t priority)
+    {
+      // Whole slot is given to the task, not only the requested part.
+      return xTaskCreateStatic(foo, name, configSTD_THREAD_POOL_STACK_SIZE,
+                               arg, priority, slot->stack, &slot->tcb);
+    }
+
+    EventGroupHandle_t static_event_group_create()
+    {
+      auto slot = s_evPool.allocate();
+      if (!slot)
+        std::terminate();
+      return xEventGroupCreateStatic(slot);
+    }
+
+    void static_event_group_delete(EventGroupHandle_t evHandle)
+    {
+      // Statically allocated event group handle is the address of its buffer.
+      vEventGroupDelete(evHandle);
+      s_evPool.release(evHandle);
+    }
+  }
+}
+
+extern "C" void vStdThreadCleanUpTCB(void *pxTCB)
+{
+  // Called by the kernel for every deleted task. Tasks not created by
+  // std::thread (e.g. main) are not in the pool and release ignores them.
+  free_rtos_std::s_taskPool.release(pxTCB);
+}
+
+#endif // configSUPPORT_DYNAMIC_ALLOCATION == 0
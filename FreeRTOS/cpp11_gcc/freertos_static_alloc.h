@@ -0,0 +1,102 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_STATIC_ALLOC_H__
+#define FREERTOS_STATIC_ALLOC_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+// Zero-heap profile.
+//
+// When the kernel is built with configSUPPORT_DYNAMIC_ALLOCATION 0 the library
+// creates every kernel object with the *Static API. Mutexes and once flags
+// keep the kernel storage inside the C++ object. A condition variable has no
+// kernel object, its waiters are queued on their own stacks.
+// Tasks and event groups of std::thread come from fixed pools declared in
+// freertos_static_alloc.cpp, so their size is visible in the map file.
+//
+// The FreeRTOSConfig.h of such a build must route portCLEAN_UP_TCB to
+// vStdThreadCleanUpTCB. That is the point where the kernel has finished with
+// a deleted task and its pool slot can be reused:
+// ```
+// void vStdThreadCleanUpTCB(void *pxTCB);
+// #define portCLEAN_UP_TCB(pxTCB) vStdThreadCleanUpTCB(pxTCB)
+// ```
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+
+#if (configSUPPORT_STATIC_ALLOCATION == 0)
+#error "configSUPPORT_STATIC_ALLOCATION must be 1 when dynamic allocation is disabled"
+#endif
+
+#if (INCLUDE_eTaskGetState == 0) || (INCLUDE_xTaskGetSchedulerState == 0)
+#error "INCLUDE_eTaskGetState and INCLUDE_xTaskGetSchedulerState must be 1, the thread pool waits for the idle task with them"
+#endif
+
+// Maximum number of std::thread tasks alive at the same time. Note that
+// a finished task keeps its slot until the idle task has cleaned it up;
+// a thread created while the pool is full of such tasks waits for that.
+#ifndef configSTD_THREAD_POOL_SIZE
+#define configSTD_THREAD_POOL_SIZE 8
+#endif
+
+// Stack size (in words) of each pool slot. It is the upper limit for
+// attributes::stackWordCount.
+#ifndef configSTD_THREAD_POOL_STACK_SIZE
+#ifdef configDEFAULT_STD_THREAD_STACK_SIZE
+#define configSTD_THREAD_POOL_STACK_SIZE configDEFAULT_STD_THREAD_STACK_SIZE
+#else
+#define configSTD_THREAD_POOL_STACK_SIZE 512U
+#endif
+#endif
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    // A slot of the task pool.
+    struct task_storage;
+
+    // Both functions call std::terminate when the pool is exhausted or
+    // the requested stack does not fit in a slot. With 'wait', a task slot
+    // still held by a deleted task is waited for, a tick at a time, not
+    // counted as exhausted; the call must then be made outside a critical
+    // section.
+    task_storage *static_task_reserve(configSTACK_DEPTH_TYPE stackWordCount, bool wait);
+    EventGroupHandle_t static_event_group_create();
+
+    // Gives back a reserved slot no task has been created in. Null is ignored.
+    void static_task_release(task_storage *slot);
+
+    // Creates the task in a slot taken with static_task_reserve.
+    TaskHandle_t static_task_create(task_storage *slot, TaskFunction_t foo, const char *name,
+                                    void *arg, UBaseType_t priority);
+
+    void static_event_group_delete(EventGroupHandle_t evHandle);
+  }
+}
+
+extern "C" void vStdThreadCleanUpTCB(void *pxTCB);
+
+#endif // configSUPPORT_DYNAMIC_ALLOCATION == 0
+
+#endif // FREERTOS_STATIC_ALLOC_H__
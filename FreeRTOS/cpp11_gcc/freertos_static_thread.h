@@ -0,0 +1,171 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_STATIC_THREAD_H__
+#define FREERTOS_STATIC_THREAD_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+
+#include <algorithm> // std::copy_n
+#include <cstddef>
+#include <cstdint>
+#include <exception> // std::terminate
+#include <new>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "thread_with_attributes.h"
+
+// Threads whose stack, task control block and event group are members of
+// the object. Declared at namespace scope they are placed in .bss, so the
+// memory of the permanent threads of an application shows in the map file
+// and nothing is taken from the heap to start them.
+//
+// start() can be called before vTaskStartScheduler, e.g. from a global
+// constructor or from main() of a bare metal startup, or later from any
+// task. The callable and its arguments are moved to a reserved area at the
+// top of the stack, the rest of the stack is given to the task.
+//
+// A static_thread is started once. join() waits for the thread function to
+// return; the task control block cannot be reused afterwards, since the
+// kernel keeps it until the idle task has cleaned it up. For the same reason
+// the object belongs in static storage: one with automatic storage must not
+// go out of scope before the idle task has run after join(). Calling join()
+// on a thread never started, or destroying a started thread that has not
+// been joined, calls std::terminate, like std::thread. The thread is an
+// ordinary std::thread for the rest of the library: std::this_thread::get_id()
+// in it equals get_id(), thread_local variables and notifications work.
+//
+// Requires configSUPPORT_STATIC_ALLOCATION set to 1.
+//
+// Example:
+// ```
+// constinit free_rtos_std::static_thread<1024, 3, "net"> s_net;
+//
+// int main()
+// {
+//   s_net.start([] { net_loop(); });
+//   vTaskStartScheduler();
+// }
+// ```
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+
+namespace free_rtos_std
+{
+  // Name of a static_thread, a string literal given as a template argument.
+  template <std::size_t N>
+  struct task_name
+  {
+    constexpr task_name(const char (&s)[N]) { std::copy_n(s, N, str); }
+
+    char str[N];
+  };
+
+  namespace internal
+  {
+    inline void static_thread_routine(void *p)
+    {
+      __gthread_t local{*static_cast<__gthread_t *>(p)}; // copy
+      run_thread(local, static_cast<std::thread::_State *>(local.arg()), false);
+    }
+  }
+
+  template <configSTACK_DEPTH_TYPE StackWords, UBaseType_t Priority, task_name Name = "Task">
+  class static_thread
+  {
+  public:
+    constexpr static_thread() = default;
+
+    ~static_thread()
+    {
+      if (_thread.task_handle() && !_joined)
+        std::terminate(); // the task still runs on the members
+    }
+
+    static_thread(const static_thread &) = delete;
+    static_thread &operator=(const static_thread &) = delete;
+
+    // @param f, args - see arguments of std::thread
+    template <typename F, typename... Args>
+    void start(F &&f, Args &&...args)
+    {
+      using Tuple = std::tuple<std::decay_t<F>, std::decay_t<Args>...>;
+      using State = internal::thread_state<Tuple>;
+      static_assert(sizeof(State) + alignof(State) + configMINIMAL_STACK_SIZE * sizeof(StackType_t) <=
+                        StackWords * sizeof(StackType_t),
+                    "The stack has no room for the callable and its arguments");
+
+      if (_thread.task_handle())
+        std::terminate(); // started already
+
+      const auto begin = reinterpret_cast<std::uintptr_t>(_stack);
+      const auto end = reinterpret_cast<std::uintptr_t>(_stack + StackWords);
+#if (portSTACK_GROWTH < 0)
+      // The state at the end of the buffer, the stack grows down below it.
+      const auto at = (end - sizeof(State)) & ~(alignof(State) - 1);
+      StackType_t *stack = _stack;
+      const auto depth = (at - begin) / sizeof(StackType_t);
+#else
+      // The state at the start of the buffer, the stack grows up above it.
+      const auto at = (begin + alignof(State) - 1) & ~(alignof(State) - 1);
+      StackType_t *stack = _stack + (at + sizeof(State) - begin + sizeof(StackType_t) - 1) / sizeof(StackType_t);
+      const auto depth = (end - reinterpret_cast<std::uintptr_t>(stack)) / sizeof(StackType_t);
+#endif
+
+      std::thread::_State *state =
+          ::new (reinterpret_cast<void *>(at)) State{Tuple{std::forward<F>(f), std::forward<Args>(args)...}};
+
+      const attributes attr{.taskName = Name.str,
+                            .stackWordCount = static_cast<configSTACK_DEPTH_TYPE>(depth),
+                            .priority = Priority};
+      _thread.create_thread(internal::static_thread_routine, state, attr, stack, &_tcb, &_ev);
+    }
+
+    // Waits until the thread function has returned.
+    void join()
+    {
+      if (!_thread.task_handle())
+        std::terminate(); // not started, there is no event group to wait on
+      _thread.join();
+      _joined = true;
+    }
+
+    // Same as std::this_thread::get_id() in the thread. Empty if not started.
+    std::thread::id get_id() const { return std::thread::id{_thread}; }
+
+    TaskHandle_t native_handle() const { return _thread.task_handle(); }
+
+  private:
+    StackType_t _stack[StackWords]{};
+    StaticTask_t _tcb{};
+    StaticEventGroup_t _ev{};
+    __gthread_t _thread;
+    bool _joined{false};
+  };
+}
+
+#endif // configSUPPORT_STATIC_ALLOCATION == 1
+
+#endif // FREERTOS_STATIC_THREAD_H__
@@ -0,0 +1,51 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_stop_token.h"
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    void stop_abort::request()
+    {
+      for (;;)
+      {
+        // The task does not run while the scheduler is suspended, it cannot
+        // disarm and block on something else in between.
+        vTaskSuspendAll();
+        const bool armed = __atomic_load_n(&_armed, __ATOMIC_SEQ_CST);
+        const bool aborted = armed && xTaskAbortDelay(_task) == pdPASS;
+        xTaskResumeAll();
+
+        if (!armed || aborted)
+          return;
+
+        // Preempted between arming and blocking, or woken and not disarmed
+        // yet. Let it get there.
+        vTaskDelay(1);
+      }
+    }
+  }
+}
+
+#endif // INCLUDE_xTaskAbortDelay == 1
@@ -0,0 +1,134 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_STOP_TOKEN_H__
+#define FREERTOS_STOP_TOKEN_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <chrono>
+#include <stop_token>
+#include <type_traits>
+
+#include "freertos_timeout.h"
+
+// Blocking calls which a std::stop_token cuts short.
+//
+// A std::jthread asked to stop is often blocked in the kernel: sleeping,
+// receiving from a queue, taking a semaphore. stoppable_block(st, ticks, f)
+// calls f(ticks), one blocking kernel call, with a std::stop_callback
+// registered for the time of it. A stop request takes the task out of the
+// call with xTaskAbortDelay and the call returns as on a timeout. If the stop
+// has been requested before, f is called with zero ticks (a poll).
+//
+// this_thread::sleep_for and sleep_until take a stop token on top of it, as
+// do the receive functions of the channels (freertos_channel.h).
+//
+// The stop callback runs in the task calling request_stop. If the blocked
+// task has been preempted right before blocking, the callback waits for it a
+// tick at a time, so stopping it takes at most one tick longer.
+//
+// Requires INCLUDE_xTaskAbortDelay set to 1.
+//
+// Example:
+// ```
+// std::jthread worker{[](std::stop_token st) {
+//   while (free_rtos_std::this_thread::sleep_for(100ms, st))
+//     poll();
+// }};
+// ```
+
+#if (INCLUDE_xTaskAbortDelay == 1)
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    // Aborts the blocking call of a task, made between arm() and disarm(),
+    // when request() is called by the stop callback.
+    class stop_abort
+    {
+    public:
+      explicit stop_abort(TaskHandle_t task) : _task{task} {}
+
+      void arm() { __atomic_store_n(&_armed, true, __ATOMIC_SEQ_CST); }
+      void disarm() { __atomic_store_n(&_armed, false, __ATOMIC_SEQ_CST); }
+
+      void request();
+
+    private:
+      TaskHandle_t _task;
+      bool _armed{false};
+    };
+  }
+
+  // Calls 'block(ticks)', a single blocking kernel call, and aborts it when
+  // a stop is requested through 'st'. Returns what 'block' does.
+  template <typename Block>
+  auto stoppable_block(const std::stop_token &st, TickType_t ticks, Block &&block)
+  {
+    internal::stop_abort abort{xTaskGetCurrentTaskHandle()};
+    std::stop_callback on_stop{st, [&abort] { abort.request(); }};
+
+    // Armed before the check. A stop requested after it finds the block
+    // armed, see stop_abort::request().
+    abort.arm();
+    if (st.stop_requested())
+      ticks = 0;
+
+    if constexpr (std::is_void_v<decltype(block(ticks))>)
+    {
+      block(ticks);
+      abort.disarm();
+    }
+    else
+    {
+      auto r = block(ticks);
+      abort.disarm();
+      return r;
+    }
+  }
+
+  namespace this_thread
+  {
+    // Sleeps for 'rel' unless a stop is requested. Returns false if it has
+    // been.
+    template <typename Rep, typename Period>
+    bool sleep_for(const std::chrono::duration<Rep, Period> &rel, const std::stop_token &st)
+    {
+      stoppable_block(st, block_ticks(rel), [](TickType_t ticks) {
+        if (ticks)
+          vTaskDelay(ticks);
+      });
+      return !st.stop_requested();
+    }
+
+    template <typename Clock, typename Duration>
+    bool sleep_until(const std::chrono::time_point<Clock, Duration> &abs, const std::stop_token &st)
+    {
+      return sleep_for(abs - Clock::now(), st);
+    }
+  }
+}
+
+#endif // INCLUDE_xTaskAbortDelay == 1
+
+#endif // FREERTOS_STOP_TOKEN_H__
@@ -0,0 +1,153 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_thread_stats.h"
+
+#if (configSTD_THREAD_STATS == 1)
+
+#include "critical_section.h"
+#include <type_traits>
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    using internal::thread_stats_block;
+
+    thread_stats_block *get_block(TaskHandle_t task)
+    {
+      return static_cast<thread_stats_block *>(
+          pvTaskGetThreadLocalStoragePointer(task, configSTD_THREAD_STATS_TLS_INDEX));
+    }
+
+    std::uint64_t now()
+    {
+      return static_cast<std::uint64_t>(configSTD_THREAD_STATS_CLOCK());
+    }
+
+    std::chrono::nanoseconds to_ns(std::uint64_t ticks)
+    {
+      constexpr std::uint64_t hz{configSTD_THREAD_STATS_CLOCK_HZ};
+      // split to avoid overflow of ticks * 1e9
+      return std::chrono::nanoseconds((ticks / hz) * 1'000'000'000ULL +
+                                      ((ticks % hz) * 1'000'000'000ULL) / hz);
+    }
+  }
+
+  std::optional<thread_statistics> thread_stats(std::thread::id id)
+  {
+    // std::thread::id has a single member, the native handle. Standard
+    // layout makes the two pointer-interconvertible.
+    static_assert(std::is_standard_layout_v<std::thread::id>);
+    static_assert(sizeof(std::thread::id) == sizeof(__gthread_t));
+    auto task = reinterpret_cast<const __gthread_t *>(&id)->task_handle();
+    if (!task)
+      return std::nullopt;
+
+    thread_stats_block block;
+    {
+      critical_section critical;
+      if (eDeleted == eTaskGetState(task))
+        return std::nullopt;
+
+      auto b = get_block(task);
+      if (!b)
+        return std::nullopt;
+
+      block = *b;
+      if (task == xTaskGetCurrentTaskHandle())
+        block.cpuTime += now() - block.lastIn; // the running slice
+    }
+
+    thread_statistics stats{};
+    stats.cpuTime = to_ns(block.cpuTime);
+    stats.switches = block.switches;
+    stats.voluntary = block.voluntary;
+    stats.preempted = block.preempted;
+#if (INCLUDE_uxTaskGetStackHighWaterMark == 1)
+    stats.stackHighWaterMark = uxTaskGetStackHighWaterMark(task);
+#endif
+    return stats;
+  }
+
+  namespace internal
+  {
+    void thread_stats_attach(thread_stats_block *block)
+    {
+      critical_section critical;
+      if (block)
+      {
+        *block = thread_stats_block{};
+        block->lastIn = now(); // it is running now
+        block->switches = 1;
+      }
+      vTaskSetThreadLocalStoragePointer(nullptr, configSTD_THREAD_STATS_TLS_INDEX, block);
+    }
+  }
+}
+
+// Both hooks are called by the kernel from the context switch code. They
+// must stay short. The kernel calls them in pairs, even if the same task is
+// selected to run again. Such a pair is not counted as a switch.
+
+namespace
+{
+  TaskHandle_t s_outTask;
+  int s_outStillReady;
+}
+
+extern "C" void vStdThreadStatsSwitchedOut(int xStillReady)
+{
+  s_outTask = xTaskGetCurrentTaskHandle();
+  s_outStillReady = xStillReady;
+
+  auto b = free_rtos_std::get_block(nullptr);
+  if (b)
+    b->cpuTime += free_rtos_std::now() - b->lastIn;
+}
+
+extern "C" void vStdThreadStatsSwitchedIn(void)
+{
+  auto task = xTaskGetCurrentTaskHandle();
+  auto b = free_rtos_std::get_block(task);
+  if (b)
+    b->lastIn = free_rtos_std::now();
+
+  if (task == s_outTask)
+    return; // the same task continues
+
+  if (b)
+    ++b->switches;
+
+  // s_outTask is still valid, a deleted task is freed later by the idle task
+  if (s_outTask)
+  {
+    auto out = free_rtos_std::get_block(s_outTask);
+    if (out)
+    {
+      if (s_outStillReady)
+        ++out->preempted;
+      else
+        ++out->voluntary;
+    }
+  }
+}
+
+#endif // configSTD_THREAD_STATS == 1
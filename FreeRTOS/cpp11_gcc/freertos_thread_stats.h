@@ -0,0 +1,119 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_THREAD_STATS_H__
+#define FREERTOS_THREAD_STATS_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstdint>
+
+// Per std::thread CPU time and context switch counters.
+//
+// With configSTD_THREAD_STATS set to 1 each std::thread keeps an accounting
+// block on its own stack. A pointer to the block is stored in the thread
+// local storage slot configSTD_THREAD_STATS_TLS_INDEX. The kernel trace hooks
+// update the block on every context switch. FreeRTOSConfig.h must route them
+// to this library:
+// ```
+// void vStdThreadStatsSwitchedIn( void );
+// void vStdThreadStatsSwitchedOut( int xStillReady );
+// #define traceTASK_SWITCHED_IN() vStdThreadStatsSwitchedIn()
+// #define traceTASK_SWITCHED_OUT() vStdThreadStatsSwitchedOut( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+// ```
+// The hooks are expanded inside tasks.c. A task switched out while it is
+// still in the ready list has been preempted (or has yielded); otherwise it
+// has blocked.
+//
+// Time is measured with configSTD_THREAD_STATS_CLOCK(), a 64 bit counter
+// running at configSTD_THREAD_STATS_CLOCK_HZ. The default is the clock
+// counter of std::chrono clocks (freertos_clock.h).
+
+#ifndef configSTD_THREAD_STATS
+#define configSTD_THREAD_STATS 0
+#endif
+
+#if (configSTD_THREAD_STATS == 1)
+
+#ifndef configSTD_THREAD_STATS_TLS_INDEX
+#define configSTD_THREAD_STATS_TLS_INDEX 1
+#endif
+
+static_assert(configSTD_THREAD_STATS_TLS_INDEX > 0, "TLS slot 0 is used by std::thread");
+static_assert(configSTD_THREAD_STATS_TLS_INDEX < configNUM_THREAD_LOCAL_STORAGE_POINTERS,
+              "Increase configNUM_THREAD_LOCAL_STORAGE_POINTERS");
+
+#ifndef configSTD_THREAD_STATS_CLOCK
+#include "freertos_clock.h"
+#define configSTD_THREAD_STATS_CLOCK() free_rtos_std::clock_counter()
+#define configSTD_THREAD_STATS_CLOCK_HZ free_rtos_std::CLOCK_COUNTER_HZ
+#endif
+
+#ifndef configSTD_THREAD_STATS_CLOCK_HZ
+#error "configSTD_THREAD_STATS_CLOCK_HZ must be defined together with configSTD_THREAD_STATS_CLOCK"
+#endif
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+namespace free_rtos_std
+{
+  struct thread_statistics
+  {
+    std::chrono::nanoseconds cpuTime;
+    std::uint32_t switches;           // times the thread has been switched in
+    std::uint32_t voluntary;          // switched out because it blocked
+    std::uint32_t preempted;          // switched out while still ready to run
+    std::uint32_t stackHighWaterMark; // minimum free stack so far, in words
+  };
+
+  // Statistics of a running std::thread. Returns nullopt for tasks not
+  // created by std::thread and for threads that have finished.
+  // Note: the thread must not be joined or finished and deleted while the
+  // query is running, the same as for any other use of its handle.
+  std::optional<thread_statistics> thread_stats(std::thread::id id);
+
+  namespace internal
+  {
+    struct thread_stats_block
+    {
+      std::uint64_t cpuTime;
+      std::uint64_t lastIn;
+      std::uint32_t switches;
+      std::uint32_t voluntary;
+      std::uint32_t preempted;
+    };
+
+    // Attach the block to the calling task. nullptr detaches it.
+    void thread_stats_attach(thread_stats_block *block);
+  }
+}
+
+extern "C"
+{
+  void vStdThreadStatsSwitchedIn(void);
+  void vStdThreadStatsSwitchedOut(int xStillReady);
+}
+
+#endif // configSTD_THREAD_STATS == 1
+
+#endif // FREERTOS_THREAD_STATS_H__
@@ -19,6 +19,7 @@
 /// THE SOFTWARE.
 
 #include "freertos_time.h"
+#include "freertos_clock.h"
 #include "critical_section.h"
 #include <sys/time.h>
 #include <chrono>
@@ -28,70 +29,80 @@
 namespace free_rtos_std
 {
 
+// Offset of the wall clock from the steady clock. It is set rarely and read
+// often, so readers do not lock. A sequence number tells them whether the
+// offset has been changed while they were reading it.
 class wall_clock
 {
 public:
-  struct time_data
+  static std::int64_t offset()
   {
-    timeval offset;
-    TickType_t ticks;
-  };
-
-  static time_data time()
-  { //atomic
-    critical_section critical;
-    return time_data{_timeOffset, xTaskGetTickCount()};
+    while (1)
+    {
+      auto seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+      if (seq & 1)
+        continue; // write in progress
+
+      auto offset = _offsetNs;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (seq == __atomic_load_n(&_seq, __ATOMIC_RELAXED))
+        return offset;
+    }
   }
 
-  static void time(const timeval &time)
-  { //atomic
-    critical_section critical;
-    _timeOffset = time;
+  static void offset(std::int64_t ns)
+  {
+    critical_section critical; // single writer
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    _offsetNs = ns;
+    __atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
   }
 
 private:
-  static timeval _timeOffset;
+  static std::uint32_t _seq;
+  static std::int64_t _offsetNs;
 };
 
-timeval wall_clock::_timeOffset;
+std::uint32_t wall_clock::_seq;
+std::int64_t wall_clock::_offsetNs;
+
+static std::int64_t steady_ns()
+{
+  return static_cast<std::int64_t>(clock_counter_to_ns(clock_counter()));
+}
 
 } // namespace free_rtos_std
 
 using namespace std::chrono;
-void SetSystemClockTime(
-    const time_point<system_clock, system_clock::duration> &time)
-{
-  auto delta{time - time_point<system_clock>(
-                        milliseconds(pdTICKS_TO_MS(xTaskGetTickCount())))};
-  long long sec{duration_cast<seconds>(delta).count()};
-  long usec = duration_cast<microseconds>(delta).count() - sec * 1'000'000; //narrowing type
 
-  free_rtos_std::wall_clock::time({sec, usec});
+// Both clocks are normally defined in libstdc++ (chrono.cc) on top of
+// gettimeofday. These definitions replace them and read the clock counter
+// directly (see freertos_clock.h).
+steady_clock::time_point steady_clock::now() noexcept
+{
+  return time_point(duration(free_rtos_std::steady_ns()));
 }
 
-static timeval operator+(const timeval &l, const timeval &r)
+system_clock::time_point system_clock::now() noexcept
 {
-  timeval t{l.tv_sec + r.tv_sec, l.tv_usec + r.tv_usec};
+  return time_point(duration(free_rtos_std::steady_ns() + free_rtos_std::wall_clock::offset()));
+}
 
-  if (t.tv_usec >= 1'000'000)
-  {
-    t.tv_sec++;
-    t.tv_usec -= 1'000'000;
-  }
-  return t;
+void SetSystemClockTime(
+    const time_point<system_clock, system_clock::duration> &time)
+{
+  auto delta{duration_cast<nanoseconds>(time.time_since_epoch()).count() - free_rtos_std::steady_ns()};
+  free_rtos_std::wall_clock::offset(delta);
 }
 
 extern "C" int _gettimeofday(timeval *tv, void *tzvp)
 {
   (void)tzvp;
 
-  auto t{free_rtos_std::wall_clock::time()};
-
-  long long ms{pdTICKS_TO_MS(t.ticks)};
-  long long sec{ms / 1000};
-  long usec = (ms - sec * 1000) * 1000; //narrowing type
-
-  *tv = t.offset + timeval{sec, usec};
+  auto us{duration_cast<microseconds>(system_clock::now().time_since_epoch()).count()};
+  tv->tv_sec = us / 1'000'000;
+  tv->tv_usec = us % 1'000'000;
 
   return 0; // return non-zero for error
 }
@@ -0,0 +1,48 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_TIMEOUT_H__
+#define FREERTOS_TIMEOUT_H__
+
+#include <chrono>
+
+#include "freertos_clock.h"
+
+// Conversion of std::chrono timeouts to the block time of kernel calls.
+// Rounded up to whole ticks plus one for the part of the current tick that
+// has passed, an expired timeout gives zero (poll). The same conversion as
+// timeout_ticks (freertos_clock.h) of the gthread timed waits.
+
+namespace free_rtos_std
+{
+  template <typename Rep, typename Period>
+  TickType_t block_ticks(const std::chrono::duration<Rep, Period> &rel)
+  {
+    return timeout_ticks(std::chrono::duration_cast<std::chrono::nanoseconds>(rel).count());
+  }
+
+  template <typename Clock, typename Duration>
+  TickType_t block_ticks(const std::chrono::time_point<Clock, Duration> &abs)
+  {
+    return block_ticks(abs - Clock::now());
+  }
+}
+
+#endif // FREERTOS_TIMEOUT_H__
@@ -0,0 +1,320 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_timer_service.h"
+#include "thread_with_attributes.h"
+
+#include <algorithm>
+
+namespace free_rtos_std
+{
+  namespace
+  {
+    constexpr std::uint64_t NEVER{UINT64_MAX};
+
+    std::uint64_t rotate_right(std::uint64_t v, unsigned r)
+    {
+      return r ? (v >> r) | (v << (64 - r)) : v;
+    }
+  }
+
+  timer_service::timer_service(std::size_t capacity, const attributes &attr)
+      : _nodes{std::make_unique<node[]>(capacity)}, _capacity{capacity},
+        _wheel{std::make_unique<node *[]>(LEVELS * SLOTS)}
+  {
+    for (std::size_t i = capacity; i--;)
+    {
+      _nodes[i].gen = 1;
+      _nodes[i].next = _free;
+      _free = &_nodes[i];
+    }
+    _now = tick_count64();
+    _nextWake = NEVER;
+    _thread = std_thread(attr, [this] { run(); });
+  }
+
+  timer_service::~timer_service()
+  {
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      _stop = true;
+      if (_task)
+        xTaskNotifyGive(_task);
+    }
+    _thread.join();
+
+    for (std::size_t i = 0; i < _capacity; i++)
+      if (_nodes[i].st != state::free)
+        _nodes[i].destroy(_nodes[i].storage);
+  }
+
+  timer_service::node *timer_service::acquire()
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    node *n = _free;
+    if (n)
+    {
+      _free = n->next;
+      n->st = state::reserved;
+      _pending++;
+    }
+    return n;
+  }
+
+  timer_token timer_service::arm(node *n, std::uint64_t expires, std::uint64_t period)
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    n->expires = expires;
+    n->period = period;
+    n->st = state::armed;
+    insert(n);
+
+    if (expires < _nextWake && _task)
+    {
+      _nextWake = expires;
+      xTaskNotifyGive(_task);
+    }
+    return {static_cast<std::uint32_t>(n - _nodes.get()), n->gen};
+  }
+
+  // Called without the lock, the callable's destructor may take a while.
+  void timer_service::release(node *n)
+  {
+    n->destroy(n->storage);
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    if (++n->gen == 0)
+      n->gen = 1; // 0 marks an invalid token
+    n->st = state::free;
+    n->next = _free;
+    _free = n;
+    _pending--;
+  }
+
+  bool timer_service::cancel(timer_token token)
+  {
+    if (!token.valid() || token._index >= _capacity)
+      return false;
+
+    node *n = &_nodes[token._index];
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      if (n->gen != token._gen)
+        return false;
+
+      switch (n->st)
+      {
+      case state::armed:
+        unlink(n);
+        n->st = state::reserved;
+        break;
+      case state::running:
+        if (!n->period)
+          return false;
+        n->st = state::cancelled; // the service task releases it
+        return true;
+      default:
+        return false;
+      }
+    }
+    release(n);
+    return true;
+  }
+
+  std::size_t timer_service::pending() const
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _pending;
+  }
+
+  void timer_service::insert(node *n)
+  {
+    auto expires = std::max(n->expires, _now);
+    auto delta = expires - _now;
+
+    unsigned level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+      level++;
+
+    // beyond the range of the wheel, it is parked in the last slot
+    constexpr std::uint64_t RANGE{1ULL << (SLOT_BITS * LEVELS)};
+    if (delta >= RANGE)
+      expires = _now + RANGE - 1;
+
+    unsigned slot = (expires >> (SLOT_BITS * level)) & (SLOTS - 1);
+    node **head = &slot_head(level, slot);
+    n->level = static_cast<std::uint8_t>(level);
+    n->slot = static_cast<std::uint8_t>(slot);
+    n->next = *head;
+    n->pprev = head;
+    if (*head)
+      (*head)->pprev = &n->next;
+    *head = n;
+    _bitmap[level] |= 1ULL << slot;
+  }
+
+  void timer_service::unlink(node *n)
+  {
+    *n->pprev = n->next;
+    if (n->next)
+      n->next->pprev = n->pprev;
+    if (!slot_head(n->level, n->slot))
+      _bitmap[n->level] &= ~(1ULL << n->slot);
+  }
+
+  // Processes ticks up to 'to' inclusive. Returns the expired timers linked
+  // by 'next', all in the running state.
+  timer_service::node *timer_service::advance(std::uint64_t to)
+  {
+    node *expired{nullptr};
+    node **tail{&expired};
+
+    while (_now <= to)
+    {
+      // nothing to do in the ticks before
+      auto at = next_event();
+      if (at > to)
+      {
+        _now = to + 1;
+        break;
+      }
+      _now = at;
+
+      // level 0 has wrapped, move the next slot of the levels above down
+      for (unsigned level = 1; level < LEVELS; level++)
+      {
+        if (_now & ((1ULL << (SLOT_BITS * level)) - 1))
+          break;
+
+        unsigned slot = (_now >> (SLOT_BITS * level)) & (SLOTS - 1);
+        node *n = slot_head(level, slot);
+        slot_head(level, slot) = nullptr;
+        _bitmap[level] &= ~(1ULL << slot);
+        while (n)
+        {
+          node *next = n->next;
+          insert(n);
+          n = next;
+        }
+      }
+
+      unsigned slot = _now & (SLOTS - 1);
+      node *n = slot_head(0, slot);
+      slot_head(0, slot) = nullptr;
+      _bitmap[0] &= ~(1ULL << slot);
+      for (; n; n = n->next)
+      {
+        n->st = state::running;
+        *tail = n;
+        tail = &n->next;
+      }
+      *tail = nullptr;
+      _now++;
+    }
+    return expired;
+  }
+
+  // Tick at which the service task has to run next.
+  std::uint64_t timer_service::next_event() const
+  {
+    std::uint64_t next{NEVER};
+    for (unsigned level = 0; level < LEVELS; level++)
+    {
+      if (!_bitmap[level])
+        continue;
+
+      // Level 0 slots expire at their own tick. A slot of a level above is
+      // moved down at the start of its period; the current one already
+      // has been, unless the period starts right now.
+      unsigned shift = SLOT_BITS * level;
+      std::uint64_t period = _now >> shift;
+      if (level && (_now & ((1ULL << shift) - 1)))
+        period++;
+
+      unsigned first = static_cast<unsigned>(period & (SLOTS - 1));
+      unsigned distance = __builtin_ctzll(rotate_right(_bitmap[level], first));
+      std::uint64_t at = level ? (period + distance) << shift : _now + distance;
+      next = std::min(next, at);
+    }
+    return next;
+  }
+
+  void timer_service::run()
+  {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _task = xTaskGetCurrentTaskHandle();
+
+    while (!_stop)
+    {
+      node *expired = advance(tick_count64());
+      lock.unlock();
+
+      for (node *n = expired; n; n = n->next)
+        n->invoke(n->storage);
+
+      lock.lock();
+      node *done{nullptr};
+      for (node *n = expired; n;)
+      {
+        node *next = n->next;
+        if (n->st == state::running && n->period)
+        {
+          // next period in the future, missed ones are skipped
+          n->expires += n->period;
+          if (n->expires < _now)
+            n->expires += ((_now - n->expires + n->period - 1) / n->period) * n->period;
+          n->st = state::armed;
+          insert(n);
+        }
+        else
+        {
+          n->st = state::reserved;
+          n->next = done;
+          done = n;
+        }
+        n = next;
+      }
+
+      if (done)
+      {
+        lock.unlock();
+        while (done)
+        {
+          node *next = done->next;
+          release(done);
+          done = next;
+        }
+        lock.lock();
+      }
+
+      _nextWake = next_event();
+      TickType_t wait{portMAX_DELAY};
+      if (_nextWake != NEVER)
+      {
+        auto now = tick_count64();
+        wait = _nextWake > now ? static_cast<TickType_t>(std::min<std::uint64_t>(_nextWake - now, portMAX_DELAY - 1)) : 0;
+      }
+
+      lock.unlock();
+      ulTaskNotifyTake(pdTRUE, wait);
+      lock.lock();
+    }
+  }
+}
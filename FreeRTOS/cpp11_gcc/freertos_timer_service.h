@@ -0,0 +1,237 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_TIMER_SERVICE_H__
+#define FREERTOS_TIMER_SERVICE_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "freertos_clock.h"
+#include "freertos_thread_attributes.h"
+
+// Software timers run by one task.
+//
+// Timers are kept in a hierarchical timer wheel: configSTD_TIMER_WHEEL_LEVELS
+// levels of 64 slots, each level 64 times coarser than the one below. Level 0
+// has the resolution of one tick. Schedule and cancel are O(1). A timer
+// further away than the last level is parked in its last slot and moved down
+// when that slot comes up. The service task sleeps until the next non-empty
+// slot, it does not wake up every tick.
+//
+// Callables are stored inside the timer slot, there is no heap allocation per
+// timer. A callable must fit in configSTD_TIMER_CALLABLE_SIZE bytes, which is
+// checked at compile time. All slots and the wheel are allocated once, by the
+// constructor.
+//
+// Callables run in the service task, one after another. They should be short
+// and must not block for long, the same as FreeRTOS software timer callbacks.
+//
+// Example:
+// ```
+// free_rtos_std::timer_service timers{64};
+//
+// auto token = timers.schedule_after(10ms, [] { toggle_led(); });
+// timers.schedule_every(100ms, [&] { poll(sensor); });
+// timers.cancel(token);
+// ```
+
+#ifndef configSTD_TIMER_CALLABLE_SIZE
+#define configSTD_TIMER_CALLABLE_SIZE (4 * sizeof(void *))
+#endif
+
+#ifndef configSTD_TIMER_WHEEL_LEVELS
+#define configSTD_TIMER_WHEEL_LEVELS 4
+#endif
+
+namespace free_rtos_std
+{
+  class timer_service;
+
+  // Identifies a scheduled timer. Once a one-shot timer has fired or any
+  // timer has been cancelled the token is stale, cancelling it does nothing.
+  class timer_token
+  {
+  public:
+    timer_token() = default;
+
+    // False for the token returned when no timer slot was free.
+    bool valid() const { return _gen != 0; }
+
+  private:
+    friend class timer_service;
+    timer_token(std::uint32_t index, std::uint32_t gen) : _index{index}, _gen{gen} {}
+
+    std::uint32_t _index{};
+    std::uint32_t _gen{};
+  };
+
+  class timer_service
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    // @param capacity - maximum number of outstanding timers
+    // @param attr     - attributes of the service task
+    explicit timer_service(std::size_t capacity, const attributes &attr = attr_name("timers"));
+
+    // Stops the service task. Timers which have not fired are dropped.
+    ~timer_service();
+
+    timer_service(const timer_service &) = delete;
+    timer_service &operator=(const timer_service &) = delete;
+
+    // Calls 'f' once, not earlier than 'when'. The resolution is one tick.
+    // Returns an invalid token if all slots are in use.
+    template <typename F>
+    timer_token schedule_at(clock::time_point when, F &&f)
+    {
+      return schedule(delay_ticks(when - clock::now()), 0, std::forward<F>(f));
+    }
+
+    template <typename F>
+    timer_token schedule_after(clock::duration delay, F &&f)
+    {
+      return schedule(delay_ticks(delay), 0, std::forward<F>(f));
+    }
+
+    // Calls 'f' every 'period', the first time one period from now. A call
+    // which is late does not shift the following ones; periods missed
+    // altogether are skipped.
+    template <typename F>
+    timer_token schedule_every(clock::duration period, F &&f)
+    {
+      auto ticks = to_ticks(period);
+      if (ticks == 0)
+        ticks = 1;
+      return schedule(ticks, ticks, std::forward<F>(f));
+    }
+
+    // Returns true if the timer will not call its callable anymore. For a
+    // periodic timer whose callable is running right now, the current call
+    // still completes. Returns false for a stale token.
+    bool cancel(timer_token token);
+
+    // Number of scheduled timers.
+    std::size_t pending() const;
+
+    std::size_t capacity() const { return _capacity; }
+
+  private:
+    static constexpr unsigned SLOT_BITS{6};
+    static constexpr unsigned SLOTS{1U << SLOT_BITS};
+    static constexpr unsigned LEVELS{configSTD_TIMER_WHEEL_LEVELS};
+
+    static_assert(LEVELS > 0 && SLOT_BITS * LEVELS < 64, "Invalid configSTD_TIMER_WHEEL_LEVELS");
+
+    enum class state : std::uint8_t
+    {
+      free,
+      reserved, // taken from the free list, not in the wheel
+      armed,    // in the wheel
+      running,  // callable is running
+      cancelled // periodic timer cancelled while running
+    };
+
+    struct node
+    {
+      node *next;
+      node **pprev;
+      std::uint64_t expires; // tick
+      std::uint64_t period;  // ticks, 0 for one-shot
+      std::uint32_t gen;
+      state st;
+      std::uint8_t level;
+      std::uint8_t slot;
+      void (*invoke)(void *);
+      void (*destroy)(void *);
+      alignas(std::max_align_t) unsigned char storage[configSTD_TIMER_CALLABLE_SIZE];
+    };
+
+    template <typename F>
+    timer_token schedule(std::uint64_t delay, std::uint64_t period, F &&f)
+    {
+      using fn_t = std::decay_t<F>;
+      static_assert(sizeof(fn_t) <= configSTD_TIMER_CALLABLE_SIZE,
+                    "Callable too big, increase configSTD_TIMER_CALLABLE_SIZE");
+      static_assert(alignof(fn_t) <= alignof(std::max_align_t), "Callable over-aligned");
+
+      node *n = acquire();
+      if (!n)
+        return {};
+
+      ::new (static_cast<void *>(n->storage)) fn_t(std::forward<F>(f));
+      n->invoke = [](void *p) { (*static_cast<fn_t *>(p))(); };
+      n->destroy = [](void *p) { static_cast<fn_t *>(p)->~fn_t(); };
+      return arm(n, tick_count64() + delay, period);
+    }
+
+    static std::uint64_t to_ticks(clock::duration d)
+    {
+      return ns_to_ticks(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    // The current tick has partly passed, one more makes sure the delay
+    // is not shorter than requested.
+    static std::uint64_t delay_ticks(clock::duration d)
+    {
+      auto ticks = to_ticks(d);
+      return ticks ? ticks + 1 : 0;
+    }
+
+    node *acquire();
+    timer_token arm(node *n, std::uint64_t expires, std::uint64_t period);
+    void release(node *n);
+
+    void insert(node *n);
+    void unlink(node *n);
+    node *&slot_head(unsigned level, unsigned slot) { return _wheel[level * SLOTS + slot]; }
+    node *advance(std::uint64_t to);
+    std::uint64_t next_event() const;
+    void run();
+
+    std::unique_ptr<node[]> _nodes;
+    std::size_t _capacity;
+    node *_free{nullptr};
+    std::size_t _pending{0};
+
+    std::unique_ptr<node *[]> _wheel; // LEVELS x SLOTS list heads
+    std::uint64_t _bitmap[LEVELS]{}; // non-empty slots
+    std::uint64_t _now{0};           // next tick to process
+    std::uint64_t _nextWake{0};
+
+    mutable std::mutex _mutex;
+    TaskHandle_t _task{nullptr};
+    bool _stop{false};
+    std::thread _thread;
+  };
+}
+
+#endif // FREERTOS_TIMER_SERVICE_H__
@@ -0,0 +1,172 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_trace.h"
+
+#if (configSTD_TRACE == 1)
+
+namespace free_rtos_std
+{
+  namespace trace
+  {
+    ring s_rings[CORES];
+    bool s_fEnabled{true};
+
+    namespace
+    {
+      std::size_t available(const ring &r)
+      {
+        auto head = __atomic_load_n(&r.head, __ATOMIC_ACQUIRE);
+        return head < BUFFER_SIZE ? head : BUFFER_SIZE;
+      }
+
+      std::size_t total_available()
+      {
+        std::size_t total{0};
+        for (const auto &r : s_rings)
+          total += available(r);
+        return total;
+      }
+
+      // Visit the records of all cores in the time order, skipping the
+      // first 'skip' ones.
+      template <typename F>
+      void for_each_record(std::size_t skip, F &&fn)
+      {
+        std::uint32_t pos[CORES];
+        std::uint32_t end[CORES];
+        for (std::size_t c = 0; c < CORES; ++c)
+        {
+          end[c] = __atomic_load_n(&s_rings[c].head, __ATOMIC_ACQUIRE);
+          pos[c] = end[c] - available(s_rings[c]);
+        }
+
+        while (1)
+        {
+          // pick the core with the oldest pending record
+          const record *next{nullptr};
+          std::size_t nextCore{0};
+          for (std::size_t c = 0; c < CORES; ++c)
+          {
+            if (pos[c] == end[c])
+              continue;
+            const auto &rec = s_rings[c].buffer[pos[c] & (BUFFER_SIZE - 1)];
+            if (!next || static_cast<std::int32_t>(rec.timestamp - next->timestamp) < 0)
+            {
+              next = &rec;
+              nextCore = c;
+            }
+          }
+
+          if (!next)
+            return;
+          ++pos[nextCore];
+
+          if (skip)
+            --skip;
+          else
+            fn(*next);
+        }
+      }
+
+      // "<hex> " appended to 'p'
+      char *put_hex(char *p, std::uint32_t v)
+      {
+        for (int shift = 28; shift >= 0; shift -= 4)
+          *p++ = "0123456789abcdef"[(v >> shift) & 0xFU];
+        *p++ = ' ';
+        return p;
+      }
+    }
+
+    void enable(bool fEnable)
+    {
+      __atomic_store_n(&s_fEnabled, fEnable, __ATOMIC_RELAXED);
+    }
+
+    void clear()
+    {
+      for (auto &r : s_rings)
+        __atomic_store_n(&r.head, 0, __ATOMIC_RELAXED);
+    }
+
+    std::size_t snapshot(record *out, std::size_t maxCount)
+    {
+      const auto total = total_available();
+      const auto skip = total > maxCount ? total - maxCount : 0;
+
+      std::size_t count{0};
+      for_each_record(skip, [&](const record &rec) {
+        if (count < maxCount)
+          out[count++] = rec;
+      });
+      return count;
+    }
+
+    void export_binary(void (*write)(const void *data, std::size_t size))
+    {
+      const file_header header{FILE_MAGIC, FILE_VERSION, sizeof(record),
+                               static_cast<std::uint32_t>(configSTD_TRACE_CLOCK_HZ),
+                               static_cast<std::uint32_t>(total_available())};
+      write(&header, sizeof(header));
+
+      std::uint32_t count{0};
+      for_each_record(0, [&](const record &rec) {
+        // the header tells how many records follow
+        if (count++ < header.count)
+          write(&rec, sizeof(rec));
+      });
+    }
+
+    void export_text(void (*write)(const char *line))
+    {
+      char line[64];
+      char *p = line;
+      const char begin[] = "TRACE_BEGIN ";
+      for (auto c : begin)
+        if (c)
+          *p++ = c;
+      p = put_hex(p, FILE_VERSION);
+      p = put_hex(p, static_cast<std::uint32_t>(configSTD_TRACE_CLOCK_HZ));
+      p[-1] = '\n';
+      *p = '\0';
+      write(line);
+
+      for_each_record(0, [&](const record &rec) {
+        char *p = line;
+        *p++ = 'T';
+        *p++ = 'R';
+        *p++ = ' ';
+        p = put_hex(p, rec.core);
+        p = put_hex(p, rec.timestamp);
+        p = put_hex(p, rec.task);
+        p = put_hex(p, rec.type);
+        p = put_hex(p, rec.object);
+        p[-1] = '\n';
+        *p = '\0';
+        write(line);
+      });
+
+      write("TRACE_END\n");
+    }
+  }
+}
+
+#endif // configSTD_TRACE == 1
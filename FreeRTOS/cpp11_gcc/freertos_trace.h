@@ -0,0 +1,191 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_TRACE_H__
+#define FREERTOS_TRACE_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Event trace of the gthread layer.
+//
+// With configSTD_TRACE set to 1, thread, mutex, condition variable, once and
+// thread specific key operations are written as 16 byte records to a ring
+// buffer in RAM, one ring per core. Writing is lock free: a slot is reserved
+// with an atomic increment and filled in place, so recording stays cheap
+// enough for load tests. When the ring is full the oldest records are
+// overwritten.
+//
+// After the run the buffer is exported with export_binary (e.g. to a file
+// over semihosting) or export_text (e.g. to a UART console). The script
+// tools/trace2perfetto.py converts both formats to the Chrome trace JSON
+// accepted by Perfetto and chrome://tracing.
+//
+// Timestamps are taken with configSTD_TRACE_CLOCK(), which ticks at
+// configSTD_TRACE_CLOCK_HZ. The default is the lower half of the clock
+// counter of std::chrono clocks (freertos_clock.h). The converter extends
+// it back to 64 bits, as long as consecutive events are closer than one
+// wrap of the counter.
+
+#ifndef configSTD_TRACE
+#define configSTD_TRACE 0
+#endif
+
+#if (configSTD_TRACE == 1)
+// Number of records in each ring, power of 2.
+#ifndef configSTD_TRACE_BUFFER_SIZE
+#define configSTD_TRACE_BUFFER_SIZE 1024
+#endif
+
+#ifndef configSTD_TRACE_CLOCK
+#include "freertos_clock.h"
+#define configSTD_TRACE_CLOCK() free_rtos_std::clock_counter()
+#define configSTD_TRACE_CLOCK_HZ free_rtos_std::CLOCK_COUNTER_HZ
+#endif
+
+#ifndef configSTD_TRACE_CLOCK_HZ
+#error "configSTD_TRACE_CLOCK_HZ must be defined together with configSTD_TRACE_CLOCK"
+#endif
+#endif // configSTD_TRACE == 1
+
+namespace free_rtos_std
+{
+  namespace trace
+  {
+    // Do not reorder, the values are part of the export format.
+    enum class event : std::uint8_t
+    {
+      thread_create = 1, // object - created task
+      thread_start,      // object - started task
+      thread_exit,       // object - finished task
+      thread_join,       // object - joined task, recorded after join returned
+      thread_detach,     // object - detached task
+      mutex_take,        // object - mutex handle
+      mutex_give,        // object - mutex handle
+      cv_wait,           // object - condition variable
+      cv_wake,           // object - condition variable, wait has returned
+      cv_signal,         // object - condition variable
+      cv_broadcast,      // object - condition variable
+      once,              // object - once flag
+      key_set,           // object - key
+    };
+
+    struct record
+    {
+      std::uint32_t timestamp;
+      std::uint32_t task;
+      std::uint32_t object;
+      std::uint8_t type; // event
+      std::uint8_t core;
+      std::uint16_t reserved;
+    };
+    static_assert(sizeof(record) == 16, "Record size is part of the export format");
+
+    // Binary export starts with this header, followed by 'count' records,
+    // the oldest first. Little endian, as the targets are.
+    struct file_header
+    {
+      std::uint32_t magic; // 'FRTR'
+      std::uint16_t version;
+      std::uint16_t recordSize;
+      std::uint32_t clockHz;
+      std::uint32_t count;
+    };
+
+    constexpr std::uint32_t FILE_MAGIC{0x52545246U};
+    constexpr std::uint16_t FILE_VERSION{1};
+
+#if (configSTD_TRACE == 1)
+    constexpr std::size_t BUFFER_SIZE{configSTD_TRACE_BUFFER_SIZE};
+    static_assert((BUFFER_SIZE & (BUFFER_SIZE - 1)) == 0, "Trace buffer size must be a power of 2");
+
+#ifndef configNUMBER_OF_CORES
+    constexpr std::size_t CORES{1};
+#else
+    constexpr std::size_t CORES{configNUMBER_OF_CORES};
+#endif
+
+    // Note: this header is included by gthr-default.h, which is included
+    // by <atomic>. For that reason GCC __atomic builtins are used directly.
+    struct ring
+    {
+      std::uint32_t head; // number of records ever written
+      record buffer[BUFFER_SIZE];
+    };
+
+    extern ring s_rings[CORES];
+    extern bool s_fEnabled;
+
+    inline std::uint8_t core_id()
+    {
+#ifdef portGET_CORE_ID
+      return static_cast<std::uint8_t>(portGET_CORE_ID());
+#else
+      return 0;
+#endif
+    }
+
+    inline void record_event(event e, const void *object)
+    {
+      if (!__atomic_load_n(&s_fEnabled, __ATOMIC_RELAXED))
+        return;
+
+      const auto core = core_id();
+      auto &r = s_rings[core];
+      auto idx = __atomic_fetch_add(&r.head, 1, __ATOMIC_RELAXED);
+      auto &rec = r.buffer[idx & (BUFFER_SIZE - 1)];
+      rec.timestamp = static_cast<std::uint32_t>(configSTD_TRACE_CLOCK());
+      rec.task = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(xTaskGetCurrentTaskHandle()));
+      rec.object = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(object));
+      rec.type = static_cast<std::uint8_t>(e);
+      rec.core = core;
+    }
+
+    // Recording is enabled by default.
+    void enable(bool fEnable);
+    // Drop all records.
+    void clear();
+
+    // Copy up to 'maxCount' most recent records, the oldest first.
+    // Returns the number of copied records. Records of all cores are
+    // merged by the timestamp.
+    std::size_t snapshot(record *out, std::size_t maxCount);
+
+    // Export functions should be called when recording is disabled,
+    // otherwise new records may overwrite the ones being exported.
+    //
+    // Binary: file_header and the records.
+    void export_binary(void (*write)(const void *data, std::size_t size));
+    // Text: one line per record, easy to capture from a console. All
+    // numbers are hex:
+    //   TRACE_BEGIN <version> <clock_hz>
+    //   TR <core> <timestamp> <task> <event> <object>
+    //   TRACE_END
+    void export_text(void (*write)(const char *line));
+#else
+    inline void record_event(event, const void *) {}
+#endif
+  }
+}
+
+#endif // FREERTOS_TRACE_H__
@@ -0,0 +1,121 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "freertos_wait_queue.h"
+
+#include "critical_section.h"
+#include "freertos_stop_token.h"
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    namespace
+    {
+      // The waiter may return as soon as it sees 'notified', take the task
+      // first.
+      void notify(wait_queue::waiter &w, BaseType_t *woken)
+      {
+        const TaskHandle_t task = w.task;
+        __atomic_store_n(&w.notified, true, __ATOMIC_RELEASE);
+        if (woken)
+        {
+          vTaskNotifyGiveFromISR(task, woken);
+        }
+        else
+          xTaskNotifyGive(task);
+      }
+    }
+
+    void wait_queue::push(waiter &w)
+    {
+      w.prev = _tail;
+      if (_tail)
+        _tail->next = &w;
+      else
+        _head = &w;
+      _tail = &w;
+    }
+
+    bool wait_queue::wake_one(BaseType_t *woken)
+    {
+      if (!_head)
+        return false;
+
+      waiter &w = *_head;
+      unlink(w);
+      notify(w, woken);
+      return true;
+    }
+
+    void wait_queue::wake_all(BaseType_t *woken)
+    {
+      waiter *w = _head;
+      _head = _tail = nullptr;
+      while (w)
+      {
+        waiter *next = w->next;
+        notify(*w, woken);
+        w = next;
+      }
+    }
+
+    void wait_queue::unlink(waiter &w)
+    {
+      (w.prev ? w.prev->next : _head) = w.next;
+      (w.next ? w.next->prev : _tail) = w.prev;
+    }
+
+    bool wait_queue::wait(waiter &w, TickType_t ticks, const std::stop_token *st)
+    {
+      TimeOut_t timeout;
+      vTaskSetTimeOutState(&timeout);
+      for (;;)
+      {
+#if (INCLUDE_xTaskAbortDelay == 1)
+        if (st)
+          stoppable_block(*st, ticks, [](TickType_t t) { return ulTaskNotifyTake(pdTRUE, t); });
+        else
+#endif
+          ulTaskNotifyTake(pdTRUE, ticks);
+
+        if (__atomic_load_n(&w.notified, __ATOMIC_ACQUIRE))
+          return true;
+
+        const bool stopped = st && st->stop_requested();
+        if (!stopped && xTaskCheckForTimeOut(&timeout, &ticks) == pdFALSE)
+          continue; // woken by another notification
+
+        {
+          critical_section critical;
+          if (!w.notified)
+          {
+            unlink(w);
+            return false;
+          }
+        }
+
+        // Woken in the meantime. The notification is still pending.
+        ulTaskNotifyTake(pdTRUE, 0);
+        return true;
+      }
+    }
+  }
+}
@@ -0,0 +1,86 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef FREERTOS_WAIT_QUEUE_H__
+#define FREERTOS_WAIT_QUEUE_H__
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <bits/c++config.h>
+
+// Not <stop_token>: it includes the gthread header, which includes this one
+// for std::condition_variable.
+namespace std _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+  class stop_token;
+_GLIBCXX_END_NAMESPACE_VERSION
+}
+
+// Tasks blocked on a synchronisation object, for the internal use of the
+// library (std::condition_variable, condition_variable_any,
+// counting_semaphore, latch).
+//
+// A waiter is a node on the stack of the waiting task. The queue is changed
+// only in critical sections, of a task or of an interrupt handler, so the
+// owner can be signalled from an ISR. The task is woken with a direct task
+// notification (index 0) and runs first in first out.
+
+namespace free_rtos_std
+{
+  namespace internal
+  {
+    class wait_queue
+    {
+    public:
+      struct waiter
+      {
+        waiter *next{};
+        waiter *prev{};
+        TaskHandle_t task{xTaskGetCurrentTaskHandle()};
+        bool notified{false};
+      };
+
+      // push, empty, wake_one and wake_all are called in a critical
+      // section, together with the state of the owner.
+      void push(waiter &w);
+      bool empty() const { return !_head; }
+
+      // Unlinks the first waiter and notifies its task. 'woken' is null in a
+      // task. In an ISR it is set if a task of a higher priority is woken.
+      bool wake_one(BaseType_t *woken);
+      void wake_all(BaseType_t *woken);
+
+      // Blocks the task of 'w', pushed before, up to 'ticks' until it is
+      // woken. Returns false on timeout, or a stop requested through 'st',
+      // 'w' is unlinked then. Called outside a critical section.
+      bool wait(waiter &w, TickType_t ticks, const std::stop_token *st = nullptr);
+
+    private:
+      void unlink(waiter &w);
+
+      waiter *_head{};
+      waiter *_tail{};
+    };
+  }
+}
+
+#endif // FREERTOS_WAIT_QUEUE_H__
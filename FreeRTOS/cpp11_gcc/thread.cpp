@@ -19,7 +19,6 @@
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 /// THE SOFTWARE.
 
-#define _GLIBCXX_THREAD_IMPL 1
 #include <thread>
 #include <system_error>
 #include <cerrno>
@@ -27,12 +26,47 @@
 
 #include "gthr_key_type.h"
 #include "freertos_thread_attributes.h"
+#include "freertos_thread_stats.h"
+#include "freertos_clock.h"
+#include "freertos_log.h"
+#include "freertos_precise_sleep.h"
+#include "thread_with_attributes.h"
 
 namespace free_rtos_std
 {
   extern Key *s_key;
 
   const attributes *internal::attributes_lock::_attrib{&internal::attributes_lock::_default};
+  internal::attributes_lock *internal::attributes_lock::_lock{nullptr};
+
+  void internal::run_thread(__gthread_t &local, std::thread::_State *state, bool heap)
+  {
+#if (configSTD_THREAD_STATS == 1)
+    // lives as long as the thread function runs
+    internal::thread_stats_block stats;
+    internal::thread_stats_attach(&stats);
+#endif
+
+    local.notify_started(); // state has been taken over; tell we are running
+    state->_M_run();
+    if (heap)
+      delete state;
+    else
+      state->~_State(); // on the stack of this task
+
+    if (s_key)
+      s_key->CallDestructor(__gthread_t::self().native_task_handle());
+
+#if (configSTD_LOG == 1)
+    log::internal::thread_exit();
+#endif
+
+#if (configSTD_THREAD_STATS == 1)
+    internal::thread_stats_attach(nullptr);
+#endif
+
+    local.notify_joined(); // finished; release joined threads
+  }
 } // namespace free_rtos_std
 
 namespace std
@@ -42,16 +76,8 @@ namespace std
   {
     __gthread_t local{*static_cast<__gthread_t *>(__p)}; // copy
 
-    { // we own the arg now; it must be deleted after run() returns
-      thread::_State_ptr __t{static_cast<thread::_State *>(local.arg())};
-      local.notify_started(); // copy has been made; tell we are running
-      __t->_M_run();
-    }
-
-    if (free_rtos_std::s_key)
-      free_rtos_std::s_key->CallDestructor(__gthread_t::self().native_task_handle());
-
-    local.notify_joined(); // finished; release joined threads
+    // we own the arg now; it must be deleted after run() returns
+    free_rtos_std::internal::run_thread(local, static_cast<thread::_State *>(local.arg()), true);
   }
 
   thread::_State::~_State() = default;
@@ -104,11 +130,19 @@ namespace std
 
   void this_thread::__sleep_for(chrono::seconds sec, chrono::nanoseconds nsec)
   {
-    long ms = nsec.count() / 1'000'000;
-    if (sec.count() == 0 && ms == 0 && nsec.count() > 0)
-      ms = 1; // round up to 1 ms => if sleep time != 0, sleep at least 1ms
-
-    vTaskDelay(pdMS_TO_TICKS(chrono::milliseconds(sec).count() + ms));
+#if (configSTD_PRECISE_SLEEP == 1)
+    free_rtos_std::precise_sleep_for(chrono::nanoseconds(sec).count() + nsec.count());
+#else
+    // Rounded up to whole ticks => if sleep time != 0, sleep at least 1 tick.
+    // Computed in 64 bits, pdMS_TO_TICKS overflows for sleeps over ~71 min.
+    auto ticks = free_rtos_std::ns_to_ticks(chrono::nanoseconds(sec).count() + nsec.count());
+    while (ticks)
+    {
+      auto delay = ticks < portMAX_DELAY ? static_cast<TickType_t>(ticks) : portMAX_DELAY - 1;
+      vTaskDelay(delay);
+      ticks -= delay;
+    }
+#endif
   }
 
 } // namespace std
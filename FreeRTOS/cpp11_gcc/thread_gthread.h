@@ -27,7 +27,10 @@
 #include "event_groups.h"
 #include "critical_section.h"
 #include "freertos_thread_attributes.h"
+#include "freertos_static_alloc.h"
+#include "freertos_trace.h"
 
+#include <cstddef>   // std::nullptr_t
 #include <utility>   // std::forward
 #include <exception> // std::terminate
 
@@ -44,9 +47,85 @@ namespace free_rtos_std
 {
   namespace internal
   {
+    // Kernel object factories. With configSUPPORT_DYNAMIC_ALLOCATION 0
+    // the objects are taken from the static pools (freertos_static_alloc.h).
+    inline EventGroupHandle_t event_group_create()
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+      return static_event_group_create();
+#else
+      return xEventGroupCreate();
+#endif
+    }
+
+    inline void event_group_delete(EventGroupHandle_t evHandle)
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+      static_event_group_delete(evHandle);
+#else
+      vEventGroupDelete(evHandle);
+#endif
+    }
+
+    // Memory of a task, taken before the critical section in which the task
+    // is created. Taking a slot of the pool may wait for the idle task, with
+    // 'wait' set, see static_task_reserve. With the heap there is nothing to
+    // reserve, xTaskCreate allocates the task.
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    using task_slot = task_storage *;
+#else
+    using task_slot = std::nullptr_t;
+#endif
+
+    inline task_slot task_reserve(const attributes &attr, bool wait)
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+      return static_task_reserve(attr.stackWordCount, wait);
+#else
+      (void)attr;
+      (void)wait;
+      return nullptr;
+#endif
+    }
+
+    // Gives back a slot no task has been created in.
+    inline void task_release(task_slot slot)
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+      static_task_release(slot);
+#else
+      (void)slot;
+#endif
+    }
+
+    inline TaskHandle_t task_create(task_slot slot, TaskFunction_t foo, const attributes &attr, void *arg)
+    {
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+      return static_task_create(slot, foo, attr.taskName, arg, attr.priority);
+#else
+      (void)slot;
+      TaskHandle_t taskHandle{nullptr};
+      xTaskCreate(foo, attr.taskName, attr.stackWordCount, arg, attr.priority, &taskHandle);
+      return taskHandle;
+#endif
+    }
+
+    // The task of the thread created under attributes_lock, reserved before
+    // the lock enters its critical section. Given back if no thread takes it.
+    struct attributes_reservation
+    {
+      explicit attributes_reservation(const attributes &attrib) : _slot{task_reserve(attrib, true)} {}
+      ~attributes_reservation() { task_release(_slot); }
+
+      attributes_reservation(const attributes_reservation &) = delete;
+      attributes_reservation &operator=(const attributes_reservation &) = delete;
+
+      task_slot _slot;
+    };
+
     // Derive from the cticical_section. As long as an instance of attributes_lock exists
     // it is safe to create a thread with custom attributes.
-    struct attributes_lock : critical_section
+    struct attributes_lock : attributes_reservation, critical_section
     {
       // Note - attributes_lock should not be used by the end user. Helper API is
       // provided in 'thread_with_attributes.h'. That header should be included by the
@@ -87,10 +166,35 @@ namespace free_rtos_std
       // `attributes_lock` instance is destroyed, so the scheduler is
       // running again, but the thread has already been created.
       //
-      attributes_lock(const attributes &attrib) { _attrib = &attrib; }
-      ~attributes_lock() { _attrib = &_default; }
+      attributes_lock(const attributes &attrib) : attributes_reservation{attrib}
+      {
+        _attrib = &attrib;
+        _lock = this;
+      }
+      ~attributes_lock()
+      {
+        _attrib = &_default;
+        _lock = nullptr;
+      }
+
+      // The task of a thread with the attributes 'attrib', or those of the
+      // lock if null. Called by create_thread before its critical section.
+      // Under the lock, the slot it has reserved is taken; a second thread
+      // under the same lock cannot wait for a slot, it is in the critical
+      // section of the lock.
+      static task_slot reserve(const attributes *attrib)
+      {
+        if (attrib)
+          return task_reserve(*attrib, true);
+        if (!_lock)
+          return task_reserve(_default, true);
+        auto slot = _lock->_slot;
+        _lock->_slot = task_slot{};
+        return slot ? slot : task_reserve(*_attrib, false);
+      }
 
       static const attributes *_attrib;
+      static attributes_lock *_lock;
 
     private:
       static constexpr attributes _default{};
@@ -168,18 +272,27 @@ namespace free_rtos_std
     }
 
     bool create_thread(task_foo foo, void *arg)
+    {
+      return create_thread(foo, arg, nullptr);
+    }
+
+    // Task with the given attributes, or those of attributes_lock if null.
+    bool create_thread(task_foo foo, void *arg, const attributes *attrib)
     {
       _arg = arg;
 
-      _evHandle = xEventGroupCreate();
+      _evHandle = internal::event_group_create();
       if (!_evHandle)
         std::terminate();
 
+      // Reserved outside the critical section, it may wait for a slot.
+      const internal::task_slot slot = internal::attributes_lock::reserve(attrib);
+
       {
         critical_section critical;
 
-        const auto &attr = *internal::attributes_lock::_attrib;
-        xTaskCreate(foo, attr.taskName, attr.stackWordCount, this, attr.priority, &_taskHandle);
+        const auto &attr = attrib ? *attrib : *internal::attributes_lock::_attrib;
+        _taskHandle = internal::task_create(slot, foo, attr, this);
         if (!_taskHandle)
           std::terminate();
 
@@ -187,8 +300,33 @@ namespace free_rtos_std
         _fOwner = true;
       }
 
+      trace::record_event(trace::event::thread_create, _taskHandle);
+
+      return true;
+    }
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    // Task and event group in the storage given by static_thread.
+    bool create_thread(task_foo foo, void *arg, const attributes &attr,
+                       StackType_t *stack, StaticTask_t *tcb, StaticEventGroup_t *ev)
+    {
+      _arg = arg;
+      _evHandle = xEventGroupCreateStatic(ev);
+
+      {
+        critical_section critical;
+
+        _taskHandle = xTaskCreateStatic(foo, attr.taskName, attr.stackWordCount, this,
+                                        attr.priority, stack, tcb);
+        vTaskSetThreadLocalStoragePointer(_taskHandle, eEvStoragePos, _evHandle);
+        _fOwner = true;
+      }
+
+      trace::record_event(trace::event::thread_create, _taskHandle);
+
       return true;
     }
+#endif
 
     void join()
     { // note 1: _evHandle must be valid here. Even if the native thread function
@@ -210,12 +348,14 @@ namespace free_rtos_std
                                       pdTRUE,
                                       portMAX_DELAY))
         ;
+      trace::record_event(trace::event::thread_join, _taskHandle);
     }
 
     void detach()
     { // Detaching is removing the event's object. It can be done
       // only if the thread has started execution.
       wait_for_start();
+      trace::record_event(trace::event::thread_detach, _taskHandle);
 
       { // unfortunately critical section is needed here to make sure
         // the task is not deleted while accessing the task's local storage.
@@ -224,7 +364,7 @@ namespace free_rtos_std
         if (eDeleted != eTaskGetState(_taskHandle))
         {
           vTaskSetThreadLocalStoragePointer(_taskHandle, eEvStoragePos, nullptr);
-          vEventGroupDelete(_evHandle);
+          internal::event_group_delete(_evHandle);
 
           // Thread still exists but detach removes ownership.
           // Ownership belongs to the native thread. It will release the task
@@ -238,12 +378,14 @@ namespace free_rtos_std
     { // Function should be called only from the controlled task
       // and only when the (internal, not application's one) thread function
       // has started execution.
+      trace::record_event(trace::event::thread_start, _taskHandle);
       xEventGroupSetBits(_evHandle, eStartedEv);
     }
 
     void notify_joined()
     { // Function should be called only from the controlled task
       // and only when the thread function has finished execution.
+      trace::record_event(trace::event::thread_exit, _taskHandle);
       {
         critical_section critical;
 
@@ -280,6 +422,12 @@ namespace free_rtos_std
       return xTaskGetCurrentTaskHandle();
     }
 
+    // Handle of the task this object refers to.
+    constexpr native_task_type task_handle() const
+    {
+      return _taskHandle;
+    }
+
     constexpr friend bool operator==(const gthr_freertos &l, const gthr_freertos &r) noexcept
     {
       return l._taskHandle == r._taskHandle;
@@ -330,7 +478,7 @@ namespace free_rtos_std
         if (eDeleted != eTaskGetState(_taskHandle))
           vTaskDelete(_taskHandle);
         if (_evHandle)
-          vEventGroupDelete(_evHandle);
+          internal::event_group_delete(_evHandle);
         _fOwner = false;
       }
       else if (r._fOwner)
@@ -347,6 +495,14 @@ namespace free_rtos_std
       return *this;
     }
 
+    // Returns once the task has called notify_started.
+    void wait_for_start()
+    {
+      while (0 == xEventGroupWaitBits(
+                      _evHandle, eStartedEv, pdFALSE, pdTRUE, portMAX_DELAY))
+        ;
+    }
+
   private:
     constexpr void move(gthr_freertos &&r)
     {
@@ -360,13 +516,6 @@ namespace free_rtos_std
       r._fOwner = false;
     }
 
-    void wait_for_start()
-    {
-      while (0 == xEventGroupWaitBits(
-                      _evHandle, eStartedEv, pdFALSE, pdTRUE, portMAX_DELAY))
-        ;
-    }
-
     native_task_type _taskHandle{nullptr};
     EventGroupHandle_t _evHandle{nullptr};
     void *_arg{nullptr};
@@ -21,13 +21,58 @@
 #ifndef FREERTOS_THREAD_WITH_ATTRIBUTES_H__
 #define FREERTOS_THREAD_WITH_ATTRIBUTES_H__
 
+#include <functional> // std::invoke
+#include <new>
 #include <thread>
+#include <tuple>
+#include <type_traits>
 #include <utility> // std::forward
 
 #include "freertos_thread_attributes.h"
 
 namespace free_rtos_std
 {
+  namespace internal
+  {
+    // std::thread has one member, its id, whose one member is the gthread
+    // handle (gthr_freertos). std_thread_on_stack() creates the task in the
+    // handle of a default constructed std::thread, without the constructor
+    // of std::thread that allocates the state.
+    inline __gthread_t &native_thread(std::thread &t)
+    {
+      static_assert(std::is_standard_layout_v<std::thread> && sizeof(std::thread) == sizeof(__gthread_t),
+                    "std::thread is expected to hold the gthread handle only");
+      return *reinterpret_cast<__gthread_t *>(&t);
+    }
+
+    // Runs the state and ends the task. 'heap' tells how to destroy it.
+    void run_thread(__gthread_t &local, std::thread::_State *state, bool heap);
+
+    template <typename Tuple>
+    struct thread_state final : std::thread::_State
+    {
+      explicit thread_state(Tuple &&t) : _t{std::move(t)} {}
+
+      void _M_run() override
+      {
+        std::apply([](auto &...v) { std::invoke(std::move(v)...); }, _t);
+      }
+
+      Tuple _t;
+    };
+
+    template <typename Tuple>
+    void stack_thread_routine(void *p)
+    {
+      __gthread_t local{*static_cast<__gthread_t *>(p)}; // copy
+
+      // The first frame of the task, at the top of its stack. run_thread
+      // does not return, the state is destroyed there.
+      alignas(thread_state<Tuple>) unsigned char top[sizeof(thread_state<Tuple>)];
+      auto state = ::new (top) thread_state<Tuple>{std::move(*static_cast<Tuple *>(local.arg()))};
+      run_thread(local, state, false);
+    }
+  }
 
   // Helper functions to create std::thread and std::jthread with attributes.
   // See free_rtos_std::attributes in freertos_thread_attributes.h for available attributes.
@@ -52,6 +97,32 @@ namespace free_rtos_std
     return std::thread(std::forward<Args>(args)...);
   }
 
+  // As std_thread, but the state of the thread is kept on the stack of the new
+  // task instead of the heap, so the stack must have room for the callable and
+  // its arguments. Nothing is allocated on the heap for it. The call returns
+  // once the task has started, it must not be made in a critical section.
+  // Before the scheduler runs, it is std_thread.
+  //
+  // @param f, args - see arguments of std::thread
+  template <typename F, typename... Args>
+  std::thread std_thread_on_stack(const free_rtos_std::attributes &attr, F &&f, Args &&...args)
+  {
+    using Tuple = std::tuple<std::decay_t<F>, std::decay_t<Args>...>;
+    static_assert(std::is_invocable_v<std::decay_t<F>, std::decay_t<Args>...>,
+                  "std::thread arguments must be invocable after conversion to rvalues");
+
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+      return std_thread(attr, std::forward<F>(f), std::forward<Args>(args)...);
+
+    // The task moves 'call' to its stack, wait until it has done so.
+    Tuple call{std::forward<F>(f), std::forward<Args>(args)...};
+    std::thread t;
+    __gthread_t &native = internal::native_thread(t);
+    native.create_thread(internal::stack_thread_routine<Tuple>, &call, &attr);
+    native.wait_for_start();
+    return t;
+  }
+
   // @param args - see arguments of std::jthread
   template <typename... Args>
   std::jthread std_jthread(const free_rtos_std::attributes &attr, Args &&...args)
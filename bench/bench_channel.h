@@ -0,0 +1,103 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_CHANNEL_H__
+#define BENCH_CHANNEL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "bench_helpers.h"
+#include "freertos_channel.h"
+
+// free_rtos_std::channel compared to a queue built of std::mutex,
+// std::condition_variable and std::deque.
+
+template <typename T>
+class cv_queue
+{
+public:
+  void send(const T &v)
+  {
+    {
+      std::lock_guard<std::mutex> lock{_m};
+      _q.push_back(v);
+    }
+    _cv.notify_one();
+  }
+
+  T recv()
+  {
+    std::unique_lock<std::mutex> lock{_m};
+    _cv.wait(lock, [this] { return !_q.empty(); });
+    T v = _q.front();
+    _q.pop_front();
+    return v;
+  }
+
+private:
+  std::mutex _m;
+  std::condition_variable _cv;
+  std::deque<T> _q;
+};
+
+// send + recv in one thread, no blocking
+template <typename Q>
+void BenchQueueUncontended(const char *name)
+{
+  Q q;
+  volatile int sink{};
+  bench::run(name, bench::MAX_SAMPLES, [&] {
+    q.send(1);
+    sink = q.recv();
+  });
+  (void)sink;
+}
+
+// message to a thread and the answer back, two context switches
+template <typename Q>
+void BenchQueuePingPong(const char *name)
+{
+  Q ping, pong;
+  std::thread t{[&] {
+    while (ping.recv() >= 0)
+      pong.send(0);
+  }};
+
+  bench::run(name, bench::MAX_SAMPLES, [&] {
+    ping.send(1);
+    pong.recv();
+  });
+
+  ping.send(-1);
+  t.join();
+}
+
+inline void BenchChannel()
+{
+  BenchQueueUncontended<free_rtos_std::channel<int, 8>>("channel_send_recv");
+  BenchQueueUncontended<cv_queue<int>>("cv_deque_send_recv");
+  BenchQueuePingPong<free_rtos_std::channel<int, 8>>("channel_ping_pong");
+  BenchQueuePingPong<cv_queue<int>>("cv_deque_ping_pong");
+}
+
+#endif // BENCH_CHANNEL_H__
@@ -0,0 +1,65 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_CLOCK_H__
+#define BENCH_CLOCK_H__
+
+#include <algorithm>
+#include <chrono>
+
+#include "bench_helpers.h"
+
+// Cost and resolution of the std::chrono clocks (freertos_time.cpp).
+
+template <typename Clock>
+void BenchClockNow(const char *name)
+{
+  volatile typename Clock::rep sink{};
+  bench::run(name, bench::MAX_SAMPLES, [&] { sink = Clock::now().time_since_epoch().count(); });
+  (void)sink;
+}
+
+// The smallest non zero difference between two readings.
+template <typename Clock>
+void BenchClockResolution(const char *name)
+{
+  using namespace std::chrono;
+  auto best = nanoseconds::max();
+  for (int i = 0; i < 1000; i++)
+  {
+    auto t0 = Clock::now();
+    auto t1 = Clock::now();
+    while (t1 == t0)
+      t1 = Clock::now();
+    best = std::min(best, duration_cast<nanoseconds>(t1 - t0));
+  }
+  bench::report_value(name, "ns", static_cast<std::uint32_t>(best.count()));
+}
+
+inline void BenchClock()
+{
+  using namespace std::chrono;
+  BenchClockNow<steady_clock>("steady_clock_now");
+  BenchClockNow<system_clock>("system_clock_now");
+  BenchClockResolution<steady_clock>("steady_clock_resolution");
+  BenchClockResolution<system_clock>("system_clock_resolution");
+}
+
+#endif // BENCH_CLOCK_H__
@@ -0,0 +1,81 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_CORO_H__
+#define BENCH_CORO_H__
+
+#include "bench_helpers.h"
+#include "freertos_channel.h"
+#include "freertos_coro.h"
+
+#if defined(__cpp_impl_coroutine)
+
+// Coroutine start and wakeup costs. Compare 'coro_spawn_join' with
+// 'thread_create_join' and 'coro_queue_ping_pong' with 'channel_ping_pong'.
+
+namespace bench_coro
+{
+  using namespace free_rtos_std;
+
+  inline coro::task<> nothing() { co_return; }
+
+  inline coro::task<> echo(coro::queue<int, 4> *q, channel<int, 1> *back)
+  {
+    // GCC 12 misplaces the frame of a coroutine awaiting in a loop
+    // condition, so the value is taken in the body.
+    for (;;)
+    {
+      int v = co_await q->receive();
+      if (v < 0)
+        break;
+      back->try_send(0); // never blocks the worker, the answer is taken each time
+    }
+  }
+}
+
+inline void BenchCoro()
+{
+  using namespace bench_coro;
+
+  {
+    coro::executor ex;
+    bench::run("coro_spawn_join", bench::MAX_SAMPLES, [&] {
+      ex.spawn(nothing());
+      ex.join();
+    });
+  }
+
+  {
+    coro::executor ex;
+    coro::queue<int, 4> q;
+    channel<int, 1> back;
+    ex.spawn(echo(&q, &back));
+    bench::run("coro_queue_ping_pong", bench::MAX_SAMPLES, [&] {
+      q.send(1);
+      back.recv();
+    });
+    q.send(-1);
+    ex.join();
+  }
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // BENCH_CORO_H__
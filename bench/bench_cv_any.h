@@ -0,0 +1,80 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_CV_ANY_H__
+#define BENCH_CV_ANY_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "freertos_condition_variable_any.h"
+
+#include "bench_helpers.h"
+
+// std::condition_variable_any against free_rtos_std::condition_variable_any,
+// the same round trip as "cv_ping_pong" in bench_gthread.h.
+template <typename CV>
+void BenchCVAnyPingPong(const char *name)
+{
+  std::mutex m;
+  CV cv;
+  int state{0}; // 0 - idle, 1 - ping, 2 - stop
+
+  std::thread t{[&] {
+    std::unique_lock<std::mutex> lock{m};
+    while (1)
+    {
+      cv.wait(lock, [&] { return state != 0; });
+      if (state == 2)
+        return;
+      state = 0;
+      cv.notify_one();
+    }
+  }};
+
+  bench::run(name, bench::MAX_SAMPLES, [&] {
+    std::unique_lock<std::mutex> lock{m};
+    state = 1;
+    cv.notify_one();
+    cv.wait(lock, [&] { return state == 0; });
+  });
+
+  {
+    std::lock_guard<std::mutex> lg{m};
+    state = 2;
+  }
+  cv.notify_one();
+  t.join();
+}
+
+inline void BenchCVAny()
+{
+  // Nobody waits, the cost of a notification alone.
+  std::condition_variable_any std_cv;
+  free_rtos_std::condition_variable_any cv;
+  bench::run("std_cv_any_notify", bench::MAX_SAMPLES, [&] { std_cv.notify_one(); });
+  bench::run("cv_any_notify", bench::MAX_SAMPLES, [&] { cv.notify_one(); });
+
+  BenchCVAnyPingPong<std::condition_variable_any>("std_cv_any_ping_pong");
+  BenchCVAnyPingPong<free_rtos_std::condition_variable_any>("cv_any_ping_pong");
+}
+
+#endif // BENCH_CV_ANY_H__
@@ -0,0 +1,96 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_FUTURE_H__
+#define BENCH_FUTURE_H__
+
+#include <future>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "freertos_future.h"
+#include "thread_with_attributes.h"
+
+#include "bench_helpers.h"
+#include "test_helpers.h" // TestBinarySemaphore
+
+// std::promise/std::future against free_rtos_std::promise/future. The std
+// one is also measured by "promise_set_future_get" in bench_gthread.h.
+
+// One sample: set_value in this task until get() has returned in a higher
+// priority task waiting for it, and that task waits for the next future.
+template <template <typename> class Promise, template <typename> class Future>
+void BenchFutureWake(const char *name)
+{
+  Promise<int> p;
+  Future<int> f;
+  bool stop{false};
+  TestBinarySemaphore armedSem;
+  SemaphoreHandle_t armed = armedSem.get();
+
+  std::thread t = free_rtos_std::std_thread(
+      free_rtos_std::attr_priority(uxTaskPriorityGet(nullptr) + 1), [&] {
+        for (;;)
+        {
+          xSemaphoreTake(armed, portMAX_DELAY);
+          if (stop)
+            return;
+          (void)f.get();
+        }
+      });
+
+  auto arm = [&] {
+    p = Promise<int>{};
+    f = p.get_future();
+    xSemaphoreGive(armed); // the waiter runs at once and blocks in get()
+  };
+
+  arm();
+  bench::run(name, bench::MAX_SAMPLES, [&] { p.set_value(1); }, arm);
+
+  stop = true;
+  p.set_value(1);
+  xSemaphoreGive(armed);
+  t.join();
+}
+
+inline void BenchFuturePair()
+{
+  bench::run("future_set_get", bench::MAX_SAMPLES, [] {
+    free_rtos_std::promise<int> p;
+    auto f = p.get_future();
+    p.set_value(1);
+    (void)f.get();
+  });
+
+  bench::run("future_then_set", bench::MAX_SAMPLES, [] {
+    free_rtos_std::promise<int> p;
+    auto f = p.get_future().then([](free_rtos_std::future<int> v) { return v.get() + 1; });
+    p.set_value(1);
+    (void)f.get();
+  });
+
+  BenchFutureWake<std::promise, std::future>("std_future_wake");
+  BenchFutureWake<free_rtos_std::promise, free_rtos_std::future>("future_wake");
+}
+
+#endif // BENCH_FUTURE_H__
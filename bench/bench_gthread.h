@@ -0,0 +1,246 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_GTHREAD_H__
+#define BENCH_GTHREAD_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "thread_with_attributes.h"
+
+#include "bench_helpers.h"
+#include "test_helpers.h" // TestKernelMutex
+
+// Benchmarks of the primitives implemented in gthr-default.h and thread.cpp.
+
+inline void BenchMutex()
+{
+  std::mutex m;
+  bench::run("mutex_lock_unlock", bench::MAX_SAMPLES, [&] {
+    m.lock();
+    m.unlock();
+  });
+}
+
+inline void BenchKernelMutex()
+{
+  // The kernel mutex std::mutex is built on without configSTD_FAST_MUTEX.
+  TestKernelMutex mutex;
+  SemaphoreHandle_t m = mutex.get();
+  bench::run("kernel_mutex_take_give", bench::MAX_SAMPLES, [&] {
+    xSemaphoreTake(m, portMAX_DELAY);
+    xSemaphoreGive(m);
+  });
+}
+
+inline void BenchMutexContended()
+{
+  // Another task of the same priority keeps taking the same mutex.
+  std::mutex m;
+  std::atomic<bool> fStop{false};
+  std::thread t{[&] {
+    while (!fStop)
+    {
+      {
+        std::lock_guard<std::mutex> lg{m};
+        std::this_thread::yield();
+      }
+      std::this_thread::yield();
+    }
+  }};
+
+  bench::run("mutex_lock_unlock_contended", bench::MAX_SAMPLES, [&] {
+    m.lock();
+    m.unlock();
+  },
+             [] { std::this_thread::yield(); });
+
+  fStop = true;
+  t.join();
+}
+
+inline void BenchRecursiveMutex()
+{
+  std::recursive_mutex m;
+  bench::run("recursive_mutex_lock2_unlock2", bench::MAX_SAMPLES, [&] {
+    m.lock();
+    m.lock();
+    m.unlock();
+    m.unlock();
+  });
+}
+
+inline void BenchCVPingPong()
+{
+  // One sample is a full round trip: notify the worker and wait for
+  // its answer.
+  std::mutex m;
+  std::condition_variable cv;
+  int state{0}; // 0 - idle, 1 - ping, 2 - stop
+
+  std::thread t{[&] {
+    std::unique_lock<std::mutex> lock{m};
+    while (1)
+    {
+      cv.wait(lock, [&] { return state != 0; });
+      if (state == 2)
+        return;
+      state = 0;
+      cv.notify_one();
+    }
+  }};
+
+  bench::run("cv_ping_pong", bench::MAX_SAMPLES, [&] {
+    std::unique_lock<std::mutex> lock{m};
+    state = 1;
+    cv.notify_one();
+    cv.wait(lock, [&] { return state == 0; });
+  });
+
+  {
+    std::lock_guard<std::mutex> lg{m};
+    state = 2;
+  }
+  cv.notify_one();
+  t.join();
+}
+
+inline void BenchCallOnce()
+{
+  std::optional<std::once_flag> flag;
+  flag.emplace();
+  bench::run("call_once_first", bench::MAX_SAMPLES, [&] { std::call_once(*flag, [] {}); },
+             [&] {
+               flag.reset();
+               flag.emplace();
+             });
+
+  std::call_once(*flag, [] {});
+  bench::run("call_once_done", bench::MAX_SAMPLES, [&] { std::call_once(*flag, [] {}); });
+}
+
+inline void BenchThreadCreateJoin()
+{
+  using namespace std::chrono_literals;
+
+  // Memory of a finished task is released by the idle task. Sleep between
+  // the samples to let it run.
+  bench::run("thread_create_join", 200, [] {
+    std::thread t{[] {}};
+    t.join();
+  },
+             [] { std::this_thread::sleep_for(1ms); });
+
+  // The state of the thread on the stack of the task, no heap allocation
+  // for it (thread_with_attributes.h).
+  bench::run("thread_create_join_state_on_stack", 200, [] {
+    std::thread t = free_rtos_std::std_thread_on_stack(free_rtos_std::attributes{}, [] {});
+    t.join();
+  },
+             [] { std::this_thread::sleep_for(1ms); });
+}
+
+inline void BenchFuture()
+{
+  bench::run("promise_set_future_get", bench::MAX_SAMPLES, [] {
+    std::promise<int> p;
+    auto f = p.get_future();
+    p.set_value(1);
+    (void)f.get();
+  });
+}
+
+inline void BenchGetSpecific()
+{
+  __gthread_key_t key;
+  __gthread_key_create(&key, nullptr);
+  static int value;
+  __gthread_setspecific(key, &value);
+
+  void *volatile sink{};
+  bench::run("getspecific", bench::MAX_SAMPLES, [&] { sink = __gthread_getspecific(key); });
+  (void)sink;
+
+  __gthread_setspecific(key, nullptr);
+  __gthread_key_delete(key);
+}
+
+inline void BenchSleepZero()
+{
+  using namespace std::chrono_literals;
+  bench::run("sleep_for_0", bench::MAX_SAMPLES, [] { std::this_thread::sleep_for(0ms); });
+  bench::run("yield", bench::MAX_SAMPLES, [] { std::this_thread::yield(); });
+}
+
+#if __cplusplus > 201907L
+inline void BenchAtomicWait()
+{
+  // Round trip: wake the worker and wait until it answers.
+  std::atomic<int> a{0}; // 0 - idle, 1 - ping, 2 - stop
+  std::thread t{[&] {
+    while (1)
+    {
+      a.wait(0);
+      if (a == 2)
+        return;
+      a = 0;
+      a.notify_one();
+    }
+  }};
+
+  bench::run("atomic_wait_notify_ping_pong", bench::MAX_SAMPLES, [&] {
+    a = 1;
+    a.notify_one();
+    a.wait(1);
+  });
+
+  a = 2;
+  a.notify_one();
+  t.join();
+}
+#endif
+
+inline void BenchGthread()
+{
+  BenchMutex();
+  BenchKernelMutex();
+  BenchMutexContended();
+  BenchRecursiveMutex();
+  BenchCVPingPong();
+  BenchCallOnce();
+  BenchThreadCreateJoin();
+  BenchFuture();
+  BenchGetSpecific();
+  BenchSleepZero();
+#if __cplusplus > 201907L
+  BenchAtomicWait();
+#endif
+}
+
+#endif // BENCH_GTHREAD_H__
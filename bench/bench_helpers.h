@@ -0,0 +1,143 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_HELPERS_H__
+#define BENCH_HELPERS_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "console.h"
+#include "cycle_counter.h"
+
+// Micro-benchmark helpers.
+//
+// Every sample times a single call of the measured function with the
+// platform cycle counter (see cycle_counter.h). Results are printed as one
+// line per benchmark, easy to grep and to compare between builds:
+//
+//   BENCH <name> unit=cycles n=1000 min=120 median=131 p99=402
+//
+namespace bench
+{
+  constexpr std::size_t MAX_SAMPLES{1000U};
+  inline std::uint32_t s_samples[MAX_SAMPLES];
+
+  inline void print_dec(std::uint32_t v)
+  {
+    char buf[11];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    do
+    {
+      *--p = static_cast<char>('0' + v % 10);
+      v /= 10;
+    } while (v);
+    print(p);
+  }
+
+  // Cost of reading the counter twice. It is subtracted from each sample.
+  inline std::uint32_t overhead()
+  {
+    std::uint32_t best{UINT32_MAX};
+    for (int i = 0; i < 100; i++)
+    {
+      auto t0 = cycle_counter();
+      auto t1 = cycle_counter();
+      best = std::min(best, t1 - t0);
+    }
+    return best;
+  }
+
+  inline void report(const char *name, std::size_t n)
+  {
+    std::sort(s_samples, s_samples + n);
+    print("BENCH ");
+    print(name);
+    print(" unit=");
+    print(cycle_counter_unit());
+    print(" n=");
+    print_dec(n);
+    print(" min=");
+    print_dec(s_samples[0]);
+    print(" median=");
+    print_dec(s_samples[n / 2]);
+    print(" p99=");
+    print_dec(s_samples[(n * 99) / 100]);
+    print("\n");
+  }
+
+  // Single measured value, e.g. a resolution:
+  //   BENCH_VALUE <name> unit=ns value=1000
+  inline void report_value(const char *name, const char *unit, std::uint32_t value)
+  {
+    print("BENCH_VALUE ");
+    print(name);
+    print(" unit=");
+    print(unit);
+    print(" value=");
+    print_dec(value);
+    print("\n");
+  }
+
+  // Print the build identification, so results of different GCC and
+  // FreeRTOS versions can be told apart.
+  inline void print_info(const char *platform)
+  {
+    print("BENCH_INFO platform=");
+    print(platform);
+    print(" gcc=" __VERSION__ " freertos=" tskKERNEL_VERSION_NUMBER " tick_hz=");
+    print_dec(configTICK_RATE_HZ);
+    print("\n");
+  }
+
+  // @param name  - benchmark name printed in the report
+  // @param n     - number of samples, at most MAX_SAMPLES
+  // @param fn    - measured function
+  // @param after - called after each sample, not measured (e.g. clean up)
+  template <typename F, typename A>
+  void run(const char *name, std::size_t n, F &&fn, A &&after)
+  {
+    n = std::min(n, MAX_SAMPLES);
+    const auto oh = overhead();
+    for (std::size_t i = 0; i < n; i++)
+    {
+      auto t0 = cycle_counter();
+      fn();
+      auto t1 = cycle_counter();
+      auto d = t1 - t0;
+      s_samples[i] = d > oh ? d - oh : 0;
+      after();
+    }
+    report(name, n);
+  }
+
+  template <typename F>
+  void run(const char *name, std::size_t n, F &&fn)
+  {
+    run(name, n, fn, [] {});
+  }
+}
+
+#endif // BENCH_HELPERS_H__
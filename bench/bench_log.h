@@ -0,0 +1,50 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_LOG_H__
+#define BENCH_LOG_H__
+
+#include "bench_helpers.h"
+#include "freertos_log.h"
+
+#if (configSTD_LOG == 1)
+
+// Cost of a log line on the calling thread. 'log_write' only stores the
+// arguments, 'log_format' is the formatting it defers to the drain task.
+inline void BenchLog()
+{
+  // The text is not needed, only the records have to be drained.
+  free_rtos_std::log::start([](const char *) {});
+
+  static int n;
+  bench::run(
+      "log_write", bench::MAX_SAMPLES,
+      [] { free_rtos_std::log::write("sample {} of {}: {:x}\n", n++, bench::MAX_SAMPLES, 0xbeefU); },
+      [] { free_rtos_std::log::flush(); });
+
+  static char line[64];
+  bench::run("log_format", bench::MAX_SAMPLES, [] {
+    free_rtos_std::log::format(line, sizeof(line), "sample {} of {}: {:x}\n", n++, bench::MAX_SAMPLES, 0xbeefU);
+  });
+}
+
+#endif // configSTD_LOG == 1
+
+#endif // BENCH_LOG_H__
@@ -0,0 +1,109 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_SHARED_MUTEX_H__
+#define BENCH_SHARED_MUTEX_H__
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include "freertos_shared_mutex.h"
+
+#include "bench_helpers.h"
+
+#if (configSTD_SHARED_MUTEX == 1)
+
+// Read-heavy use: 'readers' other tasks of the same priority keep holding
+// the lock shared while the measured task takes and releases a shared lock.
+// A writer updates the data once per 'write_every' samples.
+template <typename M>
+void BenchSharedReaders(const char *name, int readers, int write_every)
+{
+  constexpr int MAX_READERS{8};
+  M m;
+  std::atomic<bool> fStop{false};
+  std::atomic<int> samples{0};
+
+  std::thread r[MAX_READERS];
+  for (int i = 0; i < readers && i < MAX_READERS; i++)
+    r[i] = std::thread{[&] {
+      while (!fStop)
+      {
+        std::shared_lock<M> lock{m};
+        std::this_thread::yield();
+      }
+    }};
+
+  std::thread w{[&] {
+    int last{0};
+    while (!fStop)
+    {
+      if (samples - last >= write_every)
+      {
+        last = samples;
+        std::lock_guard<M> lock{m};
+      }
+      std::this_thread::yield();
+    }
+  }};
+
+  bench::run(name, bench::MAX_SAMPLES, [&] {
+    m.lock_shared();
+    m.unlock_shared();
+  },
+             [&] {
+               samples++;
+               std::this_thread::yield();
+             });
+
+  fStop = true;
+  for (auto &t : r)
+    if (t.joinable())
+      t.join();
+  w.join();
+}
+
+inline void BenchSharedMutex()
+{
+  free_rtos_std::shared_mutex m;
+  bench::run("shared_mutex_lock_shared", bench::MAX_SAMPLES, [&] {
+    m.lock_shared();
+    m.unlock_shared();
+  });
+  bench::run("shared_mutex_lock", bench::MAX_SAMPLES, [&] {
+    m.lock();
+    m.unlock();
+  });
+
+  // libstdc++ std::shared_mutex (a mutex and two condition variables)
+  // against the native one, with more and more readers.
+  BenchSharedReaders<std::shared_mutex>("std_shared_mutex_readers_0", 0, 100);
+  BenchSharedReaders<free_rtos_std::shared_mutex>("shared_mutex_readers_0", 0, 100);
+  BenchSharedReaders<std::shared_mutex>("std_shared_mutex_readers_2", 2, 100);
+  BenchSharedReaders<free_rtos_std::shared_mutex>("shared_mutex_readers_2", 2, 100);
+  BenchSharedReaders<std::shared_mutex>("std_shared_mutex_readers_8", 8, 100);
+  BenchSharedReaders<free_rtos_std::shared_mutex>("shared_mutex_readers_8", 8, 100);
+}
+
+#endif // configSTD_SHARED_MUTEX == 1
+
+#endif // BENCH_SHARED_MUTEX_H__
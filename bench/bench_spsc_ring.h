@@ -0,0 +1,65 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_SPSC_RING_H__
+#define BENCH_SPSC_RING_H__
+
+#include "bench_channel.h"
+#include "freertos_spsc_ring.h"
+
+// free_rtos_std::spsc_ring with the send/recv interface of the channel
+// benchmarks, so the results compare directly with 'channel_*'.
+
+template <typename T, std::size_t N>
+class spsc_queue
+{
+public:
+  void send(const T &v)
+  {
+    while (!_ring.push(v))
+      taskYIELD();
+  }
+
+  T recv()
+  {
+    T v{};
+    _ring.wait_pop(std::span<T>{&v, 1});
+    return v;
+  }
+
+private:
+  free_rtos_std::spsc_ring<T, N> _ring;
+};
+
+inline void BenchSpscRing()
+{
+  BenchQueueUncontended<spsc_queue<int, 8>>("spsc_push_pop");
+  BenchQueuePingPong<spsc_queue<int, 8>>("spsc_ping_pong");
+
+  // 16 elements in and out, compare with 16 x spsc_push_pop
+  static free_rtos_std::spsc_ring<int, 32> ring;
+  static int data[16];
+  bench::run("spsc_bulk_16", bench::MAX_SAMPLES, [] {
+    ring.push(data);
+    ring.pop(data);
+  });
+}
+
+#endif // BENCH_SPSC_RING_H__
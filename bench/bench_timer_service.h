@@ -0,0 +1,75 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef BENCH_TIMER_SERVICE_H__
+#define BENCH_TIMER_SERVICE_H__
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "bench_helpers.h"
+#include "freertos_timer_service.h"
+
+// Cost of free_rtos_std::timer_service operations. The timers are far in
+// the future, so the service task does not interfere. Schedule and cancel
+// should not depend on the number of outstanding timers.
+
+inline void BenchTimerService()
+{
+  using namespace std::chrono_literals;
+
+  constexpr std::size_t N{bench::MAX_SAMPLES};
+  static free_rtos_std::timer_token s_tokens[N];
+
+  free_rtos_std::timer_service timers{N};
+  std::size_t i{0};
+
+  // timers spread over all levels of the wheel
+  bench::run("timer_schedule", N, [&] {
+    s_tokens[i] = timers.schedule_after(std::chrono::milliseconds(100 + (i * 7919) % 3'600'000), [] {});
+    i++;
+  });
+
+  i = 0;
+  bench::run("timer_cancel", N, [&] { timers.cancel(s_tokens[i++]); });
+
+  // schedule followed by cancel with N timers outstanding
+  for (i = 0; i < N - 1; i++)
+    s_tokens[i] = timers.schedule_after(1h, [] {});
+  bench::run("timer_schedule_cancel_loaded", N, [&] {
+    timers.cancel(timers.schedule_after(10ms, [] {}));
+  });
+  for (i = 0; i < N - 1; i++)
+    timers.cancel(s_tokens[i]);
+
+  // from schedule_after(0) to the callable running in the service task
+  std::atomic<bool> fired{false};
+  bench::run(
+      "timer_fire_latency", 200,
+      [&] {
+        timers.schedule_after(0ms, [&] { fired = true; });
+        while (!fired)
+          ;
+      },
+      [&] { fired = false; });
+}
+
+#endif // BENCH_TIMER_SERVICE_H__
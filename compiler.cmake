@@ -25,6 +25,13 @@ cmake_minimum_required(VERSION 3.10)
 ##############################
 
 set(COMPILER_NAME "GCC")
+
+if(posix)
+  # Host build, the native compiler found by cmake
+  SET(SIZE_TOOL size)
+  return()
+endif(posix)
+
 if(WIN32)
   set(COMPILER_PATH "") # add to system path 
   SET(COMPILER_POSTFIX ".exe")
@@ -54,6 +61,7 @@ SET(CMAKE_USE_RELATIVE_PATHS TRUE)
 SET(CMAKE_C_COMPILER   ${COMPILER_PREFIX}-gcc${COMPILER_POSTFIX})
 SET(CMAKE_CXX_COMPILER ${COMPILER_PREFIX}-g++${COMPILER_POSTFIX})
 SET(CMAKE_ASM_COMPILER ${COMPILER_PREFIX}-g++${COMPILER_POSTFIX})
+SET(SIZE_TOOL ${COMPILER_PREFIX}-size${COMPILER_POSTFIX})
 
 SET(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
 SET(CMAKE_LEGACY_CYGWIN_WIN32 0)
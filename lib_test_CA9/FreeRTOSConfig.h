@@ -66,11 +66,13 @@
 uint32_t SystemCoreClockFreq();
 
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
+#ifndef configUSE_TICKLESS_IDLE
 #define configUSE_TICKLESS_IDLE					0
+#endif
 #define configTICK_RATE_HZ						( ( TickType_t ) 1000 )
 #define configUSE_PREEMPTION					1
 #define configUSE_IDLE_HOOK						0
-#define configUSE_TICK_HOOK						0
+#define configUSE_TICK_HOOK						1
 #define configMAX_PRIORITIES					( 7 )
 #define configMINIMAL_STACK_SIZE				( ( unsigned short ) 250 ) /* Large in case configUSE_TASK_FPU_SUPPORT is 2 in which case all tasks have an FPU context. */
 #define configTOTAL_HEAP_SIZE					( 125 * 1024 )
@@ -79,6 +81,8 @@ uint32_t SystemCoreClockFreq();
 #define configUSE_16_BIT_TICKS					0
 #define configIDLE_SHOULD_YIELD					1
 #define configUSE_MUTEXES						1
+/* Index 1 is used by the locks of the library, see freertos_mutex.h. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	2
 #define configQUEUE_REGISTRY_SIZE				8
 #define configCHECK_FOR_STACK_OVERFLOW			2
 #define configUSE_RECURSIVE_MUTEXES				1
@@ -86,7 +90,21 @@ uint32_t SystemCoreClockFreq();
 #define configUSE_APPLICATION_TASK_TAG			0
 #define configUSE_COUNTING_SEMAPHORES			1
 #define configUSE_QUEUE_SETS					1
-#define configSUPPORT_STATIC_ALLOCATION			0
+#ifdef STD_STATIC_ALLOCATION
+/* Zero-heap profile (cmake -DSTATIC_ALLOC=1). The kernel and the C++ library
+create every object with the *Static API. */
+#define configSUPPORT_STATIC_ALLOCATION			1
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION		0
+#endif
+#define configSTD_THREAD_POOL_SIZE				16
+#define configSTD_THREAD_POOL_STACK_SIZE		1024
+void vStdThreadCleanUpTCB( void *pxTCB );
+#define portCLEAN_UP_TCB( pxTCB )				vStdThreadCleanUpTCB( pxTCB )
+#else
+/* free_rtos_std::static_thread */
+#define configSUPPORT_STATIC_ALLOCATION			1
+#endif
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 
 #define configMAIN_STACK_SIZE 384 // in words (bytes = x4)
@@ -120,12 +138,51 @@ to exclude the API function. */
 #define INCLUDE_xTimerPendFunctionCall 0
 #define INCLUDE_eTaskGetState 1
 #define INCLUDE_xTaskAbortDelay 1
+#define INCLUDE_xTaskGetSchedulerState 1
 #define INCLUDE_xTaskGetTaskHandle 1
 #define INCLUDE_xTaskGetHandle 1
 #define INCLUDE_xSemaphoreGetMutexHolder 1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
 
 #define configGENERATE_RUN_TIME_STATS 0
 
+/* Time base of std::chrono clocks, see freertos_clock.h. The global timer
+runs at the same rate as configured in vSetupTickInterrupt. */
+unsigned long long ullGlobalTimerCount( void );
+#define configSTD_CLOCK_COUNTER()				ullGlobalTimerCount()
+#define configSTD_CLOCK_COUNTER_HZ				100000000ULL
+
+/* Deferred log, see freertos_log.h. The test output uses it with
+TEST_LOG_OUTPUT set to 1 (cmake -DTEST_LOG_OUTPUT=1; the posix
+target builds test_posix_log.elf with it), see test_helpers.h. */
+#define configSTD_LOG							1
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+/* Tickless idle (cmake -DTICKLESS_IDLE=1). The tick interrupt is suppressed
+while the system is idle, ulTickInterruptCount counts the ones taken. */
+extern volatile unsigned long ulTickInterruptCount;
+void vPortSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )	vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#define traceTASK_INCREMENT_TICK( xTickCount )				ulTickInterruptCount++
+#endif
+
+#if defined( configSTD_PRECISE_SLEEP ) && ( configSTD_PRECISE_SLEEP == 1 )
+/* Sub-tick sleep_for (cmake -DPRECISE_SLEEP=1), see freertos_precise_sleep.h.
+The private timer is the one-shot timer, the global timer drives the tick. */
+void vPreciseSleepTimerArm( unsigned long long ullCount );
+#define configSTD_PRECISE_SLEEP_TIMER_ARM( ullCount )	vPreciseSleepTimerArm( ullCount )
+#endif
+
+#if defined( configSTD_THREAD_STATS ) && ( configSTD_THREAD_STATS == 1 )
+/* Per std::thread statistics (cmake -DTHREAD_STATS=1), see
+freertos_thread_stats.h. */
+void vStdThreadStatsSwitchedIn( void );
+void vStdThreadStatsSwitchedOut( int xStillReady );
+#define traceTASK_SWITCHED_IN()					vStdThreadStatsSwitchedIn()
+#define traceTASK_SWITCHED_OUT()				vStdThreadStatsSwitchedOut( \
+	listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+#endif
+
 /* Normal assert() semantics without relying on the provision of an assert.h
 header file. */
 #define configASSERT( x ) if( ( x ) == 0 ) while(1);
@@ -21,6 +21,7 @@
 // Implementation of functions required by FreeRTOS Cortex-A port
 
 #include "FreeRTOS.h"
+#include "task.h"
 #include "ca9_global_timer.h"
 
 #include "ARMCA9.h"
@@ -37,6 +38,95 @@ void vApplicationIRQHandler(unsigned long ulICCIAR)
   isr();
 }
 
+// Time base of std::chrono clocks (configSTD_CLOCK_COUNTER)
+unsigned long long ullGlobalTimerCount(void)
+{
+  return GlobTimer_Counter();
+}
+
+#if defined(configSTD_PRECISE_SLEEP) && (configSTD_PRECISE_SLEEP == 1)
+// One-shot timer of precise sleep_for. The private timer counts down at the
+// rate of the global timer.
+void vStdPreciseSleepTimerISR(void);
+
+static void PrivateTimerHandler(void)
+{
+  PTIM_ClearEventFlag();
+  vStdPreciseSleepTimerISR();
+}
+
+void vPreciseSleepTimerArm(unsigned long long ullCount)
+{
+  unsigned long long now = GlobTimer_Counter();
+  unsigned long long count = ullCount > now ? ullCount - now : 1;
+  if (count > 0xFFFFFFFFULL)
+    count = 0xFFFFFFFFULL; // the ISR arms it again
+
+  PTIM_SetControl(0);
+  PTIM_ClearEventFlag();
+  PTIM_SetLoadValue((uint32_t)count);
+  PTIM_SetControl(1U | 4U); // enable, interrupt, no auto reload
+}
+#endif
+
+#if (configUSE_TICKLESS_IDLE == 1)
+volatile unsigned long ulTickInterruptCount;
+
+// The global timer compare generates the tick. It auto increments by one
+// tick period, so the compare register holds the time of the next tick.
+// For the idle time the compare is moved forward to the last expected tick
+// and the core waits for an interrupt. The ticks which have passed are then
+// added with vTaskStepTick. The chrono clocks read the global timer counter,
+// they are not affected.
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+  const unsigned long long period = GLOBTMR->auto_inc;
+
+  // CPSR I bit, not the GIC priority mask; an interrupt must still end WFI.
+  __disable_irq();
+  __DSB();
+  __ISB();
+
+  GlobTimer_Compare(false);
+  unsigned long long next = ((unsigned long long)GLOBTMR->compareHi << 32) | GLOBTMR->compareLo;
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep || GlobTimer_EvntPending() ||
+      GlobTimer_Counter() >= next)
+  {
+    GlobTimer_Compare(true);
+    __enable_irq();
+    return;
+  }
+
+  // The tick at 'last' is taken by the tick interrupt as usual.
+  unsigned long long last = next + (xExpectedIdleTime - 1) * period;
+  GlobTimer_CompareValue(last);
+  GlobTimer_Compare(true);
+
+  __DSB();
+  __WFI();
+  __ISB();
+
+  GlobTimer_Compare(false);
+  unsigned long long now = GlobTimer_Counter();
+  if (now >= last)
+  {
+    // The compare has fired and auto incremented. Its interrupt is pending.
+    vTaskStepTick(xExpectedIdleTime - 1);
+  }
+  else
+  {
+    // Woken up by another interrupt. Count the ticks which have passed and
+    // go back to the next tick.
+    unsigned long long passed = now >= next ? (now - next) / period + 1 : 0;
+    vTaskStepTick((TickType_t)passed);
+    GlobTimer_CompareValue(next + passed * period);
+  }
+  GlobTimer_Compare(true);
+
+  __enable_irq();
+}
+#endif
+
 void vClearTickInterrupt(void)
 {
   GlobTimer_IrqClr();
@@ -55,4 +145,9 @@ void vSetupTickInterrupt(void)
   GlobalTimer_IncValue(clkHz / configTICK_RATE_HZ);
   GlobTimer_CompareValue(clkHz / configTICK_RATE_HZ);
   GLOBTMR->control |= GLOBTMR_CTRL_CMP_EN | GLOBTMR_CTRL_AUTO_INC | GLOBTMR_CTRL_EN | GLOBTMR_CTRL_IRQ_EN;
+
+#if defined(configSTD_PRECISE_SLEEP) && (configSTD_PRECISE_SLEEP == 1)
+  IRQ_SetHandler(PrivTimer_IRQn, PrivateTimerHandler);
+  IRQ_Enable(PrivTimer_IRQn);
+#endif
 }
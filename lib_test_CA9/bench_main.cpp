@@ -0,0 +1,66 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include <cstdlib>
+
+#include "console.h"
+#include "cycle_counter.h"
+#include "bench_helpers.h"
+#include "bench_gthread.h"
+#include "bench_cv_any.h"
+#include "bench_shared_mutex.h"
+#include "bench_future.h"
+#include "bench_clock.h"
+#include "bench_timer_service.h"
+#include "bench_channel.h"
+#include "bench_spsc_ring.h"
+#include "bench_coro.h"
+#include "bench_log.h"
+
+// Micro-benchmarks. Build target bench_ca9.elf. Each result is printed as
+// a 'BENCH ...' line, see bench/bench_helpers.h.
+
+int main(void)
+{
+  print("ARM CA9 - start benchmark\n");
+
+  bench::cycle_counter_init();
+  bench::print_info("ca9");
+
+  BenchGthread();
+  BenchCVAny();
+#if (configSTD_SHARED_MUTEX == 1)
+  BenchSharedMutex();
+#endif
+  BenchFuturePair();
+  BenchClock();
+  BenchTimerService();
+  BenchChannel();
+  BenchSpscRing();
+#if defined(__cpp_impl_coroutine)
+  BenchCoro();
+#endif
+#if (configSTD_LOG == 1)
+  BenchLog();
+#endif
+
+  print("OK\n");
+  return EXIT_SUCCESS;
+}
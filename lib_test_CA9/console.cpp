@@ -20,6 +20,9 @@
 
 #include "console.h"
 
+#include "ARMCA9.h"
+#include "irq_ctrl.h"
+
 // UART data register
 volatile unsigned int *const UART0DR = (unsigned int *)0x10009000; // ???
 volatile unsigned int *const UART0FR = (unsigned int *)0x10009006; // ???
@@ -53,3 +56,42 @@ void print(unsigned int num)
       *UART0DR = '?';
   }
 }
+
+// PL011 registers used by the receiver
+volatile unsigned int *const UART0RFR = (unsigned int *)0x10009018;  // flags
+volatile unsigned int *const UART0CR = (unsigned int *)0x10009030;   // control
+volatile unsigned int *const UART0IMSC = (unsigned int *)0x10009038; // interrupt mask
+volatile unsigned int *const UART0ICR = (unsigned int *)0x10009044;  // interrupt clear
+
+static const unsigned FR_RXFE = 1 << 4;
+static const unsigned CR_LBE = 1 << 7;
+static const unsigned INT_RX = (1 << 4) | (1 << 6); // receive, receive timeout
+
+static console_rx_handler s_onRx;
+
+static void uart0_isr()
+{
+  while (!(*UART0RFR & FR_RXFE))
+    s_onRx((char)(*UART0DR & 0xFF));
+  *UART0ICR = INT_RX;
+}
+
+void console_rx_start(console_rx_handler on_rx, bool loopback)
+{
+  s_onRx = on_rx;
+  if (loopback)
+    *UART0CR = *UART0CR | CR_LBE;
+  while (!(*UART0RFR & FR_RXFE)) // drop stale input
+    (void)*UART0DR;
+  *UART0ICR = INT_RX;
+  IRQ_SetHandler(UART0_IRQn, uart0_isr);
+  IRQ_Enable(UART0_IRQn);
+  *UART0IMSC = *UART0IMSC | INT_RX;
+}
+
+void console_rx_stop()
+{
+  *UART0IMSC = *UART0IMSC & ~INT_RX;
+  IRQ_Disable(UART0_IRQn);
+  *UART0CR = *UART0CR & ~CR_LBE;
+}
@@ -27,4 +27,18 @@ static inline void printc(char c) { *UART0DR = c; }
 void print(const char *s);
 void print(unsigned int num);
 
+// Interrupt driven receive of UART0. 'on_rx' is called from the interrupt
+// for every received character. With 'loopback' the transmitter is wired
+// to the receiver inside the UART, so printed characters come back.
+#define CONSOLE_HAS_RX 1
+typedef void (*console_rx_handler)(char c);
+void console_rx_start(console_rx_handler on_rx, bool loopback);
+void console_rx_stop();
+
+// The tests that print into the receiver rely on the loopback. QEMU emulates
+// it since 8.1; build with -DNO_UART_LOOPBACK=1 to leave them out.
+#ifndef CONSOLE_HAS_LOOPBACK
+#define CONSOLE_HAS_LOOPBACK 1
+#endif
+
 #endif //CONSOLE_PRINT_H
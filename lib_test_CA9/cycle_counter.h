@@ -0,0 +1,69 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <cstdint>
+#include "ca9_global_timer.h"
+
+// Cycle counter of the Cortex-A9 Performance Monitor Unit (PMCCNTR).
+//
+// Not every emulator implements the PMU. ID_DFR0 tells whether it is there.
+// If not, the free running global timer is used instead and the unit
+// reported by the benchmarks changes accordingly.
+namespace bench
+{
+  inline bool s_fPmu{false};
+
+  inline void cycle_counter_init()
+  {
+    std::uint32_t dfr0;
+    asm volatile("mrc p15, 0, %0, c0, c1, 2" : "=r"(dfr0)); // ID_DFR0
+    const std::uint32_t perfMon = (dfr0 >> 24) & 0xFU;
+    s_fPmu = perfMon != 0 && perfMon != 0xFU;
+    if (!s_fPmu)
+      return;
+
+    std::uint32_t pmcr;
+    asm volatile("mrc p15, 0, %0, c9, c12, 0" : "=r"(pmcr));
+    pmcr |= (1U << 0) | (1U << 2); // enable, reset cycle counter
+    pmcr &= ~(1U << 3);             // count every cycle, no divider
+    asm volatile("mcr p15, 0, %0, c9, c12, 0" ::"r"(pmcr));
+    asm volatile("mcr p15, 0, %0, c9, c12, 1" ::"r"(1U << 31)); // PMCNTENSET.C
+  }
+
+  inline std::uint32_t cycle_counter()
+  {
+    std::uint32_t c;
+    if (s_fPmu)
+      asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(c)::"memory"); // PMCCNTR
+    else
+      c = static_cast<std::uint32_t>(GLOBTMR->counterLo);
+    return c;
+  }
+
+  inline const char *cycle_counter_unit()
+  {
+    return s_fPmu ? "cycles" : "gtimer";
+  }
+}
+
+#endif // CYCLE_COUNTER_H
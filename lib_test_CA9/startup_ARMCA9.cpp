@@ -119,6 +119,11 @@ void free_rtos_main(void*) {
   exit(main());
 }
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+static StaticTask_t s_mainTaskTCB;
+static StackType_t s_mainTaskStack[configMAIN_STACK_SIZE];
+#endif
+
 /*----------------------------------------------------------------------------
   Reset Handler called on controller reset
  *----------------------------------------------------------------------------*/
@@ -190,12 +195,22 @@ extern "C" void Reset_Handler(void) {
   // Enable Interrupts
   __ASM volatile("CPSIE if");
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  if (NULL == xTaskCreateStatic(free_rtos_main,
+                                "main",
+                                configMAIN_STACK_SIZE,
+                                NULL,
+                                tskIDLE_PRIORITY + 1,
+                                s_mainTaskStack,
+                                &s_mainTaskTCB))
+#else
   if (pdPASS != xTaskCreate(free_rtos_main,
                             "main",
                             configMAIN_STACK_SIZE,
                             NULL,
                             tskIDLE_PRIORITY + 1,
                             NULL))
+#endif
   {
     while (1)
       ;
@@ -47,6 +47,9 @@
 #define configMTIMECMP_BASE_ADDRESS		( CLINT_ADDR + CLINT_MTIMECMP )
 
 #define configUSE_PREEMPTION			1
+#ifndef configUSE_TICKLESS_IDLE
+#define configUSE_TICKLESS_IDLE			0
+#endif
 #define configUSE_IDLE_HOOK				0
 #define configUSE_TICK_HOOK				1
 #define configCPU_CLOCK_HZ				( 10000000 )
@@ -59,6 +62,8 @@
 #define configUSE_16_BIT_TICKS			0
 #define configIDLE_SHOULD_YIELD			0
 #define configUSE_MUTEXES				1
+/* Index 1 is used by the locks of the library, see freertos_mutex.h. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	2
 #define configQUEUE_REGISTRY_SIZE		8
 #define configCHECK_FOR_STACK_OVERFLOW	2
 #define configUSE_RECURSIVE_MUTEXES		1
@@ -69,6 +74,22 @@
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
 
+#ifdef STD_STATIC_ALLOCATION
+/* Zero-heap profile (cmake -DSTATIC_ALLOC=1). The kernel and the C++ library
+create every object with the *Static API. */
+#define configSUPPORT_STATIC_ALLOCATION	1
+#ifndef configSUPPORT_DYNAMIC_ALLOCATION
+#define configSUPPORT_DYNAMIC_ALLOCATION	0
+#endif
+#define configSTD_THREAD_POOL_SIZE		16
+#define configSTD_THREAD_POOL_STACK_SIZE	1024
+void vStdThreadCleanUpTCB( void *pxTCB );
+#define portCLEAN_UP_TCB( pxTCB )		vStdThreadCleanUpTCB( pxTCB )
+#else
+/* free_rtos_std::static_thread */
+#define configSUPPORT_STATIC_ALLOCATION	1
+#endif
+
 #define configMAIN_STACK_SIZE 512 // in words (bytes = x4)
 
 /* Co-routine definitions. */
@@ -101,8 +122,40 @@ to exclude the API function. */
 #define INCLUDE_eTaskGetState				1
 #define INCLUDE_xTimerPendFunctionCall		0
 #define INCLUDE_xTaskAbortDelay				1
+#define INCLUDE_xTaskGetSchedulerState		1
 #define INCLUDE_xTaskGetHandle				1
 #define INCLUDE_xSemaphoreGetMutexHolder	1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
+
+/* Time base of std::chrono clocks, see freertos_clock.h. The machine timer
+(mtime) runs at configCPU_CLOCK_HZ in the qemu virt board. */
+unsigned long long ullMachineTimerCount( void );
+#define configSTD_CLOCK_COUNTER()				ullMachineTimerCount()
+#define configSTD_CLOCK_COUNTER_HZ				configCPU_CLOCK_HZ
+
+/* Deferred log, see freertos_log.h. The test output uses it with
+TEST_LOG_OUTPUT set to 1 (cmake -DTEST_LOG_OUTPUT=1; the posix
+target builds test_posix_log.elf with it), see test_helpers.h. */
+#define configSTD_LOG							1
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+/* Tickless idle (cmake -DTICKLESS_IDLE=1). The tick interrupt is suppressed
+while the system is idle, ulTickInterruptCount counts the ones taken. */
+extern volatile unsigned long ulTickInterruptCount;
+void vPortSuppressTicksAndSleep( uint32_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )	vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#define traceTASK_INCREMENT_TICK( xTickCount )				ulTickInterruptCount++
+#endif
+
+#if defined( configSTD_THREAD_STATS ) && ( configSTD_THREAD_STATS == 1 )
+/* Per std::thread statistics (cmake -DTHREAD_STATS=1), see
+freertos_thread_stats.h. */
+void vStdThreadStatsSwitchedIn( void );
+void vStdThreadStatsSwitchedOut( int xStillReady );
+#define traceTASK_SWITCHED_IN()					vStdThreadStatsSwitchedIn()
+#define traceTASK_SWITCHED_OUT()				vStdThreadStatsSwitchedOut( \
+	listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) )
+#endif
 
 #ifndef pdTICKS_TO_MS
 #define pdTICKS_TO_MS(ticks) \
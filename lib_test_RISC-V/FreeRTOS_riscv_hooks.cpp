@@ -18,6 +18,91 @@
 /// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 /// THE SOFTWARE.
 
+#include <cstddef>
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+
+// 64 bit machine timer. The high word is read twice to detect a carry
+// from the low word.
+extern "C" unsigned long long ullMachineTimerCount(void)
+{
+  auto mtime = reinterpret_cast<volatile std::uint32_t *>(configMTIME_BASE_ADDRESS);
+  std::uint32_t hi, lo;
+  do
+  {
+    hi = mtime[1];
+    lo = mtime[0];
+  } while (hi != mtime[1]);
+  return (static_cast<unsigned long long>(hi) << 32) | lo;
+}
+
+#if (configUSE_TICKLESS_IDLE == 1)
+// Machine timer compare of the port (port.c). The tick interrupt writes
+// ullNextTime to mtimecmp and advances it by one tick.
+extern "C" std::uint64_t ullNextTime;
+extern "C" volatile std::uint64_t *pullMachineTimerCompareRegister;
+extern "C" const std::size_t uxTimerIncrementsForOneTick;
+
+volatile unsigned long ulTickInterruptCount;
+
+namespace
+{
+  void set_compare(std::uint64_t value)
+  {
+    // Two 32 bit writes, the compare never goes below the new value.
+    auto cmp = reinterpret_cast<volatile std::uint32_t *>(pullMachineTimerCompareRegister);
+    cmp[0] = 0xFFFFFFFFU;
+    cmp[1] = static_cast<std::uint32_t>(value >> 32);
+    cmp[0] = static_cast<std::uint32_t>(value);
+  }
+}
+
+// mtimecmp holds the time of the next tick. For the idle time it is moved
+// forward to the last expected tick and the hart waits for an interrupt. The
+// ticks which have passed are then added with vTaskStepTick. The chrono
+// clocks read mtime, they are not affected.
+extern "C" void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+  const std::uint64_t period = uxTimerIncrementsForOneTick;
+
+  // mstatus.MIE only; WFI still ends on an interrupt enabled in mie.
+  portDISABLE_INTERRUPTS();
+
+  std::uint64_t next = ullNextTime - period;
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep || ullMachineTimerCount() >= next)
+  {
+    portENABLE_INTERRUPTS();
+    return;
+  }
+
+  // The tick at 'last' is taken by the tick interrupt as usual.
+  std::uint64_t last = next + (xExpectedIdleTime - 1) * period;
+  set_compare(last);
+  ullNextTime = last + period;
+
+  __asm volatile("wfi");
+
+  std::uint64_t now = ullMachineTimerCount();
+  if (now >= last)
+  {
+    // The tick interrupt is pending.
+    vTaskStepTick(xExpectedIdleTime - 1);
+  }
+  else
+  {
+    // Woken up by another interrupt. Count the ticks which have passed and
+    // go back to the next tick.
+    std::uint64_t passed = now >= next ? (now - next) / period + 1 : 0;
+    vTaskStepTick(static_cast<TickType_t>(passed));
+    set_compare(next + passed * period);
+    ullNextTime = next + (passed + 1) * period;
+  }
+
+  portENABLE_INTERRUPTS();
+}
+#endif
+
 extern "C" void interrupt_handler(unsigned int cause)
 {
   (void)cause;
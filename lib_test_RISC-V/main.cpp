@@ -29,16 +29,33 @@
 
 #include "console.h"
 
+#include "freertos_log.h"
 #include "freertos_time.h"
 
 #include "test_thread.h"
+#include "test_static_thread.h"
 #include "test_cv.h"
 #include "test_future.h"
 #include "test_once.h"
 #include "test_mutex.h"
+#include "test_shared_mutex.h"
+#include "test_clock.h"
+#include "test_lock_profiler.h"
+#include "test_trace.h"
+#include "test_thread_stats.h"
+#include "test_precise_sleep.h"
+#include "test_tickless.h"
+#include "test_timer_service.h"
+#include "test_channel.h"
+#include "test_select.h"
+#include "test_spsc_ring.h"
+#include "test_coro.h"
+#include "test_log.h"
+#include "test_isr_notify.h"
 
 #if __cplusplus > 201907L
 #include "test_semaphore_latch_barrier.h"
+#include "test_stop_token.h"
 #include "test_atomic.h"
 #endif
 
@@ -51,6 +68,9 @@ int main(void)
   using namespace std::chrono;
 
   print("RISC-V - start test\n");
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::start(print);
+#endif
 
   SetSystemClockTime(time_point<system_clock>(1550178897s));
 
@@ -59,25 +79,66 @@ int main(void)
   print("Run...\n");
   for (int i = 0; i < 10; i++)
   {
+#if (TEST_LOG_OUTPUT == 1)
+    free_rtos_std::log::write("Iteration - {}\n", i);
+#else
     print("Iteration - ");
     print(i);
     print("\n");
+#endif
 
     TEST_F(TestMtx);
+#if (configSTD_SHARED_MUTEX == 1)
+    TEST_F(TestSharedMtx);
+#endif
+    TEST_F(TestClock);
+#if (configSTD_LOCK_PROFILING == 1)
+    TEST_F(TestLockProfiling);
+#endif
+#if (configSTD_TRACE == 1)
+    TEST_F(TestTrace);
+#endif
+#if (configSTD_THREAD_STATS == 1)
+    TEST_F(TestThreadStats);
+#endif
+#if (configSTD_PRECISE_SLEEP == 1)
+    TEST_F(TestPreciseSleep);
+#endif
+#if (configUSE_TICKLESS_IDLE == 1)
+    TEST_F(TestTickless);
+#endif
+    TEST_F(TestTimerService);
+    TEST_F(TestChannel);
+#if (configUSE_QUEUE_SETS == 1)
+    TEST_F(TestSelect);
+#endif
+    TEST_F(TestSpscRing);
+#if defined(__cpp_impl_coroutine)
+    TEST_F(TestCoro);
+#endif
+#if (configSTD_LOG == 1)
+    TEST_F(TestLog);
+#endif
 
     TEST_F(DetachAfterThreadEnd);
     TEST_F(DetachBeforeThreadEnd);
     TEST_F(JoinAfterThreadEnd);
     TEST_F(JoinBeforeThreadEnd);
+    TEST_F(JoinInLoop);
     TEST_F(DestroyBeforeThreadEnd);
     TEST_F(DestroyNoStart);
     TEST_F(StartAndMoveOperator);
     TEST_F(StartAndMoveConstructor);
     TEST_F(StartWithStackSize);
     TEST_F(AssignWithStackSize);
+    TEST_F(StateOnStack);
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    TEST_F(TestStaticThread);
+#endif
 
 #if __cplusplus > 201907L
     TEST_F(TestJThread);
+    TEST_F(TestStopToken);
 
     // Semaphore is not stable in gcc11 (??)
     // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=104928
@@ -87,11 +148,25 @@ int main(void)
     TEST_F(TestBarrier);
     TEST_F(TestAtomicWait);
 #endif
+    TEST_F(TestLightSemaphore);
+#if (configUSE_TICK_HOOK == 1) && (configUSE_TICKLESS_IDLE == 0)
+    TEST_F(TestIsrNotify);
+#endif
 
     TEST_F(TestConditionVariable);
     TEST_F(TestCallOnce);
     TEST_F(TestFuture);
   }
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::flush();
+#endif
+
+#if (configSTD_TRACE == 1)
+  // Convert with: python3 tools/trace2perfetto.py <console log> trace.json
+  free_rtos_std::trace::enable(false);
+  free_rtos_std::trace::export_text(print);
+#endif
+
   print("OK\n");
   return EXIT_SUCCESS;
 }
@@ -36,16 +36,31 @@ extern "C"
     exit(main());
   }
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  static StaticTask_t s_mainTaskTCB;
+  static StackType_t s_mainTaskStack[configMAIN_STACK_SIZE];
+#endif
+
   void _system_start()
   {
     __libc_init_array();
 
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+    if (NULL == xTaskCreateStatic(free_rtos_main,
+                                  "main",
+                                  configMAIN_STACK_SIZE,
+                                  NULL,
+                                  tskIDLE_PRIORITY + 1,
+                                  s_mainTaskStack,
+                                  &s_mainTaskTCB))
+#else
     if (pdPASS != xTaskCreate(free_rtos_main,
                               "main",
                               configMAIN_STACK_SIZE,
                               NULL,
                               tskIDLE_PRIORITY + 1,
                               NULL))
+#endif
     {
       while (1)
         ;
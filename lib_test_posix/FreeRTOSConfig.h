@@ -0,0 +1,133 @@
+/*
+ * FreeRTOS V202012.00
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://www.github.com/FreeRTOS
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/*-----------------------------------------------------------
+ * Application specific definitions.
+ *
+ * These definitions should be adjusted for your particular hardware and
+ * application requirements.
+ *
+ * THESE PARAMETERS ARE DESCRIBED WITHIN THE 'CONFIGURATION' SECTION OF THE
+ * FreeRTOS API DOCUMENTATION AVAILABLE ON THE FreeRTOS.org WEB SITE.
+ *
+ * See http://www.freertos.org/a00110.html.
+ *----------------------------------------------------------*/
+
+/* Host build on the FreeRTOS GCC/Posix port (cmake -Dposix=1). Every task is
+a pthread, the tick is a SIGALRM timer. Only one task runs at a time. */
+
+#define configUSE_PREEMPTION			1
+#define configUSE_TICKLESS_IDLE			0
+#define configUSE_IDLE_HOOK				0
+#define configUSE_TICK_HOOK				1
+#define configTICK_RATE_HZ				( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES			( 7 )
+/* The port runs each task on its own pthread stack, the FreeRTOS stack only
+holds the thread data. It must still be large enough for the kernel checks. */
+#define configMINIMAL_STACK_SIZE		( ( unsigned short ) 256 )
+#define configTOTAL_HEAP_SIZE			( ( size_t ) ( 4 * 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN			( 16 )
+#define configUSE_TRACE_FACILITY		0
+#define configUSE_16_BIT_TICKS			0
+#define configIDLE_SHOULD_YIELD			1
+#define configUSE_MUTEXES				1
+/* Index 1 is used by the locks of the library, see freertos_mutex.h. */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	2
+#define configQUEUE_REGISTRY_SIZE		8
+#define configCHECK_FOR_STACK_OVERFLOW	0
+#define configUSE_RECURSIVE_MUTEXES		1
+#define configUSE_MALLOC_FAILED_HOOK	1
+#define configUSE_APPLICATION_TASK_TAG	0
+#define configUSE_COUNTING_SEMAPHORES	1
+#define configUSE_QUEUE_SETS			1
+#define configGENERATE_RUN_TIME_STATS	0
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configSUPPORT_STATIC_ALLOCATION	1 /* free_rtos_std::static_thread */
+
+/* The port defines portCLEAN_UP_TCB itself, the zero-heap profile
+(cmake -DSTATIC_ALLOC=1) is not supported. */
+#ifdef STD_STATIC_ALLOCATION
+#error "STATIC_ALLOC is not supported by the posix target"
+#endif
+
+#define configMAIN_STACK_SIZE 1024 // in words (bytes = x8)
+
+/* std::thread default stack, see freertos_thread_attributes.h. */
+#define configDEFAULT_STD_THREAD_STACK_SIZE	1024
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES 			0
+#define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
+
+/* Software timer definitions. */
+#define configUSE_TIMERS				0
+#define configTIMER_TASK_PRIORITY		( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH		6
+#define configTIMER_TASK_STACK_DEPTH	( configMINIMAL_STACK_SIZE * 2 )
+
+/* Set the following definitions to 1 to include the API function, or zero
+to exclude the API function. */
+#define INCLUDE_vTaskPrioritySet			1
+#define INCLUDE_uxTaskPriorityGet			1
+#define INCLUDE_vTaskDelete					1
+#define INCLUDE_vTaskCleanUpResources		1
+#define INCLUDE_vTaskSuspend				1
+#define INCLUDE_vTaskDelayUntil				1
+#define INCLUDE_vTaskDelay					1
+#define INCLUDE_eTaskGetState				1
+#define INCLUDE_xTimerPendFunctionCall		0
+#define INCLUDE_xTaskAbortDelay				1
+#define INCLUDE_xTaskGetHandle				1
+#define INCLUDE_xSemaphoreGetMutexHolder	1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
+#define INCLUDE_xTaskGetSchedulerState		1
+
+/* Time base of std::chrono clocks, see freertos_clock.h. The host monotonic
+clock in nanoseconds. */
+unsigned long long ullHostClockCount( void );
+#define configSTD_CLOCK_COUNTER()				ullHostClockCount()
+#define configSTD_CLOCK_COUNTER_HZ				1000000000ULL
+
+/* Deferred log, see freertos_log.h. The test output uses it with
+TEST_LOG_OUTPUT set to 1 (cmake -DTEST_LOG_OUTPUT=1; the posix
+target builds test_posix_log.elf with it), see test_helpers.h. */
+#define configSTD_LOG							1
+
+/* Tasks are host threads and may be late by a time slice of the host
+scheduler. Upper bounds of the timing tests are extended by this. */
+#define TEST_TIMING_SLACK						std::chrono::milliseconds(20)
+
+#ifndef pdTICKS_TO_MS
+#define pdTICKS_TO_MS(ticks) \
+  ((((long long)(ticks)) * (configTICK_RATE_HZ)) / 1000)
+#endif
+
+#endif /* FREERTOS_CONFIG_H */
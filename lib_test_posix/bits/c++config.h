@@ -0,0 +1,43 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+// Host build (posix target) only.
+//
+// The host libstdc++ is configured for pthreads. Some of its headers then
+// call pthread functions directly on the gthread types, which are FreeRTOS
+// objects here (see FreeRTOS/cpp11_gcc/bits/gthr-default.h). The Linux futex
+// would block a task behind the back of the scheduler. This header is found
+// before the one of the compiler, it includes it and switches those paths
+// off, so the headers use the gthread functions like on the targets.
+
+#ifndef POSIX_CXX_CONFIG_WRAPPER_H
+#define POSIX_CXX_CONFIG_WRAPPER_H
+
+#include_next <bits/c++config.h>
+
+#undef _GLIBCXX_USE_PTHREAD_COND_CLOCKWAIT
+#undef _GLIBCXX_USE_PTHREAD_MUTEX_CLOCKLOCK
+#undef _GLIBCXX_USE_PTHREAD_RWLOCK_CLOCKLOCK
+#undef _GLIBCXX_USE_PTHREAD_RWLOCK_T
+#undef _GLIBCXX_HAVE_LINUX_FUTEX
+#undef _GLIBCXX_NATIVE_THREAD_ID
+#undef _GLIBCXX_USE_NANOSLEEP
+
+#endif // POSIX_CXX_CONFIG_WRAPPER_H
@@ -0,0 +1,49 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include "console.h"
+
+#include <cstring>
+#include <unistd.h>
+
+// write() is a system call without locks in the C library, so a task may be
+// switched out in the middle of it without blocking the others.
+
+void printc(char c)
+{
+  (void)!write(STDOUT_FILENO, &c, 1);
+}
+
+void print(const char *s)
+{
+  (void)!write(STDOUT_FILENO, s, std::strlen(s));
+}
+
+void print(unsigned int num)
+{
+  static const char tab[] = "0123456789ABCDEF";
+  char buf[8];
+  for (int i = 7; i >= 0; i--)
+  {
+    buf[i] = tab[num & 0xF];
+    num >>= 4;
+  }
+  (void)!write(STDOUT_FILENO, buf, sizeof(buf));
+}
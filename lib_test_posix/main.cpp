@@ -0,0 +1,172 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <cassert>
+
+#include "test_helpers.h"
+
+#include "console.h"
+
+#include "freertos_log.h"
+#include "freertos_time.h"
+
+#include "test_thread.h"
+#include "test_static_thread.h"
+#include "test_cv.h"
+#include "test_future.h"
+#include "test_once.h"
+#include "test_mutex.h"
+#include "test_shared_mutex.h"
+#include "test_clock.h"
+#include "test_lock_profiler.h"
+#include "test_trace.h"
+#include "test_thread_stats.h"
+#include "test_precise_sleep.h"
+#include "test_tickless.h"
+#include "test_timer_service.h"
+#include "test_channel.h"
+#include "test_select.h"
+#include "test_spsc_ring.h"
+#include "test_coro.h"
+#include "test_log.h"
+#include "test_isr_notify.h"
+
+#if __cplusplus > 201907L
+#include "test_semaphore_latch_barrier.h"
+#include "test_stop_token.h"
+#include "test_atomic.h"
+#endif
+
+// For updates check my github page:
+// https://github.com/grygorek/FreeRTOS_cpp11
+
+int main(void)
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  print("POSIX - start test\n");
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::start(print);
+#endif
+
+  SetSystemClockTime(time_point<system_clock>(1550178897s));
+
+  std::this_thread::sleep_until(system_clock::now() + 200ms);
+
+  print("Run...\n");
+  for (int i = 0; i < 10; i++)
+  {
+#if (TEST_LOG_OUTPUT == 1)
+    free_rtos_std::log::write("Iteration - {}\n", i);
+#else
+    print("Iteration - ");
+    print(i);
+    print("\n");
+#endif
+
+    TEST_F(TestMtx);
+#if (configSTD_SHARED_MUTEX == 1)
+    TEST_F(TestSharedMtx);
+#endif
+    TEST_F(TestClock);
+#if (configSTD_LOCK_PROFILING == 1)
+    TEST_F(TestLockProfiling);
+#endif
+#if (configSTD_TRACE == 1)
+    TEST_F(TestTrace);
+#endif
+#if (configSTD_THREAD_STATS == 1)
+    TEST_F(TestThreadStats);
+#endif
+#if (configSTD_PRECISE_SLEEP == 1)
+    TEST_F(TestPreciseSleep);
+#endif
+#if (configUSE_TICKLESS_IDLE == 1)
+    TEST_F(TestTickless);
+#endif
+    TEST_F(TestTimerService);
+    TEST_F(TestChannel);
+#if (configUSE_QUEUE_SETS == 1)
+    TEST_F(TestSelect);
+#endif
+    TEST_F(TestSpscRing);
+#if defined(__cpp_impl_coroutine)
+    TEST_F(TestCoro);
+#endif
+#if (configSTD_LOG == 1)
+    TEST_F(TestLog);
+#endif
+
+    TEST_F(DetachAfterThreadEnd);
+    TEST_F(DetachBeforeThreadEnd);
+    TEST_F(JoinAfterThreadEnd);
+    TEST_F(JoinBeforeThreadEnd);
+    TEST_F(JoinInLoop);
+    TEST_F(DestroyBeforeThreadEnd);
+    TEST_F(DestroyNoStart);
+    TEST_F(StartAndMoveOperator);
+    TEST_F(StartAndMoveConstructor);
+    TEST_F(StartWithStackSize);
+    TEST_F(AssignWithStackSize);
+    TEST_F(StateOnStack);
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    TEST_F(TestStaticThread);
+#endif
+
+#if __cplusplus > 201907L
+    TEST_F(TestJThread);
+    TEST_F(TestStopToken);
+
+    // Semaphore is not stable in gcc11 (??)
+    // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=104928
+
+    TEST_F(TestSemaphore);
+    TEST_F(TestLatch);
+    TEST_F(TestBarrier);
+    TEST_F(TestAtomicWait);
+#endif
+    TEST_F(TestLightSemaphore);
+#if (configUSE_TICK_HOOK == 1) && (configUSE_TICKLESS_IDLE == 0)
+    TEST_F(TestIsrNotify);
+#endif
+
+    TEST_F(TestConditionVariable);
+    TEST_F(TestCallOnce);
+    TEST_F(TestFuture);
+  }
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::flush();
+#endif
+
+#if (configSTD_TRACE == 1)
+  // Convert with: python3 tools/trace2perfetto.py <console log> trace.json
+  free_rtos_std::trace::enable(false);
+  free_rtos_std::trace::export_text(print);
+#endif
+
+  print("OK\n");
+  return EXIT_SUCCESS;
+}
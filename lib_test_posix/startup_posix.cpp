@@ -0,0 +1,144 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+// Start up of the host build (posix target).
+//
+// The executables are linked with --wrap=main. The C runtime calls
+// __wrap_main, which runs the application main() as the first task of the
+// scheduler, like the startup code of the targets.
+
+#include <cstdlib>
+#include <new>
+#include <sys/time.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+namespace
+{
+  unsigned long long s_clockStart;
+
+  unsigned long long monotonic_ns()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+  }
+}
+
+extern "C"
+{
+  int __real_main();
+
+  static void free_rtos_main(void *)
+  {
+    exit(__real_main());
+  }
+
+  int __wrap_main()
+  {
+    s_clockStart = monotonic_ns();
+
+    if (pdPASS != xTaskCreate(free_rtos_main,
+                              "main",
+                              configMAIN_STACK_SIZE,
+                              NULL,
+                              tskIDLE_PRIORITY + 1,
+                              NULL))
+    {
+      return EXIT_FAILURE;
+    }
+
+    // Does not return, the process ends with exit() of the main task.
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+  }
+
+  // Time base of std::chrono clocks (configSTD_CLOCK_COUNTER). Nanoseconds
+  // of the monotonic clock since start up.
+  unsigned long long ullHostClockCount(void)
+  {
+    return monotonic_ns() - s_clockStart;
+  }
+
+  // newlib calls _gettimeofday of freertos_time.cpp, glibc does not. The
+  // executables are linked with --wrap=gettimeofday, so the time follows
+  // SetSystemClockTime like on the targets.
+  int _gettimeofday(timeval *tv, void *tzvp);
+
+  int __wrap_gettimeofday(timeval *tv, void *tzvp)
+  {
+    return _gettimeofday(tv, tzvp);
+  }
+}
+
+// operator new of the host. A task can be switched out at any point, also
+// while the C library malloc holds its lock, and the next task would wait
+// for it forever. The scheduler is suspended around the call instead.
+// pvPortMalloc does that too, but its alignment (portBYTE_ALIGNMENT) is
+// less than the 16 bytes the host compiler expects from operator new.
+namespace
+{
+  template <typename F>
+  auto no_switch(F f)
+  {
+    const bool fRunning = xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+    if (fRunning)
+      vTaskSuspendAll();
+    auto r = f();
+    if (fRunning)
+      xTaskResumeAll();
+    return r;
+  }
+}
+
+void *operator new(size_t count)
+{
+  return no_switch([count] { return malloc(count); });
+}
+
+void *operator new[](size_t count)
+{
+  return operator new(count);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  no_switch([ptr] {
+    free(ptr);
+    return 0;
+  });
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+  operator delete(ptr);
+}
@@ -0,0 +1,160 @@
+# Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+# 
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+# 
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+# 
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+cmake_minimum_required(VERSION 3.10)
+
+# Host settings, FreeRTOS GCC/Posix port
+###########################################
+message(STATUS "Building: host, FreeRTOS GCC/Posix port")
+set(CPU_ARCH "Posix")
+
+set(APPLICATION_DIR "lib_test_posix")
+
+# The port is not part of this repository. Copy 'portable/ThirdParty/GCC/Posix'
+# of the FreeRTOS-Kernel release matching FreeRTOS/Source (V10.4.3) to the
+# default location, or point to it with -DFREERTOS_POSIX_PORT=<dir>.
+set(FREERTOS_POSIX_PORT "${CMAKE_SOURCE_DIR}/FreeRTOS/Source/portable/ThirdParty/GCC/Posix"
+    CACHE PATH "Directory of the FreeRTOS GCC/Posix port")
+if(NOT EXISTS "${FREERTOS_POSIX_PORT}/port.c")
+  message(FATAL_ERROR "FreeRTOS GCC/Posix port not found in ${FREERTOS_POSIX_PORT}")
+endif()
+
+find_package(Threads REQUIRED)
+
+# The application main() runs as the first task and gettimeofday reads the
+# library clock, see startup_posix.cpp.
+set(CMAKE_EXE_LINKER_FLAGS "-Wl,--wrap=main -Wl,--wrap=gettimeofday")
+
+###################
+# Project settings
+###################
+
+#      Build Settings
+#------------------------
+SET(COMPILE_PART_FLAGS  "-O2 -g")
+if(DEBUG)
+  SET(COMPILE_PART_FLAGS  "-O0 -g3")
+endif(DEBUG)
+
+# Sanitizer (-DSANITIZE=address, undefined, ...), passed to -fsanitize.
+if(SANITIZE)
+  SET(COMPILE_PART_FLAGS  "${COMPILE_PART_FLAGS} -fsanitize=${SANITIZE} -fno-omit-frame-pointer")
+  set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} -fsanitize=${SANITIZE}")
+endif(SANITIZE)
+
+SET(COMPILE_COMMON_FLAGS "${CONFIG_DEFS} ${COMPILE_PART_FLAGS} -Wall -Wextra -fno-common -fmessage-length=0")
+
+# GNU dialects, the port uses POSIX signals and pthreads.
+SET(CMAKE_C_FLAGS   "${COMPILE_COMMON_FLAGS} -std=gnu17" CACHE INTERNAL "" FORCE)
+SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=gnu++2a -fcoroutines -fno-exceptions -fno-rtti" CACHE INTERNAL "" FORCE)
+
+# APPLICATION_DIR goes first, its bits/c++config.h wraps the one of the host.
+include_directories( 
+  ${APPLICATION_DIR}
+
+  test
+  bench
+
+  FreeRTOS/Source/include 
+  FreeRTOS 
+  ${FREERTOS_POSIX_PORT}
+  ${FREERTOS_POSIX_PORT}/utils
+  FreeRTOS/cpp11_gcc
+)
+
+# Select the right directory for the compiler version
+if(CMAKE_CXX_COMPILER_VERSION LESS 11)
+  SET(GCC_VER_DIR "v10")
+elseif(CMAKE_CXX_COMPILER_VERSION LESS 12)
+  SET(GCC_VER_DIR "v11")
+else()
+  SET(GCC_VER_DIR "v13")
+endif(CMAKE_CXX_COMPILER_VERSION LESS 11)
+
+add_subdirectory(FreeRTOS)
+
+# The host has libatomic, only the gthread parts of libstdc++ are replaced.
+add_library(std++_freertos STATIC
+  libstdc++_gcc/${GCC_VER_DIR}/future.cc
+  libstdc++_gcc/${GCC_VER_DIR}/mutex.cc
+  libstdc++_gcc/${GCC_VER_DIR}/condition_variable.cc
+)
+
+# No sys.cpp and FreeRTOS_memory.cpp, the host C library has its own
+# malloc. startup_posix.cpp defines operator new.
+set(PLATFORM_SOURCES
+  ${APPLICATION_DIR}/startup_posix.cpp
+  ${APPLICATION_DIR}/console.cpp
+
+  sys_common/FreeRTOS_hooks.cpp
+)
+
+add_executable(${PROJECT_NAME}.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/main.cpp
+)
+
+target_link_libraries(
+  ${PROJECT_NAME}.elf
+  freeRTOS
+  std++_freertos
+  Threads::Threads
+)
+
+# The same tests with the output through the deferred log, see
+# test/test_helpers.h.
+add_executable(${PROJECT_NAME}_log.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/main.cpp
+)
+target_compile_definitions(${PROJECT_NAME}_log.elf PRIVATE TEST_LOG_OUTPUT=1)
+
+target_link_libraries(
+  ${PROJECT_NAME}_log.elf
+  freeRTOS
+  std++_freertos
+  Threads::Threads
+)
+
+# Micro-benchmarks
+add_executable(bench_posix.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/bench_main.cpp
+)
+
+target_link_libraries(
+  bench_posix.elf
+  freeRTOS
+  std++_freertos
+  Threads::Threads
+)
+
+enable_testing()
+add_test(NAME test_posix COMMAND ${PROJECT_NAME}.elf)
+set_tests_properties(test_posix PROPERTIES
+  PASS_REGULAR_EXPRESSION "OK\n"
+  FAIL_REGULAR_EXPRESSION "FAILED"
+  TIMEOUT 600)
+
+add_test(NAME test_posix_log COMMAND ${PROJECT_NAME}_log.elf)
+set_tests_properties(test_posix_log PROPERTIES
+  PASS_REGULAR_EXPRESSION "OK\n"
+  FAIL_REGULAR_EXPRESSION "FAILED"
+  TIMEOUT 600)
@@ -52,7 +52,7 @@ SET(COMPILE_COMMON_FLAGS "${CONFIG_DEFS} ${COMPILE_PART_FLAGS} -Wall -Wextra -Wp
 # When enabling exceptions, change the linker script to link libstdc++.a instead of libstdc++_nano.a
 # Note: It is expect LM3S811 has got not enough memory to build with full libstdc++.
 SET(CMAKE_C_FLAGS   "${COMPILE_COMMON_FLAGS} -std=c17 -nostdlib -fno-builtin " CACHE INTERNAL "" FORCE)
-SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -nostdlib -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
+SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -fcoroutines -nostdlib -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
 SET(CMAKE_ASM_FLAGS "-x assembler-with-cpp ${COMPILE_PART_FLAGS}"  CACHE INTERNAL "" FORCE)
 
 # definition required by the demo project
@@ -85,6 +85,7 @@ add_executable(${PROJECT_NAME}.elf
   sys_common/FreeRTOS_hooks.cpp
   sys_common/FreeRTOS_memory.cpp
   sys_common/sys.cpp
+  sys_common/systick_clock.cpp
   
   qemu_lm3s811/startup.cpp
   qemu_lm3s811/main.cpp
@@ -103,6 +103,12 @@ standard names. */
 //#define xPortPendSVHandler PendSV_Handler
 //#define xPortSysTickHandler SysTick_Handler
 
+/* Time base of std::chrono clocks, see freertos_clock.h. SysTick runs at
+the core clock. */
+unsigned long long ullSysTickCount( void );
+#define configSTD_CLOCK_COUNTER()		ullSysTickCount()
+#define configSTD_CLOCK_COUNTER_HZ		20000000ULL
+
 #ifndef pdTICKS_TO_MS
 #define pdTICKS_TO_MS(ticks) \
   ((((long long)(ticks)) * (configTICK_RATE_HZ)) / 1000)
@@ -53,13 +53,14 @@ SET(COMPILE_COMMON_FLAGS "${CONFIG_DEFS} ${COMPILE_PART_FLAGS} -Wall -Wextra -Wp
 
 # When enabling exceptions, change the linker script to link libstdc++.a instead of libstdc++_nano.a
 SET(CMAKE_C_FLAGS   "${COMPILE_COMMON_FLAGS} -std=c17  -nostdlib -ffreestanding -fno-builtin " CACHE INTERNAL "" FORCE)
-SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -nostdlib -ffreestanding -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
+SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -fcoroutines -nostdlib -ffreestanding -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
 SET(CMAKE_ASM_FLAGS "-x assembler-with-cpp ${COMPILE_PART_FLAGS} -DportasmHANDLE_INTERRUPT=interrupt_handler"  CACHE INTERNAL "" FORCE)
 
 include_directories( 
   ${APPLICATION_DIR}
   
   test
+  bench
 
   FreeRTOS/Source/include 
   FreeRTOS 
@@ -77,20 +78,36 @@ endif(CMAKE_CXX_COMPILER_VERSION LESS 11)
 add_subdirectory(FreeRTOS)
 add_subdirectory(libstdc++_gcc/${GCC_VER_DIR})
 
-add_executable(${PROJECT_NAME}.elf
+set(PLATFORM_SOURCES
   ${APPLICATION_DIR}/startup_riscv.S
   ${APPLICATION_DIR}/startup_riscv.cpp
   ${APPLICATION_DIR}/console.cpp
   ${APPLICATION_DIR}/FreeRTOS_riscv_hooks.cpp
-  ${APPLICATION_DIR}/main.cpp
 
   sys_common/FreeRTOS_hooks.cpp
   sys_common/FreeRTOS_memory.cpp
   sys_common/sys.cpp
 )
 
+add_executable(${PROJECT_NAME}.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/main.cpp
+)
+
 target_link_libraries(
   ${PROJECT_NAME}.elf
   freeRTOS
   std++_freertos
 )
+
+# Micro-benchmarks
+add_executable(bench_riscv.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/bench_main.cpp
+)
+
+target_link_libraries(
+  bench_riscv.elf
+  freeRTOS
+  std++_freertos
+)
@@ -23,7 +23,7 @@
 
 // Idle task
 StaticTask_t g_idleTaskTCB;
-StackType_t g_idleTaskStack[96];
+StackType_t g_idleTaskStack[configMINIMAL_STACK_SIZE];
 
 // Timer task
 StaticTask_t g_timerTaskTCB;
@@ -31,7 +31,14 @@ StackType_t g_timerTaskStack[256];
 
 extern "C"
 {
-  void vApplicationTickHook() {}
+  // Set by the tests to run code in the tick interrupt.
+  void (*volatile g_tickHook)(void);
+
+  void vApplicationTickHook()
+  {
+    if (auto hook = g_tickHook)
+      hook();
+  }
 
   void vApplicationMallocFailedHook()
   {
@@ -49,7 +56,7 @@ extern "C"
   {
     *ppxIdleTaskTCBBuffer = &g_idleTaskTCB;
     *ppxIdleTaskStackBuffer = g_idleTaskStack;
-    *pulIdleTaskStackSize = 96;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
   }
 
   void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize)
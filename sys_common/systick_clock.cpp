@@ -0,0 +1,61 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+// Clock counter for Cortex-M targets (configSTD_CLOCK_COUNTER).
+//
+// SysTick counts down from the reload value and the kernel counts its
+// wraps (ticks). Together they give a counter running at the SysTick
+// clock.
+
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "freertos_clock.h"
+
+namespace
+{
+  volatile std::uint32_t &SYST_RVR = *reinterpret_cast<volatile std::uint32_t *>(0xE000E014);
+  volatile std::uint32_t &SYST_CVR = *reinterpret_cast<volatile std::uint32_t *>(0xE000E018);
+  volatile std::uint32_t &SCB_ICSR = *reinterpret_cast<volatile std::uint32_t *>(0xE000ED04);
+  constexpr std::uint32_t ICSR_PENDSTSET{1U << 26};
+}
+
+extern "C" unsigned long long ullSysTickCount(void)
+{
+  std::uint64_t ticks;
+  std::uint32_t value, pending;
+  while (1)
+  {
+    ticks = free_rtos_std::tick_count64();
+    pending = SCB_ICSR & ICSR_PENDSTSET;
+    value = SYST_CVR;
+    // A wrap not yet handled by the tick interrupt (e.g. interrupts are
+    // masked) shows as the pending bit. Read again if anything changed
+    // in the meantime.
+    if (pending == (SCB_ICSR & ICSR_PENDSTSET) && ticks == free_rtos_std::tick_count64())
+      break;
+  }
+
+  const std::uint64_t period = SYST_RVR + 1ULL;
+  std::uint64_t count = ticks * period + (period - 1 - value);
+  if (pending)
+    count += period;
+  return count;
+}
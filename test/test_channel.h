@@ -0,0 +1,151 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __CHANNEL_TEST_H__
+#define __CHANNEL_TEST_H__
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+#include "freertos_channel.h"
+#include "test_helpers.h"
+
+inline void TestChannelFifo()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::channel<int, 4> ch;
+  TEST_ASSERT(ch.empty());
+  for (int i = 0; i < 4; i++)
+    TEST_ASSERT(ch.try_send(i));
+  TEST_ASSERT(!ch.try_send(4)); // full
+  TEST_ASSERT(!ch.send_for(4, 2ms));
+  TEST_ASSERT(ch.size() == 4);
+
+  for (int i = 0; i < 4; i++)
+    TEST_ASSERT(ch.recv() == i);
+  TEST_ASSERT(!ch.try_recv());
+}
+
+inline void TestChannelTimeout()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  free_rtos_std::channel<int, 2> ch;
+  auto t0 = steady_clock::now();
+  TEST_ASSERT(!ch.recv_for(10ms));
+  auto t = steady_clock::now() - t0;
+  TEST_ASSERT(t >= 10ms && t < 15ms + TEST_TIMING_SLACK);
+
+  TEST_ASSERT(!ch.recv_until(steady_clock::now() - 1ms)); // already expired
+}
+
+inline void TestChannelThreads()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::channel<int, 3> ch;
+  constexpr int COUNT{100};
+  std::thread producer{[&] {
+    for (int i = 0; i < COUNT; i++)
+      ch.send(i);
+  }};
+
+  int sum{0};
+  bool fOrdered{true};
+  for (int i = 0; i < COUNT; i++)
+  {
+    auto v = ch.recv_for(100ms);
+    fOrdered = fOrdered && v && *v == i;
+    sum += v.value_or(0);
+  }
+  producer.join();
+
+  TEST_ASSERT(fOrdered);
+  TEST_ASSERT(sum == COUNT * (COUNT - 1) / 2);
+}
+
+inline void TestChannelOwnership()
+{
+  using namespace std::chrono_literals;
+
+  struct message
+  {
+    int id;
+    char payload[200];
+  };
+
+  free_rtos_std::channel<std::unique_ptr<message>, 2> ch;
+  auto m = std::make_unique<message>();
+  m->id = 7;
+  auto raw = m.get();
+  TEST_ASSERT(ch.try_send(std::move(m)));
+  TEST_ASSERT(m == nullptr); // moved in
+
+  auto full = std::make_unique<message>();
+  TEST_ASSERT(ch.try_send(std::make_unique<message>()));
+  TEST_ASSERT(!ch.try_send(std::move(full)));
+  TEST_ASSERT(full != nullptr); // still owned by the caller
+
+  auto r = ch.recv_for(1ms);
+  TEST_ASSERT(r.get() == raw); // the object has not been copied
+  TEST_ASSERT(r->id == 7);
+  // the second one is deleted by the channel
+}
+
+inline void TestByteStream()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::byte_stream<16> s;
+  const std::byte out[]{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}};
+  TEST_ASSERT(s.write(out) == 5);
+  TEST_ASSERT(s.size() == 5);
+
+  std::byte in[8]{};
+  auto r = s.read_for(in, 1ms);
+  TEST_ASSERT(r.size() == 5);
+  TEST_ASSERT(r.data() == in);
+  TEST_ASSERT(r[0] == std::byte{1} && r[4] == std::byte{5});
+  TEST_ASSERT(s.try_read(in).empty());
+
+  // reader waits for the writer
+  std::thread writer{[&] {
+    std::this_thread::sleep_for(5ms);
+    s.write(std::span{out}.first(2));
+  }};
+  r = s.read_for(in, 50ms);
+  writer.join();
+  TEST_ASSERT(r.size() == 2);
+}
+
+inline void TestChannel()
+{
+  TestChannelFifo();
+  TestChannelTimeout();
+  TestChannelThreads();
+  TestChannelOwnership();
+  TestByteStream();
+}
+
+#endif //__CHANNEL_TEST_H__
@@ -0,0 +1,162 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __CLOCK_TEST_H__
+#define __CLOCK_TEST_H__
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "freertos_clock.h"
+#include "freertos_time.h"
+#include "test_helpers.h"
+
+inline void TestSteadyClockMonotonic()
+{
+  using namespace std::chrono;
+
+  auto prev = steady_clock::now();
+  bool fMonotonic{true};
+  for (int i = 0; i < 1000; i++)
+  {
+    auto now = steady_clock::now();
+    fMonotonic = fMonotonic && now >= prev;
+    prev = now;
+  }
+  TEST_ASSERT(fMonotonic);
+}
+
+inline void TestSteadyClockResolution()
+{
+#ifdef configSTD_CLOCK_COUNTER
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  // with a hardware counter two readings differ by much less than a tick
+  auto t0 = steady_clock::now();
+  auto t1 = steady_clock::now();
+  while (t1 == t0)
+    t1 = steady_clock::now();
+  TEST_ASSERT(t1 - t0 < 100us + TEST_TIMING_SLACK);
+#endif
+}
+
+inline void TestSystemClockSet()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  auto now = system_clock::now();
+  SetSystemClockTime(now + 1h);
+  auto later = system_clock::now();
+  TEST_ASSERT(later - now >= 1h);
+  TEST_ASSERT(later - now < 1h + 10ms + TEST_TIMING_SLACK);
+
+  // gettimeofday gives the same time
+  timeval tv{};
+  gettimeofday(&tv, nullptr);
+  TEST_ASSERT(seconds(tv.tv_sec) - duration_cast<seconds>(later.time_since_epoch()) <= 1s);
+
+  SetSystemClockTime(system_clock::now() - 1h);
+}
+
+inline void TestSleepForMeasured()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  auto t0 = steady_clock::now();
+  std::this_thread::sleep_for(10ms);
+  auto t = steady_clock::now() - t0;
+  TEST_ASSERT(t >= 9ms); // the first tick may be partial
+  TEST_ASSERT(t < 20ms + TEST_TIMING_SLACK);
+}
+
+inline void TestTickCount64()
+{
+  // low part is the kernel tick count
+  auto before = xTaskGetTickCount();
+  auto ticks = free_rtos_std::tick_count64();
+  auto after = xTaskGetTickCount();
+  TEST_ASSERT(static_cast<TickType_t>(static_cast<TickType_t>(ticks) - before) <=
+              static_cast<TickType_t>(after - before));
+
+  TEST_ASSERT(free_rtos_std::ns_to_ticks(-1) == 0);
+  TEST_ASSERT(free_rtos_std::ns_to_ticks(1) == 1);
+  TEST_ASSERT(free_rtos_std::ns_to_ticks(1'000'000'000LL / configTICK_RATE_HZ) == 1);
+  // one tick more for the partial current tick, an expired timeout polls
+  TEST_ASSERT(free_rtos_std::timeout_ticks(0) == 0);
+  TEST_ASSERT(free_rtos_std::timeout_ticks(1) == 2);
+  // saturates below portMAX_DELAY when TickType_t is 32 bits wide
+  TEST_ASSERT(free_rtos_std::timeout_ticks(INT64_MAX) ==
+              std::min<std::uint64_t>(free_rtos_std::ns_to_ticks(INT64_MAX) + 1, portMAX_DELAY - 1));
+}
+
+// Built with -DTICK_WRAP_TEST=1 the kernel starts a few seconds before the
+// tick count wraps. The first run of the test waits for the wrap and checks
+// the clocks and a timed wait across it.
+inline void TestTickWrap()
+{
+#if (configINITIAL_TICK_COUNT != 0)
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  constexpr std::uint64_t WRAP{1ULL << (sizeof(TickType_t) * 8)};
+
+  auto ticks = free_rtos_std::tick_count64();
+  if (ticks < WRAP)
+  {
+    auto left = WRAP - ticks;
+    if (left > 5)
+      vTaskDelay(static_cast<TickType_t>(left - 5));
+
+    auto t0 = steady_clock::now();
+    auto k0 = free_rtos_std::tick_count64();
+    TEST_ASSERT(k0 < WRAP);
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::unique_lock<std::mutex> lk(m);
+    auto status = cv.wait_for(lk, 20ms);
+
+    auto t = steady_clock::now() - t0;
+    TEST_ASSERT(status == std::cv_status::timeout);
+    TEST_ASSERT(t >= 19ms);
+    TEST_ASSERT(t < 40ms + TEST_TIMING_SLACK);
+    TEST_ASSERT(steady_clock::now() > t0);
+  }
+  TEST_ASSERT(free_rtos_std::tick_count64() >= WRAP);
+#endif
+}
+
+inline void TestClock()
+{
+  TestSteadyClockMonotonic();
+  TestSteadyClockResolution();
+  TestSystemClockSet();
+  TestSleepForMeasured();
+  TestTickCount64();
+  TestTickWrap();
+}
+
+#endif //__CLOCK_TEST_H__
@@ -0,0 +1,266 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __CORO_TEST_H__
+#define __CORO_TEST_H__
+
+#include "freertos_coro.h"
+#include "freertos_log.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "test_helpers.h"
+
+namespace coro_test
+{
+  using namespace free_rtos_std;
+  using namespace std::chrono_literals;
+
+  // Coroutines take their state by pointer, a lambda with captures would not
+  // outlive its first suspension.
+
+  inline coro::task<int> answer()
+  {
+    co_await coro::yield();
+    co_return 42;
+  }
+
+  inline coro::task<> ask(int *result) { *result = co_await answer(); }
+
+  inline coro::task<> timed_sleep(std::chrono::steady_clock::duration *took)
+  {
+    auto t0 = std::chrono::steady_clock::now();
+    co_await coro::sleep_for(10ms);
+    *took = std::chrono::steady_clock::now() - t0;
+  }
+
+  inline coro::task<> sleeper(std::chrono::milliseconds d, std::atomic<int> *done)
+  {
+    co_await coro::sleep_for(d);
+    done->fetch_add(1);
+  }
+
+  inline coro::task<> locker(coro::mutex *m, int *shared, int *inside, bool *overlap)
+  {
+    for (int i = 0; i < 10; i++)
+    {
+      co_await m->lock();
+      std::lock_guard<coro::mutex> guard{*m, std::adopt_lock};
+      if ((*inside)++)
+        *overlap = true;
+      co_await coro::yield(); // others run, but not in here
+      (*shared)++;
+      (*inside)--;
+    }
+  }
+
+  inline coro::task<> limited(coro::semaphore *s, std::atomic<int> *inside, std::atomic<int> *peak)
+  {
+    co_await s->acquire();
+    int n = ++*inside;
+    int p = *peak;
+    while (n > p && !peak->compare_exchange_weak(p, n))
+      ;
+    co_await coro::sleep_for(2ms);
+    --*inside;
+    s->release();
+  }
+
+  inline coro::task<> consume(coro::queue<int, 4> *q, int count, int *sum)
+  {
+    for (int i = 0; i < count; i++)
+      *sum += co_await q->receive();
+  }
+
+  inline coro::task<> waiter(coro::event *e, std::atomic<int> *woken)
+  {
+    co_await e->wait();
+    ++*woken;
+  }
+}
+
+inline void TestCoroTask()
+{
+  using namespace coro_test;
+
+  coro::executor ex;
+  int result{0};
+  ex.spawn(ask(&result));
+  ex.join();
+  TEST_EQ(42, result);
+  TEST_EQ(0U, ex.active());
+}
+
+inline void TestCoroSleep()
+{
+  using namespace coro_test;
+
+  coro::executor ex;
+  std::chrono::steady_clock::duration took{};
+  ex.spawn(timed_sleep(&took));
+  ex.join();
+  TEST_ASSERT(took >= 10ms && took < 15ms + TEST_TIMING_SLACK);
+}
+
+inline void TestCoroMany()
+{
+  using namespace coro_test;
+
+  constexpr int COUNT{100};
+  std::atomic<int> done{0};
+  {
+    coro::executor ex{2};
+    for (int i = 0; i < COUNT; i++)
+      ex.spawn(sleeper(std::chrono::milliseconds(i % 10), &done));
+    ex.join();
+  }
+  TEST_EQ(COUNT, done.load());
+
+  auto stats = coro::frame_pool_statistics();
+  TEST_EQ(0U, stats.in_use);
+  TEST_ASSERT(stats.peak > 0); // frames came from the pool
+}
+
+inline void TestCoroMutex()
+{
+  using namespace coro_test;
+
+  coro::executor ex{2};
+  coro::mutex m;
+  int shared{0}, inside{0};
+  bool overlap{false};
+  for (int i = 0; i < 4; i++)
+    ex.spawn(locker(&m, &shared, &inside, &overlap));
+  ex.join();
+  TEST_EQ(40, shared);
+  TEST_ASSERT(!overlap);
+}
+
+inline void TestCoroSemaphore()
+{
+  using namespace coro_test;
+
+  coro::executor ex{2};
+  coro::semaphore s{2};
+  std::atomic<int> inside{0}, peak{0};
+  for (int i = 0; i < 6; i++)
+    ex.spawn(limited(&s, &inside, &peak));
+  ex.join();
+  TEST_EQ(2, peak.load());
+  TEST_EQ(2, s.count());
+}
+
+inline void TestCoroQueue()
+{
+  using namespace coro_test;
+
+  coro::executor ex;
+  coro::queue<int, 4> q;
+  int sum{0};
+  ex.spawn(consume(&q, 20, &sum));
+  for (int i = 0; i < 20; i++)
+    q.send(i); // blocks while the queue is full
+  ex.join();
+  TEST_EQ(190, sum);
+}
+
+inline void TestCoroEvent()
+{
+  using namespace coro_test;
+
+  coro::executor ex;
+  coro::event e;
+  std::atomic<int> woken{0};
+  ex.spawn(waiter(&e, &woken));
+  ex.spawn(waiter(&e, &woken));
+  std::this_thread::sleep_for(5ms);
+  TEST_EQ(0, woken.load());
+
+  e.set(); // one at a time
+  std::this_thread::sleep_for(2ms);
+  TEST_EQ(1, woken.load());
+  e.set();
+  ex.join();
+  TEST_EQ(2, woken.load());
+
+  e.set(); // nobody waits, stays set
+  ex.spawn(waiter(&e, &woken));
+  ex.join();
+  TEST_EQ(3, woken.load());
+}
+
+#if defined(CONSOLE_HAS_RX) && (CONSOLE_HAS_LOOPBACK == 1)
+// UART receive interrupt sets the event. The UART is switched to loopback,
+// so a printed character is the interrupt source.
+inline free_rtos_std::coro::event g_uartEvent;
+
+inline void uart_rx_to_event(char)
+{
+  BaseType_t woken{pdFALSE};
+  g_uartEvent.set_from_isr(woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+inline void TestCoroIsrEvent()
+{
+  using namespace coro_test;
+
+  coro::executor ex;
+  std::atomic<int> woken{0};
+  g_uartEvent.reset();
+  ex.spawn(waiter(&g_uartEvent, &woken));
+
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::flush(); // the drain task must not print into the loopback
+#endif
+  console_rx_start(uart_rx_to_event, true);
+  print("coro\n");
+  std::this_thread::sleep_for(20ms);
+  console_rx_stop();
+
+  TEST_EQ(1, woken.load());
+  if (woken == 0)
+    g_uartEvent.set(); // reported above, the waiter still has to finish
+  ex.join();
+}
+#endif
+
+inline void TestCoro()
+{
+  TestCoroTask();
+  TestCoroSleep();
+  TestCoroMany();
+  TestCoroMutex();
+  TestCoroSemaphore();
+  TestCoroQueue();
+  TestCoroEvent();
+#if defined(CONSOLE_HAS_RX) && (CONSOLE_HAS_LOOPBACK == 1)
+  TestCoroIsrEvent();
+#endif
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // __CORO_TEST_H__
@@ -27,9 +27,15 @@
 #include <condition_variable>
 #include <queue>
 #include <array>
+#include <atomic>
+#include <shared_mutex>
+#include <stop_token>
 
 #include <cassert>
 
+#include "freertos_condition_variable_any.h"
+#include "test_helpers.h"
+
 inline void TestCVTimeout()
 {
   // Idea of this test is to force condition variable to timeout.
@@ -46,7 +52,9 @@ inline void TestCVTimeout()
 
   { // test generic timeout
     std::unique_lock<std::mutex> lock{m};
+    auto start = std::chrono::steady_clock::now();
     assert(false == cv.wait_for(lock, std::chrono::milliseconds(10), [&q, &fCancel] { return q.size() > 0 || fCancel; }));
+    TEST_ASSERT(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
   }
 
   auto processFoo{[&](std::int32_t idx) {
@@ -130,11 +138,12 @@ inline void TestCV()
   processor.join();
 }
 
-inline void TestCVAny()
+template <typename CV>
+void TestCVAnyQueue()
 {
   std::queue<int> q;
   std::mutex m;
-  std::condition_variable_any cv;
+  CV cv;
 
   std::thread processor{[&]() {
     m.lock();
@@ -165,6 +174,78 @@ inline void TestCVAny()
   processor.join();
 }
 
+inline void TestNativeCVAny()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  free_rtos_std::condition_variable_any cv;
+
+  // Timeouts, nobody notifies.
+  {
+    std::mutex m;
+    std::unique_lock<std::mutex> lock{m};
+    auto start = steady_clock::now();
+    TEST_ASSERT(cv.wait_for(lock, 10ms) == std::cv_status::timeout);
+    TEST_ASSERT(steady_clock::now() - start >= 10ms);
+    TEST_ASSERT(!cv.wait_until(lock, steady_clock::now() + 5ms, [] { return false; }));
+    TEST_ASSERT(lock.owns_lock());
+  }
+
+  // Readers under a shared lock, all woken at once.
+  {
+    constexpr int READERS{3};
+    std::shared_mutex m;
+    int version{0};
+    std::atomic<int> seen{0};
+    std::thread r[READERS];
+    for (auto &t : r)
+      t = std::thread{[&] {
+        std::shared_lock<std::shared_mutex> lock{m};
+        cv.wait(lock, [&] { return version != 0; });
+        seen++;
+      }};
+
+    std::this_thread::sleep_for(10ms);
+    {
+      std::lock_guard<std::shared_mutex> lock{m};
+      version = 1;
+    }
+    cv.notify_all();
+    for (auto &t : r)
+      t.join();
+    TEST_EQ(READERS, seen.load());
+  }
+
+  // A stop request ends the wait with the predicate still false.
+  {
+    std::mutex m;
+    std::atomic<int> result{-1};
+    auto start = steady_clock::now();
+    {
+      std::jthread t{[&](std::stop_token st) {
+        std::unique_lock<std::mutex> lock{m};
+        result = cv.wait(lock, st, [] { return false; });
+      }};
+      std::this_thread::sleep_for(10ms);
+    }
+    TEST_EQ(0, result.load());
+    TEST_ASSERT(steady_clock::now() - start < 100ms);
+
+    // No stop possible, the timeout.
+    std::unique_lock<std::mutex> lock{m};
+    TEST_ASSERT(!cv.wait_for(lock, std::stop_token{}, 5ms, [] { return false; }));
+    TEST_ASSERT(cv.wait_for(lock, std::stop_token{}, 5ms, [] { return true; }));
+  }
+}
+
+inline void TestCVAny()
+{
+  TestCVAnyQueue<std::condition_variable_any>();
+  TestCVAnyQueue<free_rtos_std::condition_variable_any>();
+  TestNativeCVAny();
+}
+
 inline void TestNotifyAllAtThrdExit()
 {
   std::condition_variable cv;
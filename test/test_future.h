@@ -26,6 +26,11 @@
 #include <chrono>
 #include <cassert>
 #include <cstdint>
+#include <memory>
+
+#include "freertos_future.h"
+#include "freertos_timer_service.h"
+#include "test_helpers.h"
 
 inline void TestAsync()
 {
@@ -111,12 +116,185 @@ inline void TestPackagedTask()
   assert(11 == result.get());
 }
 
+inline void TestLightFuture()
+{
+  using namespace std::chrono_literals;
+
+  const auto in_use = free_rtos_std::future_pool_statistics().in_use;
+
+  // Ready before get.
+  {
+    free_rtos_std::promise<int> p;
+    auto f = p.get_future();
+    TEST_ASSERT(f.valid());
+    p.set_value(4);
+    TEST_ASSERT(f.wait_for(0ms) == std::future_status::ready);
+    TEST_EQ(4, f.get());
+    TEST_ASSERT(!f.valid());
+  }
+
+  // get waits for another thread.
+  {
+    free_rtos_std::promise<std::unique_ptr<int>> p;
+    auto f = p.get_future();
+    std::thread t{[&p] {
+      std::this_thread::sleep_for(10ms);
+      p.set_value(std::make_unique<int>(5));
+    }};
+    TEST_ASSERT(f.wait_for(1ms) == std::future_status::timeout);
+    TEST_EQ(5, *f.get());
+    t.join();
+  }
+
+  // void and reference results, the promise set from a moved-to object.
+  {
+    int v{0};
+    free_rtos_std::promise<void> pv;
+    free_rtos_std::promise<int &> pr;
+    auto fv = pv.get_future();
+    auto fr = pr.get_future();
+    std::thread t{[pv = std::move(pv), pr = std::move(pr), &v]() mutable {
+      pv.set_value();
+      pr.set_value(v);
+    }};
+    fv.wait();
+    TEST_ASSERT(fv.wait_until(std::chrono::steady_clock::now()) == std::future_status::ready);
+    fr.get() = 7;
+    TEST_EQ(7, v);
+    t.join();
+  }
+
+  // A future dropped before the result, and a promise never used.
+  {
+    free_rtos_std::promise<int> p;
+    p.get_future();
+    p.set_value(1);
+    free_rtos_std::promise<int> unused;
+  }
+
+  // The states go back to the pool.
+  TEST_EQ(in_use, free_rtos_std::future_pool_statistics().in_use);
+}
+
+// Runs the continuations in the task of a timer service.
+struct TimerExecutor
+{
+  free_rtos_std::timer_service timers{4};
+
+  template <typename F>
+  void execute(F &&f)
+  {
+    timers.schedule_after(free_rtos_std::timer_service::clock::duration::zero(), std::forward<F>(f));
+  }
+};
+
+inline void TestFutureThen()
+{
+  using namespace std::chrono_literals;
+
+  const auto in_use = free_rtos_std::future_pool_statistics().in_use;
+  const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+  // Registered before the result, runs inside set_value.
+  {
+    free_rtos_std::promise<int> p;
+    TaskHandle_t ran_on{};
+    auto f = p.get_future().then([&](free_rtos_std::future<int> v) {
+      ran_on = xTaskGetCurrentTaskHandle();
+      return v.get() * 2;
+    });
+    TEST_ASSERT(f.wait_for(0ms) == std::future_status::timeout);
+    p.set_value(3);
+    TEST_ASSERT(ran_on == self);
+    TEST_EQ(6, f.get());
+  }
+
+  // Chained on a future which is ready, runs at once.
+  {
+    free_rtos_std::promise<int> p;
+    auto f = p.get_future();
+    p.set_value(1);
+    int seen{0};
+    auto g = f.then([](free_rtos_std::future<int> v) { return v.get() + 1; })
+                 .then([&](free_rtos_std::future<int> v) { seen = v.get(); });
+    TEST_ASSERT(!f.valid());
+    TEST_ASSERT(g.wait_for(0ms) == std::future_status::ready);
+    TEST_EQ(2, seen);
+  }
+
+  // Completed by another task, continued on an executor.
+  {
+    TimerExecutor ex;
+    free_rtos_std::promise<int> p;
+    TaskHandle_t ran_on{};
+    auto f = p.get_future().then(ex, [&](free_rtos_std::future<int> v) {
+      ran_on = xTaskGetCurrentTaskHandle();
+      return v.get() + 10;
+    });
+    std::thread t{[&p] { p.set_value(5); }};
+    TEST_EQ(15, f.get());
+    TEST_ASSERT(ran_on != self && ran_on != nullptr);
+    t.join();
+  }
+
+  TEST_EQ(in_use, free_rtos_std::future_pool_statistics().in_use);
+}
+
+inline void TestFutureWhen()
+{
+  using namespace std::chrono_literals;
+
+  const auto in_use = free_rtos_std::future_pool_statistics().in_use;
+
+  // when_all waits for the last one.
+  {
+    free_rtos_std::promise<int> a;
+    free_rtos_std::promise<void> b;
+    auto all = free_rtos_std::when_all(a.get_future(), b.get_future());
+    a.set_value(1);
+    TEST_ASSERT(all.wait_for(0ms) == std::future_status::timeout);
+    std::thread t{[&b] { b.set_value(); }};
+    auto r = all.get();
+    TEST_EQ(1, std::get<0>(r).get());
+    TEST_ASSERT(std::get<1>(r).wait_for(0ms) == std::future_status::ready);
+    t.join();
+  }
+
+  // when_any takes the first one, the others stay usable.
+  {
+    free_rtos_std::promise<int> a, b, c;
+    auto any = free_rtos_std::when_any(a.get_future(), b.get_future(), c.get_future());
+    TEST_ASSERT(any.wait_for(0ms) == std::future_status::timeout);
+    std::thread t{[&b] { b.set_value(2); }};
+    auto r = any.get();
+    t.join();
+    TEST_EQ(1U, r.first);
+    TEST_EQ(2, std::get<1>(r.second).get());
+    c.set_value(3);
+    TEST_EQ(3, std::get<2>(r.second).get());
+  }
+
+  // when_any with inputs ready already.
+  {
+    free_rtos_std::promise<int> a, b;
+    auto fb = b.get_future();
+    b.set_value(2);
+    auto r = free_rtos_std::when_any(a.get_future(), std::move(fb)).get();
+    TEST_EQ(1U, r.first);
+  }
+
+  TEST_EQ(in_use, free_rtos_std::future_pool_statistics().in_use);
+}
+
 inline void TestFuture()
 {
   TestAsync();
   TestSharedFuture();
   TestSetValueAtExit();
   TestPackagedTask();
+  TestLightFuture();
+  TestFutureThen();
+  TestFutureWhen();
 }
 
 #endif // __FUTURE_TEST_H__
@@ -21,16 +21,45 @@
 #ifndef TEST_HELPERS_H__
 #define TEST_HELPERS_H__
 
-#include <string>
 #include "console.h"
+#include <chrono>
+#include <string>
+#if __cplusplus > 201703L
+#include <stop_token>
+#endif
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+// Test output is printed directly, so a test that deadlocks still shows how
+// far it got. With TEST_LOG_OUTPUT set to 1 it goes through the deferred log
+// (freertos_log.h) instead: a PASS line costs a record in the buffer of the
+// calling thread, not the UART time. A failure flushes the log. Set by
+// cmake -DTEST_LOG_OUTPUT=1; the posix target builds test_posix_log.elf so.
+#ifndef TEST_LOG_OUTPUT
+#define TEST_LOG_OUTPUT 0
+#endif
+
+#if (TEST_LOG_OUTPUT == 1)
+#include "freertos_log.h"
+#if (configSTD_LOG != 1)
+#error "TEST_LOG_OUTPUT requires configSTD_LOG"
+#endif
+#endif
 
 template <typename F>
 void tst_call(const char *name, F fun)
 {
+#if (TEST_LOG_OUTPUT == 1)
+  free_rtos_std::log::write("Running ---- {} -----\n", name);
+  fun();
+  free_rtos_std::log::write("Done\n\n");
+#else
   using namespace std::string_literals;
   print(("Running ---- "s + name + " -----\n").c_str());
   fun();
   print("Done\n\n");
+#endif
 }
 
 #define TEST_F(function_) tst_call(#function_, function_)
@@ -38,6 +67,16 @@ void tst_call(const char *name, F fun)
 template <typename T, typename U>
 void tst_equal(const char *func, const char *file, int line, T exp, U rcv)
 {
+#if (TEST_LOG_OUTPUT == 1)
+  if (exp == rcv)
+    free_rtos_std::log::write("\tPASS - {}:{}\n", func, line);
+  else
+  {
+    free_rtos_std::log::write("  FAILED - {}\n\t in file - {}:{}\n\t\texpected({}) != received({})\n",
+                              func, file, line, exp, rcv);
+    free_rtos_std::log::flush();
+  }
+#else
   using namespace std::string_literals;
   if (exp == rcv)
   {
@@ -50,12 +89,22 @@ void tst_equal(const char *func, const char *file, int line, T exp, U rcv)
     fail += file + ":"s + std::to_string(line) + "\n\t\texpected(" + std::to_string(exp) + ") != received(" + std::to_string(rcv) + ")" + "\n"s;
     print(fail.c_str());
   }
+#endif
 }
 
 #define TEST_EQ(expected_, received_) tst_equal(__func__, __FILE__, __LINE__, expected_, received_)
 
 static inline void tst_assert(const char *func, const char *file, int line, bool cond)
 {
+#if (TEST_LOG_OUTPUT == 1)
+  if (cond)
+    free_rtos_std::log::write("\tPASS - {}:{}\n", func, line);
+  else
+  {
+    free_rtos_std::log::write("  FAILED assertion {}\n\t in file - {}:{}\n", func, file, line);
+    free_rtos_std::log::flush();
+  }
+#else
   using namespace std::string_literals;
   if (cond)
   {
@@ -68,8 +117,62 @@ static inline void tst_assert(const char *func, const char *file, int line, bool
     fail += file + ":"s + std::to_string(line) + "\n"s;
     print(fail.c_str());
   }
+#endif
 }
 
 #define TEST_ASSERT(cond_) tst_assert(__func__, __FILE__, __LINE__, cond_)
 
+// Added to the upper bounds of the timing tests. A build which is not real
+// time (the host build) sets it in its FreeRTOSConfig.h.
+#ifndef TEST_TIMING_SLACK
+#define TEST_TIMING_SLACK std::chrono::milliseconds(0)
+#endif
+
+#if __cplusplus > 201703L
+// GCC 12 warns about a 'maybe-uninitialized' std::stop_source constructed
+// in place of a local variable. It is constructed out of line here.
+[[gnu::noinline]] inline std::stop_source NewStopSource()
+{
+  return std::stop_source{};
+}
+#endif
+
+// Kernel semaphores, created with the allocation the profile has.
+class TestKernelSemaphore
+{
+public:
+  ~TestKernelSemaphore() { vSemaphoreDelete(_handle); }
+
+  TestKernelSemaphore(const TestKernelSemaphore &) = delete;
+  TestKernelSemaphore &operator=(const TestKernelSemaphore &) = delete;
+
+  SemaphoreHandle_t get() const { return _handle; }
+
+protected:
+  TestKernelSemaphore() = default;
+
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  StaticSemaphore_t _storage;
+#endif
+  SemaphoreHandle_t _handle{nullptr};
+};
+
+struct TestBinarySemaphore : TestKernelSemaphore
+{
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  TestBinarySemaphore() { _handle = xSemaphoreCreateBinaryStatic(&_storage); }
+#else
+  TestBinarySemaphore() { _handle = xSemaphoreCreateBinary(); }
+#endif
+};
+
+struct TestKernelMutex : TestKernelSemaphore
+{
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 0)
+  TestKernelMutex() { _handle = xSemaphoreCreateMutexStatic(&_storage); }
+#else
+  TestKernelMutex() { _handle = xSemaphoreCreateMutex(); }
+#endif
+};
+
 #endif // TEST_HELPERS_H__
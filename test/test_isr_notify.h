@@ -0,0 +1,177 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __ISR_NOTIFY_TEST_H__
+#define __ISR_NOTIFY_TEST_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "freertos_condition_variable_any.h"
+#include "freertos_semaphore.h"
+#include "test_helpers.h"
+
+// Signalled from the tick interrupt (the global timer on CA9), through the
+// tick hook of sys_common/FreeRTOS_hooks.cpp. The hooks call the free
+// functions, which yield to a woken task of a higher priority with
+// portYIELD_FROM_ISR.
+
+extern "C" void (*volatile g_tickHook)(void);
+
+inline void TestLightSemaphore()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  free_rtos_std::counting_semaphore<4> sem{1};
+  TEST_ASSERT(sem.try_acquire());
+  auto start = steady_clock::now();
+  TEST_ASSERT(!sem.try_acquire_for(10ms));
+  TEST_ASSERT(steady_clock::now() - start >= 10ms);
+
+  // The count goes to the waiting tasks first.
+  std::atomic<int> acquired{0};
+  std::thread t[2];
+  for (auto &th : t)
+    th = std::thread{[&] {
+      sem.acquire();
+      acquired++;
+    }};
+  std::this_thread::sleep_for(10ms);
+  sem.release(3);
+  for (auto &th : t)
+    th.join();
+  TEST_EQ(2, acquired.load());
+  TEST_ASSERT(sem.try_acquire());
+  TEST_ASSERT(!sem.try_acquire());
+
+  free_rtos_std::latch l{2};
+  std::thread w{[&] { l.arrive_and_wait(); }};
+  TEST_ASSERT(!l.try_wait());
+  l.count_down();
+  l.wait();
+  w.join();
+  TEST_ASSERT(l.try_wait());
+}
+
+#if (configUSE_TICK_HOOK == 1)
+
+inline void TestIsrSemaphore()
+{
+  using namespace std::chrono_literals;
+
+  static free_rtos_std::binary_semaphore *s_sem;
+  free_rtos_std::binary_semaphore sem{0};
+  s_sem = &sem;
+  g_tickHook = [] {
+    g_tickHook = nullptr;
+    free_rtos_std::release_from_isr(*s_sem);
+  };
+
+  TEST_ASSERT(sem.try_acquire_for(1s));
+  TEST_ASSERT(!sem.try_acquire());
+}
+
+inline void TestIsrLatch()
+{
+  // Counted down once per tick.
+  static free_rtos_std::latch *s_done;
+  static int s_left;
+  free_rtos_std::latch done{3};
+  s_done = &done;
+  s_left = 3;
+  g_tickHook = [] {
+    if (--s_left == 0)
+      g_tickHook = nullptr;
+    free_rtos_std::count_down_from_isr(*s_done);
+  };
+
+  done.wait();
+  TEST_ASSERT(done.try_wait());
+  TEST_EQ(0, s_left);
+}
+
+// Shared with an ISR, so locked with a critical section.
+struct IsrLock
+{
+  void lock() { taskENTER_CRITICAL(); }
+  void unlock() { taskEXIT_CRITICAL(); }
+};
+
+inline void TestIsrConditionVariable()
+{
+  static free_rtos_std::condition_variable_any *s_cv;
+  static int s_events;
+  free_rtos_std::condition_variable_any cv;
+  IsrLock lock;
+  s_cv = &cv;
+  s_events = 0;
+
+  g_tickHook = [] {
+    g_tickHook = nullptr;
+    s_events++;
+    free_rtos_std::notify_one_from_isr(*s_cv);
+  };
+
+  lock.lock();
+  cv.wait(lock, [] { return s_events != 0; });
+  lock.unlock();
+  TEST_EQ(1, s_events);
+}
+
+inline void TestIsrStdConditionVariable()
+{
+  // The ISR cannot take the mutex, a notification before the wait is lost.
+  // It sets the event and notifies on every tick until the waiter has seen it.
+  static std::condition_variable *s_cv;
+  static std::atomic<bool> s_event;
+  std::condition_variable cv;
+  std::mutex m;
+  s_cv = &cv;
+  s_event = false;
+
+  g_tickHook = [] {
+    s_event = true;
+    free_rtos_std::notify_one_from_isr(*s_cv);
+  };
+
+  std::unique_lock lock{m};
+  cv.wait(lock, [] { return s_event.load(); });
+  g_tickHook = nullptr;
+  TEST_ASSERT(s_event);
+}
+
+inline void TestIsrNotify()
+{
+  TestIsrSemaphore();
+  TestIsrLatch();
+  TestIsrConditionVariable();
+  TestIsrStdConditionVariable();
+}
+
+#endif // configUSE_TICK_HOOK == 1
+
+#endif //__ISR_NOTIFY_TEST_H__
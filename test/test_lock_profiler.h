@@ -0,0 +1,123 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __LOCK_PROFILER_TEST_H__
+#define __LOCK_PROFILER_TEST_H__
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "freertos_lock_profiler.h"
+#include "test_helpers.h"
+
+#if (configSTD_LOCK_PROFILING == 1)
+
+inline const free_rtos_std::lock_profiler::lock_stats *FindLockStats(const void *handle)
+{
+  using namespace free_rtos_std::lock_profiler;
+  static lock_stats stats[configSTD_LOCK_PROFILING_TABLE_SIZE];
+
+  auto n = top_contended(stats, configSTD_LOCK_PROFILING_TABLE_SIZE);
+  for (std::size_t i = 0; i < n; i++)
+    if (stats[i].mutex == handle)
+      return &stats[i];
+  return nullptr;
+}
+
+inline void TestLockProfiler()
+{
+  using namespace std::chrono_literals;
+
+  std::timed_mutex mtx;
+  const void *handle = free_rtos_std::mutex_handle(mtx.native_handle());
+
+  mtx.lock();
+  auto stats = FindLockStats(handle);
+  TEST_ASSERT(stats != nullptr);
+  TEST_EQ(1U, stats->acquisitions);
+  TEST_EQ(0U, stats->contended);
+  TEST_ASSERT(stats->holder == xTaskGetCurrentTaskHandle());
+
+  std::thread t{[&] {
+    TEST_ASSERT(mtx.try_lock() == false);
+    mtx.lock(); // blocks until the main thread unlocks
+    mtx.unlock();
+  }};
+
+  std::this_thread::sleep_for(20ms);
+  mtx.unlock();
+  t.join();
+
+  stats = FindLockStats(handle);
+  TEST_ASSERT(stats != nullptr);
+  TEST_EQ(2U, stats->acquisitions);
+  TEST_EQ(2U, stats->contended);
+  TEST_EQ(1U, stats->failures);
+  TEST_ASSERT(stats->maxWait > 0);
+  TEST_ASSERT(stats->holder == nullptr);
+
+  free_rtos_std::lock_profiler::dump(3, print);
+}
+
+inline void TestLockProfilerRecursive()
+{
+  std::recursive_mutex mtx;
+  const void *handle = free_rtos_std::mutex_handle(mtx.native_handle());
+
+  mtx.lock();
+  mtx.lock();
+  mtx.unlock();
+
+  // still held at the first level
+  auto stats = FindLockStats(handle);
+  TEST_ASSERT(stats != nullptr);
+  TEST_EQ(2U, stats->acquisitions);
+  TEST_ASSERT(stats->holder == xTaskGetCurrentTaskHandle());
+
+  mtx.unlock();
+  stats = FindLockStats(handle);
+  TEST_ASSERT(stats->holder == nullptr);
+}
+
+inline void TestLockProfilerForget()
+{
+  const void *handle;
+  {
+    std::mutex mtx;
+    handle = free_rtos_std::mutex_handle(mtx.native_handle());
+    std::lock_guard<std::mutex> lg{mtx};
+    TEST_ASSERT(FindLockStats(handle) != nullptr);
+  }
+
+  // destroyed mutex is removed from the table
+  TEST_ASSERT(FindLockStats(handle) == nullptr);
+}
+
+inline void TestLockProfiling()
+{
+  TestLockProfiler();
+  TestLockProfilerRecursive();
+  TestLockProfilerForget();
+}
+
+#endif // configSTD_LOCK_PROFILING == 1
+
+#endif //__LOCK_PROFILER_TEST_H__
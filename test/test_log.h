@@ -0,0 +1,88 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __LOG_TEST_H__
+#define __LOG_TEST_H__
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "freertos_log.h"
+#include "test_helpers.h"
+
+#if (configSTD_LOG == 1)
+
+inline bool log_formats_to(const char *expected, auto... args)
+{
+  char out[configSTD_LOG_LINE_SIZE];
+  auto n = free_rtos_std::log::format(out, sizeof(out), args...);
+  return n == std::strlen(expected) && std::strcmp(out, expected) == 0;
+}
+
+inline void TestLogFormat()
+{
+  TEST_ASSERT(log_formats_to("no args", "no args"));
+  TEST_ASSERT(log_formats_to("-5 7 ff", "{} {} {:x}", -5, 7U, 255));
+  TEST_ASSERT(log_formats_to("-9000000000 18446744073709551615", "{} {}", -9000000000LL, ~0ULL));
+  TEST_ASSERT(log_formats_to("true false c", "{} {} {}", true, false, 'c'));
+  TEST_ASSERT(log_formats_to("1.500 -0.250", "{} {}", 1.5, -0.25f));
+  TEST_ASSERT(log_formats_to("[lit] [view] [str]", "[{}] [{}] [{}]", "lit", std::string_view{"view"},
+                             std::string{"str"}));
+  TEST_ASSERT(log_formats_to("0x1000", "{}", reinterpret_cast<void *>(0x1000)));
+  TEST_ASSERT(log_formats_to("1 {?}", "{} {}", 1));
+
+  // cut to the size of the output
+  char out[8];
+  TEST_EQ(7U, free_rtos_std::log::format(out, sizeof(out), "{} {}", 12345, 67890));
+  TEST_ASSERT(std::strcmp(out, "12345 6") == 0);
+}
+
+inline void TestLogThreads()
+{
+  // More threads than buffers in the pool. The buffers of the finished
+  // threads are reused, the rest share the common one. The format has no
+  // placeholders, so the records print nothing.
+  const auto dropped = free_rtos_std::log::dropped();
+  for (int round = 0; round < 3; round++)
+  {
+    std::thread t[4];
+    for (auto &x : t)
+      x = std::thread{[] {
+        for (int i = 0; i < 200; i++)
+          free_rtos_std::log::write("", i, "args", 1.0);
+      }};
+    for (auto &x : t)
+      x.join();
+  }
+  free_rtos_std::log::flush();
+  TEST_EQ(dropped, free_rtos_std::log::dropped());
+}
+
+inline void TestLog()
+{
+  TestLogFormat();
+  TestLogThreads();
+}
+
+#endif // configSTD_LOG == 1
+
+#endif // __LOG_TEST_H__
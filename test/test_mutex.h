@@ -21,11 +21,16 @@
 #ifndef __MTX_TEST_H__
 #define __MTX_TEST_H__
 
+#include <atomic>
 #include <chrono>
 #include <mutex>
+#include <thread>
 
 #include <cassert>
 
+#include "test_helpers.h"
+#include "thread_with_attributes.h"
+
 inline void TestRecursiveMtx()
 {
   std::recursive_mutex to_mtx;
@@ -53,7 +58,9 @@ inline void TestTimedMtx()
 
   // expected the mutex is not available
   assert(to_mtx.try_lock() == false);
+  auto start = steady_clock::now();
   assert(to_mtx.try_lock_for(10ms) == false);
+  TEST_ASSERT(steady_clock::now() - start >= 10ms);
   assert(to_mtx.try_lock_until(system_clock::now() + 200ms) == false);
 
   to_mtx.unlock();
@@ -68,10 +75,117 @@ inline void TestTimedMtx()
   to_mtx.unlock();
 }
 
+inline void TestMtxContended()
+{
+  // Same priority threads yielding inside the lock, every lock after the
+  // first goes through the wait path.
+  constexpr int THREADS{4};
+  constexpr int LOOPS{200};
+  std::mutex mtx;
+  int counter{0};
+
+  std::thread t[THREADS];
+  for (auto &th : t)
+    th = std::thread{[&] {
+      for (int i = 0; i < LOOPS; i++)
+      {
+        std::lock_guard<std::mutex> lg{mtx};
+        int c = counter;
+        std::this_thread::yield();
+        counter = c + 1;
+      }
+    }};
+
+  for (auto &th : t)
+    th.join();
+
+  TEST_EQ(THREADS * LOOPS, counter);
+}
+
+inline void TestTimedMtxContended()
+{
+  using namespace std::chrono_literals;
+
+  std::timed_mutex mtx;
+  std::atomic<bool> locked{false};
+
+  std::thread t{[&] {
+    std::lock_guard<std::timed_mutex> lg{mtx};
+    locked = true;
+    std::this_thread::sleep_for(50ms);
+  }};
+
+  while (!locked)
+    std::this_thread::sleep_for(1ms);
+
+  // Times out while the other thread holds it, then gets it on unlock.
+  TEST_ASSERT(mtx.try_lock_for(10ms) == false);
+  TEST_ASSERT(mtx.try_lock_for(500ms) == true);
+  mtx.unlock();
+
+  t.join();
+}
+
+inline void TestMtxPriorityInheritance()
+{
+  using namespace std::chrono_literals;
+
+  const UBaseType_t base = uxTaskPriorityGet(nullptr);
+  std::mutex mtx;
+  std::atomic<bool> done{false};
+
+  mtx.lock();
+  std::thread t = free_rtos_std::std_thread(free_rtos_std::attr_priority(base + 2), [&] {
+    std::lock_guard<std::mutex> lg{mtx};
+    done = true;
+  });
+
+  // The waiting thread lends its priority to the owner.
+  std::this_thread::sleep_for(10ms);
+  TEST_EQ(base + 2, uxTaskPriorityGet(nullptr));
+  TEST_ASSERT(done == false);
+
+  // Unlock gives the priority back and the waiter runs at once.
+  mtx.unlock();
+  TEST_EQ(base, uxTaskPriorityGet(nullptr));
+  TEST_ASSERT(done == true);
+
+  t.join();
+}
+
+inline void TestTimedMtxPriorityInheritance()
+{
+  using namespace std::chrono_literals;
+
+  const UBaseType_t base = uxTaskPriorityGet(nullptr);
+  std::timed_mutex mtx;
+  std::atomic<bool> gaveUp{false};
+
+  mtx.lock();
+  std::thread t = free_rtos_std::std_thread(free_rtos_std::attr_priority(base + 2), [&] {
+    gaveUp = !mtx.try_lock_for(10ms);
+  });
+
+  // The priority is lent while the other thread waits and taken back when
+  // it gives up, not at the unlock.
+  std::this_thread::sleep_for(5ms);
+  TEST_EQ(base + 2, uxTaskPriorityGet(nullptr));
+  t.join();
+  TEST_ASSERT(gaveUp == true);
+  TEST_EQ(base, uxTaskPriorityGet(nullptr));
+
+  mtx.unlock();
+  TEST_EQ(base, uxTaskPriorityGet(nullptr));
+}
+
 inline void TestMtx()
 {
   TestRecursiveMtx();
   TestTimedMtx();
+  TestMtxContended();
+  TestTimedMtxContended();
+  TestMtxPriorityInheritance();
+  TestTimedMtxPriorityInheritance();
 }
 
 #endif //__MTX_TEST_H__
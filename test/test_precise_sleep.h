@@ -0,0 +1,90 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __PRECISE_SLEEP_TEST_H__
+#define __PRECISE_SLEEP_TEST_H__
+
+#include <chrono>
+#include <thread>
+
+#include "freertos_precise_sleep.h"
+#include "test_helpers.h"
+
+#if (configSTD_PRECISE_SLEEP == 1)
+
+inline std::chrono::nanoseconds MeasureSleep(std::chrono::nanoseconds d)
+{
+  auto t0 = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(d);
+  return std::chrono::steady_clock::now() - t0;
+}
+
+inline void TestPreciseSleepShort()
+{
+  using namespace std::chrono_literals;
+
+  // without precise sleep any of these takes at least one tick
+  for (auto d : {50us, 200us, 500us})
+  {
+    auto t = MeasureSleep(d);
+    TEST_ASSERT(t >= d);
+    TEST_ASSERT(t < d + 200us);
+  }
+}
+
+inline void TestPreciseSleepLong()
+{
+  using namespace std::chrono_literals;
+
+  // whole ticks plus a part of a tick
+  auto t = MeasureSleep(3500us);
+  TEST_ASSERT(t >= 3500us);
+  TEST_ASSERT(t < 3700us);
+}
+
+inline void TestPreciseSleepConcurrent()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  // sleepers share the one-shot timer, each must wake up on its own deadline
+  nanoseconds t1, t2, t3;
+  std::thread a{[&] { t1 = MeasureSleep(300us); }};
+  std::thread b{[&] { t2 = MeasureSleep(700us); }};
+  std::thread c{[&] { t3 = MeasureSleep(1300us); }};
+  a.join();
+  b.join();
+  c.join();
+
+  TEST_ASSERT(t1 >= 300us && t1 < 600us);
+  TEST_ASSERT(t2 >= 700us && t2 < 1000us);
+  TEST_ASSERT(t3 >= 1300us && t3 < 1600us);
+}
+
+inline void TestPreciseSleep()
+{
+  TestPreciseSleepShort();
+  TestPreciseSleepLong();
+  TestPreciseSleepConcurrent();
+}
+
+#endif // configSTD_PRECISE_SLEEP == 1
+
+#endif //__PRECISE_SLEEP_TEST_H__
@@ -0,0 +1,140 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __SELECT_TEST_H__
+#define __SELECT_TEST_H__
+
+#include <chrono>
+#include <stop_token>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "freertos_channel.h"
+#include "freertos_future.h"
+#include "freertos_select.h"
+#include "test_helpers.h"
+
+#if (configUSE_QUEUE_SETS == 1)
+
+inline void TestSelectSources()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::channel<int, 4> a;
+  free_rtos_std::channel<int, 2> b;
+  TestBinarySemaphore kernelSem;
+  SemaphoreHandle_t sem = kernelSem.get();
+  free_rtos_std::select_signal sig;
+
+  free_rtos_std::selector<4, 4 + 2 + 1 + 1> sel;
+  const auto ia = sel.add(a);
+  const auto ib = sel.add(b);
+  const auto isem = sel.add(sem);
+  const auto isig = sel.add(sig);
+  TEST_EQ(0U, ia);
+  TEST_EQ(3U, isig);
+  TEST_ASSERT(sel.add(sig) == sel.npos); // full
+
+  TEST_ASSERT(!sel.try_wait());
+  TEST_ASSERT(!sel.wait_for(5ms));
+
+  // In the order the sources became ready.
+  b.send(2);
+  a.send(1);
+  xSemaphoreGive(sem);
+  TEST_EQ(ib, sel.wait());
+  TEST_EQ(2, b.try_recv().value());
+  TEST_EQ(ia, sel.wait());
+  TEST_EQ(1, a.try_recv().value());
+  TEST_EQ(isem, sel.wait());
+  TEST_EQ(pdTRUE, xSemaphoreTake(sem, 0));
+
+  // A signal raised twice is reported once, and taken by the selector.
+  sig.raise();
+  sig.raise();
+  TEST_EQ(isig, sel.wait());
+  TEST_ASSERT(!sel.try_wait());
+
+  // Raised by another task, here from a continuation of a future.
+  free_rtos_std::promise<int> p;
+  auto done = p.get_future().then([&](free_rtos_std::future<int> f) {
+    sig.raise();
+    return f.get();
+  });
+  std::thread t{[&p] {
+    std::this_thread::sleep_for(10ms);
+    p.set_value(3);
+  }};
+  TEST_EQ(isig, sel.wait_until(std::chrono::steady_clock::now() + 1s).value());
+  TEST_EQ(3, done.get());
+  t.join();
+}
+
+inline void TestSelectStop()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  free_rtos_std::channel<int, 4> ch;
+  int received{0};
+  auto start = steady_clock::now();
+  {
+    std::jthread t{[&](std::stop_token st) {
+      free_rtos_std::selector<2, 5> sel;
+      const auto rx = sel.add(ch);
+      const auto stop = sel.add(st);
+      for (;;)
+      {
+        const auto i = sel.wait();
+        if (i == rx)
+          received += ch.try_recv().value();
+        else if (i == stop)
+          break;
+      }
+    }};
+    std::this_thread::sleep_for(5ms); // the channel is added while empty
+    ch.send(1);
+    ch.send(2);
+    std::this_thread::sleep_for(10ms);
+  }
+  TEST_EQ(3, received);
+  TEST_ASSERT(steady_clock::now() - start < 100ms);
+
+  // Stopped before it is added.
+  std::stop_source src = NewStopSource();
+  const std::stop_token st = src.get_token();
+  src.request_stop();
+  free_rtos_std::selector<1, 1> sel;
+  TEST_EQ(0U, sel.add(st));
+  TEST_EQ(0U, sel.try_wait().value());
+  TEST_ASSERT(!sel.try_wait()); // once
+}
+
+inline void TestSelect()
+{
+  TestSelectSources();
+  TestSelectStop();
+}
+
+#endif // configUSE_QUEUE_SETS == 1
+
+#endif //__SELECT_TEST_H__
@@ -0,0 +1,175 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __SHARED_MUTEX_TEST_H__
+#define __SHARED_MUTEX_TEST_H__
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+#include "freertos_shared_mutex.h"
+#include "test_helpers.h"
+#include "thread_with_attributes.h"
+
+#if (configSTD_SHARED_MUTEX == 1)
+
+inline void TestSharedMtxReaders()
+{
+  free_rtos_std::shared_mutex mtx;
+
+  // Any number of readers, no writer while they hold it.
+  mtx.lock_shared();
+  TEST_ASSERT(mtx.try_lock_shared() == true);
+  TEST_ASSERT(mtx.try_lock() == false);
+  mtx.unlock_shared();
+  TEST_ASSERT(mtx.try_lock() == false);
+  mtx.unlock_shared();
+
+  // No reader and no other writer while a writer holds it.
+  TEST_ASSERT(mtx.try_lock() == true);
+  TEST_ASSERT(mtx.try_lock_shared() == false);
+  TEST_ASSERT(mtx.try_lock() == false);
+  mtx.unlock();
+
+  TEST_ASSERT(mtx.try_lock_shared() == true);
+  mtx.unlock_shared();
+}
+
+inline void TestSharedMtxContended()
+{
+  // Writers update two values with a yield in between, readers must never
+  // see them differ.
+  constexpr int READERS{3};
+  constexpr int WRITES{100};
+  free_rtos_std::shared_mutex mtx;
+  int a{0}, b{0};
+  std::atomic<bool> fStop{false};
+  std::atomic<int> torn{0};
+
+  std::thread r[READERS];
+  for (auto &th : r)
+    th = std::thread{[&] {
+      while (!fStop)
+      {
+        std::shared_lock<free_rtos_std::shared_mutex> lock{mtx};
+        if (a != b)
+          torn++;
+        std::this_thread::yield();
+      }
+    }};
+
+  std::thread w{[&] {
+    for (int i = 0; i < WRITES; i++)
+    {
+      std::lock_guard<free_rtos_std::shared_mutex> lock{mtx};
+      a++;
+      std::this_thread::yield();
+      b++;
+    }
+  }};
+
+  w.join();
+  fStop = true;
+  for (auto &th : r)
+    th.join();
+
+  TEST_EQ(0, torn.load());
+  TEST_EQ(WRITES, a);
+  TEST_EQ(WRITES, b);
+}
+
+inline void TestSharedMtxWriterPreference()
+{
+  using namespace std::chrono_literals;
+
+  const UBaseType_t base = uxTaskPriorityGet(nullptr);
+  free_rtos_std::shared_mutex mtx;
+  std::atomic<bool> written{false};
+
+  mtx.lock_shared();
+  std::thread t = free_rtos_std::std_thread(free_rtos_std::attr_priority(base + 1), [&] {
+    std::lock_guard<free_rtos_std::shared_mutex> lock{mtx};
+    written = true;
+  });
+  std::this_thread::sleep_for(10ms);
+
+  // A writer waits, new readers queue behind it.
+  TEST_ASSERT(written == false);
+  TEST_ASSERT(mtx.try_lock_shared() == false);
+
+  // The last reader leaving hands the lock to the writer.
+  mtx.unlock_shared();
+  TEST_ASSERT(written == true);
+  TEST_ASSERT(mtx.try_lock_shared() == true);
+  mtx.unlock_shared();
+
+  t.join();
+}
+
+inline void TestSharedTimedMtx()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  free_rtos_std::shared_timed_mutex mtx;
+  std::atomic<bool> entered{false};
+
+  mtx.lock();
+  TEST_ASSERT(mtx.try_lock_shared_for(10ms) == false);
+  TEST_ASSERT(mtx.try_lock_until(steady_clock::now() + 10ms) == false);
+  mtx.unlock();
+
+  // A writer giving up lets in the readers queued behind it.
+  mtx.lock_shared();
+  std::thread w{[&] {
+    TEST_ASSERT(mtx.try_lock_for(50ms) == false);
+  }};
+  std::thread r{[&] {
+    std::this_thread::sleep_for(10ms);
+    TEST_ASSERT(mtx.try_lock_shared_for(500ms) == true);
+    entered = true;
+    mtx.unlock_shared();
+  }};
+
+  std::this_thread::sleep_for(20ms);
+  TEST_ASSERT(entered == false);
+  w.join();
+  r.join();
+  TEST_ASSERT(entered == true);
+  mtx.unlock_shared();
+
+  TEST_ASSERT(mtx.try_lock_for(10ms) == true);
+  mtx.unlock();
+}
+
+inline void TestSharedMtx()
+{
+  TestSharedMtxReaders();
+  TestSharedMtxContended();
+  TestSharedMtxWriterPreference();
+  TestSharedTimedMtx();
+}
+
+#endif // configSTD_SHARED_MUTEX == 1
+
+#endif //__SHARED_MUTEX_TEST_H__
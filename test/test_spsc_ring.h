@@ -0,0 +1,151 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __SPSC_RING_TEST_H__
+#define __SPSC_RING_TEST_H__
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "freertos_log.h"
+#include "freertos_spsc_ring.h"
+#include "test_helpers.h"
+
+inline void TestSpscRingBulk()
+{
+  static free_rtos_std::spsc_ring<int, 8> ring;
+  TEST_ASSERT(ring.empty());
+
+  const int in[]{1, 2, 3, 4, 5, 6};
+  int out[8]{};
+  TEST_ASSERT(ring.push(in) == 6);
+  TEST_ASSERT(ring.pop(std::span{out}.first(4)) == 4);
+  TEST_ASSERT(out[0] == 1 && out[3] == 4);
+
+  // wraps around the end of the storage
+  TEST_ASSERT(ring.push(in) == 6);
+  TEST_ASSERT(ring.size() == 8);
+  TEST_ASSERT(!ring.push(7)); // full
+  TEST_ASSERT(ring.pop(out) == 8);
+  TEST_ASSERT(out[0] == 5 && out[1] == 6 && out[2] == 1 && out[7] == 6);
+  TEST_ASSERT(!ring.try_pop());
+}
+
+inline void TestSpscRingTimeout()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  static free_rtos_std::spsc_ring<int, 4> ring;
+  int out[4];
+  auto t0 = steady_clock::now();
+  TEST_ASSERT(ring.wait_pop_for(out, 10ms) == 0);
+  auto t = steady_clock::now() - t0;
+  TEST_ASSERT(t >= 10ms && t < 15ms + TEST_TIMING_SLACK);
+}
+
+inline void TestSpscRingThreads()
+{
+  using namespace std::chrono_literals;
+
+  static free_rtos_std::spsc_ring<int, 16> ring;
+  constexpr int COUNT{1000};
+  std::thread producer{[] {
+    int chunk[7];
+    for (int next = 0; next < COUNT;)
+    {
+      int n = 0;
+      for (; n < 7 && next + n < COUNT; n++)
+        chunk[n] = next + n;
+      std::size_t sent = ring.push(std::span{chunk, (std::size_t)n});
+      next += sent;
+      if (sent == 0)
+        std::this_thread::yield();
+    }
+  }};
+
+  bool fOrdered{true};
+  int expected{0};
+  int out[5];
+  while (expected < COUNT)
+  {
+    auto n = ring.wait_pop_for(out, 100ms);
+    if (n == 0)
+      break;
+    for (std::size_t i = 0; i < n; i++)
+      fOrdered = fOrdered && out[i] == expected++;
+  }
+  producer.join();
+
+  TEST_ASSERT(fOrdered);
+  TEST_EQ(COUNT, expected);
+}
+
+#if defined(CONSOLE_HAS_RX) && (CONSOLE_HAS_LOOPBACK == 1)
+// UART receive interrupt feeds the ring. The UART is switched to loopback,
+// so printed characters are the input.
+inline free_rtos_std::spsc_ring<char, 64> g_uartRing;
+
+inline void uart_rx_to_ring(char c)
+{
+  BaseType_t woken{pdFALSE};
+  g_uartRing.push_from_isr(c, woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+inline void TestSpscRingUart()
+{
+  using namespace std::chrono_literals;
+
+  const char msg[] = "spsc ring loopback 0123456789\n";
+  char got[sizeof(msg)]{};
+  std::size_t n{0};
+
+#if (configSTD_LOG == 1)
+  free_rtos_std::log::flush(); // the drain task must not print into the loopback
+#endif
+  console_rx_start(uart_rx_to_ring, true);
+  print(msg);
+  while (n < sizeof(msg) - 1)
+  {
+    auto r = g_uartRing.wait_pop_for(std::span{got + n, sizeof(msg) - 1 - n}, 50ms);
+    if (r == 0)
+      break;
+    n += r;
+  }
+  console_rx_stop();
+
+  TEST_EQ(sizeof(msg) - 1, n);
+  TEST_ASSERT(std::memcmp(msg, got, n) == 0);
+}
+#endif
+
+inline void TestSpscRing()
+{
+  TestSpscRingBulk();
+  TestSpscRingTimeout();
+  TestSpscRingThreads();
+#if defined(CONSOLE_HAS_RX) && (CONSOLE_HAS_LOOPBACK == 1)
+  TestSpscRingUart();
+#endif
+}
+
+#endif // __SPSC_RING_TEST_H__
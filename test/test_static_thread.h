@@ -0,0 +1,117 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __STATIC_THREAD_TEST_H__
+#define __STATIC_THREAD_TEST_H__
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "freertos_static_thread.h"
+#include "test_helpers.h"
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+
+// Started by a global constructor, before the scheduler. Every run of the
+// tests checks what it has recorded.
+struct StaticBootThread
+{
+  static constexpr UBaseType_t PRIORITY{tskIDLE_PRIORITY + 2};
+
+  free_rtos_std::static_thread<1024, PRIORITY, "boot"> thread;
+  BaseType_t scheduler{taskSCHEDULER_RUNNING};
+  std::thread::id id;
+  UBaseType_t priority{0};
+  bool named{false};
+
+  StaticBootThread()
+  {
+    scheduler = xTaskGetSchedulerState();
+    thread.start([this] {
+      id = std::this_thread::get_id();
+      priority = uxTaskPriorityGet(nullptr);
+      named = std::strcmp(pcTaskGetName(nullptr), "boot") == 0;
+    });
+  }
+};
+
+inline StaticBootThread s_staticBootThread;
+
+// Started by the first run of the tests.
+inline constinit free_rtos_std::static_thread<1024, tskIDLE_PRIORITY + 1, "static"> s_staticThread;
+
+inline void TestStaticThreadBoot()
+{
+  auto &boot = s_staticBootThread;
+  boot.thread.join();
+
+  TEST_EQ(taskSCHEDULER_NOT_STARTED, boot.scheduler);
+  TEST_ASSERT(boot.id != std::thread::id{});
+  TEST_ASSERT(boot.id == boot.thread.get_id());
+  TEST_EQ(StaticBootThread::PRIORITY, boot.priority);
+  TEST_ASSERT(boot.named);
+}
+
+inline void TestStaticThreadStart()
+{
+  struct Result
+  {
+    std::thread::id id;
+    std::uintptr_t self;
+    int sum;
+  };
+  static Result result;
+
+  struct Fn
+  {
+    void operator()(Result *r, int a, int b)
+    {
+      r->id = std::this_thread::get_id();
+      r->self = reinterpret_cast<std::uintptr_t>(this);
+      r->sum = a + b;
+    }
+  };
+
+  if (!s_staticThread.native_handle())
+    s_staticThread.start(Fn{}, &result, 1, 2);
+  s_staticThread.join();
+
+  TEST_ASSERT(result.id == s_staticThread.get_id());
+  TEST_ASSERT(result.id != std::this_thread::get_id());
+  TEST_EQ(3, result.sum);
+
+  // The callable is at the top of the stack member.
+  const auto begin = reinterpret_cast<std::uintptr_t>(&s_staticThread);
+  TEST_ASSERT(result.self >= begin && result.self < begin + sizeof(s_staticThread));
+}
+
+inline void TestStaticThread()
+{
+  TestStaticThreadBoot();
+  TestStaticThreadStart();
+}
+
+#endif // configSUPPORT_STATIC_ALLOCATION == 1
+
+#endif // __STATIC_THREAD_TEST_H__
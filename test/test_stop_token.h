@@ -0,0 +1,137 @@
+/// Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __STOP_TOKEN_TEST_H__
+#define __STOP_TOKEN_TEST_H__
+
+#include <atomic>
+#include <chrono>
+#include <stop_token>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include "freertos_channel.h"
+#include "freertos_stop_token.h"
+#include "test_helpers.h"
+#include "thread_with_attributes.h"
+
+inline void TestStopSleep()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  // Not stopped, the whole sleep.
+  std::stop_source src = NewStopSource();
+  const std::stop_token st = src.get_token();
+  auto start = steady_clock::now();
+  TEST_ASSERT(free_rtos_std::this_thread::sleep_for(10ms, st));
+  TEST_ASSERT(steady_clock::now() - start >= 10ms);
+
+  // Stopped before, no sleep at all.
+  src.request_stop();
+  start = steady_clock::now();
+  TEST_ASSERT(!free_rtos_std::this_thread::sleep_until(steady_clock::now() + 1s, st));
+  TEST_ASSERT(steady_clock::now() - start < 10ms);
+
+  // A jthread sleeping for long ends as soon as it is asked to stop.
+  std::atomic<bool> slept{true};
+  start = steady_clock::now();
+  {
+    std::jthread t{[&](std::stop_token st) {
+      slept = free_rtos_std::this_thread::sleep_for(10s, st);
+    }};
+    std::this_thread::sleep_for(10ms);
+  }
+  TEST_ASSERT(!slept);
+  TEST_ASSERT(steady_clock::now() - start < 100ms);
+}
+
+inline void TestStopReceive()
+{
+  using namespace std::chrono_literals;
+  using namespace std::chrono;
+
+  free_rtos_std::channel<int, 2> ch;
+
+  // A value wins over the stop token.
+  std::stop_source src = NewStopSource();
+  const std::stop_token st = src.get_token();
+  ch.send(1);
+  TEST_EQ(1, ch.recv(st).value());
+
+  src.request_stop();
+  ch.send(2);
+  TEST_EQ(2, ch.recv_for(1s, st).value()); // a poll still receives
+  TEST_ASSERT(!ch.recv(st));
+
+  // Receive and read, stopped from a task of a lower and a higher priority.
+  for (UBaseType_t prio : {uxTaskPriorityGet(nullptr) - 1, uxTaskPriorityGet(nullptr) + 1})
+  {
+    std::stop_source stop = NewStopSource();
+    const std::stop_token st = stop.get_token();
+    free_rtos_std::byte_stream<8> bytes;
+    std::byte buf[4];
+    std::thread t = free_rtos_std::std_thread(free_rtos_std::attr_priority(prio), [&] {
+      std::this_thread::sleep_for(10ms);
+      stop.request_stop();
+    });
+    auto start = steady_clock::now();
+    TEST_ASSERT(!ch.recv(st));
+    TEST_ASSERT(bytes.read_for(buf, 10s, st).empty());
+    TEST_ASSERT(steady_clock::now() - start < 100ms);
+    t.join();
+  }
+}
+
+inline void TestStopKernelCall()
+{
+  using namespace std::chrono_literals;
+
+  // Any single blocking kernel call, here a semaphore.
+  TestBinarySemaphore kernelSem;
+  SemaphoreHandle_t sem = kernelSem.get();
+  std::atomic<BaseType_t> taken{pdTRUE};
+  {
+    std::jthread t{[&](std::stop_token st) {
+      taken = free_rtos_std::stoppable_block(st, portMAX_DELAY, [sem](TickType_t ticks) {
+        return xSemaphoreTake(sem, ticks);
+      });
+    }};
+    std::this_thread::sleep_for(10ms);
+  }
+  TEST_EQ(pdFALSE, taken.load());
+
+  // The semaphore is given, nothing to abort.
+  xSemaphoreGive(sem);
+  TEST_EQ(pdTRUE, free_rtos_std::stoppable_block(std::stop_token{}, portMAX_DELAY, [sem](TickType_t ticks) {
+            return xSemaphoreTake(sem, ticks);
+          }));
+}
+
+inline void TestStopToken()
+{
+  TestStopSleep();
+  TestStopReceive();
+  TestStopKernelCall();
+}
+
+#endif //__STOP_TOKEN_TEST_H__
@@ -26,9 +26,12 @@
 #include <thread>
 #include <chrono>
 #include <stop_token>
+#include <cstdint>
+#include <memory>
 #include <numeric>
 
 #include "thread_with_attributes.h"
+#include "test_helpers.h"
 
 inline void DetachBeforeThreadEnd()
 {
@@ -70,6 +73,21 @@ inline void JoinAfterThreadEnd()
   t.join();
 }
 
+inline void JoinInLoop()
+{
+  // More threads than the pool of the zero-heap profile has slots, each one
+  // created right after the previous one has been joined, before the idle
+  // task has cleaned it up.
+  constexpr int COUNT{40};
+  int count{0};
+  for (int i = 0; i < COUNT; i++)
+  {
+    std::thread t{[&] { count++; }};
+    t.join();
+  }
+  TEST_EQ(COUNT, count);
+}
+
 inline void DestroyBeforeThreadEnd()
 {
   //using namespace std::chrono_literals;
@@ -150,6 +168,47 @@ inline void AssignWithStackSize()
   t.join();
 }
 
+inline void StateOnStack()
+{
+  // The callable and the arguments are moved to the stack of the new task.
+  struct Fn
+  {
+    int *destroyed;
+    int *result;
+    std::uintptr_t *distance;
+
+    Fn(int *d, int *r, std::uintptr_t *s) : destroyed{d}, result{r}, distance{s} {}
+    Fn(Fn &&r) : destroyed{r.destroyed}, result{r.result}, distance{r.distance} { r.destroyed = nullptr; }
+    ~Fn()
+    {
+      if (destroyed)
+        ++*destroyed;
+    }
+
+    void operator()(std::unique_ptr<int> v, int w)
+    {
+      std::uintptr_t local = reinterpret_cast<std::uintptr_t>(&v);
+      std::uintptr_t self = reinterpret_cast<std::uintptr_t>(this);
+      *distance = local > self ? local - self : self - local;
+      *result = *v + w;
+    }
+  };
+
+  int destroyed{0};
+  int result{0};
+  std::uintptr_t distance{~0U};
+  constexpr configSTACK_DEPTH_TYPE STACK{1024U};
+
+  std::thread t = free_rtos_std::std_thread_on_stack(free_rtos_std::attr_stack_size(STACK),
+                                                     Fn{&destroyed, &result, &distance},
+                                                     std::make_unique<int>(1), 2);
+  t.join();
+
+  TEST_EQ(1, destroyed); // only the moved-from copies are left
+  TEST_ASSERT(distance < STACK * sizeof(StackType_t));
+  TEST_EQ(3, result);
+}
+
 #if __cplusplus > 201703L
 inline void TestJThread()
 {
@@ -0,0 +1,92 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __THREAD_STATS_TEST_H__
+#define __THREAD_STATS_TEST_H__
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "freertos_thread_stats.h"
+#include "test_helpers.h"
+
+#if (configSTD_THREAD_STATS == 1)
+
+inline void TestThreadStatsWorker()
+{
+  using namespace std::chrono_literals;
+
+  std::atomic<int> phase{0};
+  std::thread t{[&] {
+    for (int i = 0; i < 5; i++)
+      std::this_thread::sleep_for(2ms); // voluntary switches
+
+    // busy for a few ticks
+    auto end = std::chrono::steady_clock::now() + 5ms;
+    while (std::chrono::steady_clock::now() < end)
+      ;
+
+    phase = 1;
+    while (phase != 2)
+      std::this_thread::yield();
+  }};
+
+  while (phase != 1)
+    std::this_thread::sleep_for(1ms);
+
+  auto stats = free_rtos_std::thread_stats(t.get_id());
+  phase = 2;
+  t.join();
+
+  TEST_ASSERT(stats.has_value());
+  TEST_ASSERT(stats->cpuTime >= 4ms);
+  TEST_ASSERT(stats->switches >= 5);
+  TEST_ASSERT(stats->voluntary >= 5);
+  TEST_ASSERT(stats->stackHighWaterMark > 0);
+}
+
+inline void TestThreadStatsSelf()
+{
+  std::optional<free_rtos_std::thread_statistics> stats;
+  std::thread t{[&] { stats = free_rtos_std::thread_stats(std::this_thread::get_id()); }};
+  t.join();
+
+  TEST_ASSERT(stats.has_value());
+  TEST_ASSERT(stats->switches >= 1);
+}
+
+inline void TestThreadStatsNotStdThread()
+{
+  // main task is not created by std::thread
+  TEST_ASSERT(!free_rtos_std::thread_stats(std::this_thread::get_id()).has_value());
+  TEST_ASSERT(!free_rtos_std::thread_stats(std::thread::id{}).has_value());
+}
+
+inline void TestThreadStats()
+{
+  TestThreadStatsWorker();
+  TestThreadStatsSelf();
+  TestThreadStatsNotStdThread();
+}
+
+#endif // configSTD_THREAD_STATS == 1
+
+#endif //__THREAD_STATS_TEST_H__
@@ -0,0 +1,86 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __TICKLESS_TEST_H__
+#define __TICKLESS_TEST_H__
+
+#include <chrono>
+#include <thread>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "test_helpers.h"
+
+#if (configUSE_TICKLESS_IDLE == 1)
+
+inline void TestTicklessLongSleep()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  // Nothing else runs, the idle task suppresses the tick for most of it.
+  auto irq0 = ulTickInterruptCount;
+  auto tick0 = xTaskGetTickCount();
+  auto t0 = steady_clock::now();
+
+  std::this_thread::sleep_for(500ms);
+
+  auto irqs = ulTickInterruptCount - irq0;
+  auto ticks = xTaskGetTickCount() - tick0;
+  auto t = steady_clock::now() - t0;
+
+  TEST_ASSERT(irqs < 50); // about 500 with the periodic tick
+
+  // the tick count is compensated and agrees with the clocks
+  TEST_ASSERT(ticks >= pdMS_TO_TICKS(500));
+  TEST_ASSERT(ticks <= pdMS_TO_TICKS(502));
+  TEST_ASSERT(t >= 500ms);
+  TEST_ASSERT(t < 510ms);
+}
+
+inline void TestTicklessWakeByThread()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  // a shorter sleeper ends the idle period of a longer one
+  auto t0 = steady_clock::now();
+  nanoseconds tShort;
+  std::thread t{[&] {
+    std::this_thread::sleep_for(30ms);
+    tShort = steady_clock::now() - t0;
+  }};
+  std::this_thread::sleep_for(100ms);
+  auto tLong = steady_clock::now() - t0;
+  t.join();
+
+  TEST_ASSERT(tShort >= 30ms && tShort < 35ms);
+  TEST_ASSERT(tLong >= 100ms && tLong < 105ms);
+}
+
+inline void TestTickless()
+{
+  TestTicklessLongSleep();
+  TestTicklessWakeByThread();
+}
+
+#endif // configUSE_TICKLESS_IDLE == 1
+
+#endif //__TICKLESS_TEST_H__
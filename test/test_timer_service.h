@@ -0,0 +1,144 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __TIMER_SERVICE_TEST_H__
+#define __TIMER_SERVICE_TEST_H__
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "freertos_timer_service.h"
+#include "test_helpers.h"
+
+inline void TestTimerOrder()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::timer_service timers{8};
+  std::atomic<int> n{0};
+  int order[3]{};
+
+  timers.schedule_after(30ms, [&] { order[n++] = 3; });
+  timers.schedule_after(10ms, [&] { order[n++] = 1; });
+  timers.schedule_after(20ms, [&] { order[n++] = 2; });
+
+  std::this_thread::sleep_for(50ms);
+  TEST_ASSERT(n == 3);
+  TEST_ASSERT(order[0] == 1 && order[1] == 2 && order[2] == 3);
+  TEST_ASSERT(timers.pending() == 0);
+}
+
+inline void TestTimerAt()
+{
+  using namespace std::chrono;
+  using namespace std::chrono_literals;
+
+  free_rtos_std::timer_service timers{4};
+  std::atomic<bool> fired{false};
+  steady_clock::time_point t;
+
+  auto t0 = steady_clock::now();
+  timers.schedule_at(t0 + 20ms, [&] {
+    t = steady_clock::now();
+    fired = true;
+  });
+
+  while (!fired)
+    std::this_thread::sleep_for(1ms);
+  TEST_ASSERT(t - t0 >= 20ms);
+  TEST_ASSERT(t - t0 < 25ms + TEST_TIMING_SLACK);
+}
+
+inline void TestTimerCancel()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::timer_service timers{4};
+  std::atomic<int> n{0};
+
+  auto token = timers.schedule_after(20ms, [&] { n++; });
+  TEST_ASSERT(token.valid());
+  TEST_ASSERT(timers.cancel(token));
+  TEST_ASSERT(!timers.cancel(token)); // stale
+
+  std::this_thread::sleep_for(30ms);
+  TEST_ASSERT(n == 0);
+
+  // a token of a fired timer is stale too
+  token = timers.schedule_after(1ms, [&] { n++; });
+  std::this_thread::sleep_for(10ms);
+  TEST_ASSERT(n == 1);
+  TEST_ASSERT(!timers.cancel(token));
+}
+
+inline void TestTimerPeriodic()
+{
+  using namespace std::chrono_literals;
+
+  free_rtos_std::timer_service timers{4};
+  std::atomic<int> n{0};
+
+  auto token = timers.schedule_every(5ms, [&] { n++; });
+  std::this_thread::sleep_for(52ms);
+  TEST_ASSERT(timers.cancel(token));
+  int count = n;
+  TEST_ASSERT(count >= 9 && count <= 11);
+
+  std::this_thread::sleep_for(20ms);
+  TEST_ASSERT(n == count);
+  TEST_ASSERT(timers.pending() == 0);
+}
+
+inline void TestTimerMany()
+{
+  using namespace std::chrono_literals;
+
+  constexpr int N{100};
+  free_rtos_std::timer_service timers{N};
+  std::atomic<int> n{0};
+
+  // none expires before all are scheduled
+  for (int i = 0; i < N; i++)
+    TEST_ASSERT(timers.schedule_after(std::chrono::milliseconds(10 + (i * 37) % 100), [&] { n++; }).valid());
+
+  // all slots are in use
+  TEST_ASSERT(!timers.schedule_after(1ms, [] {}).valid());
+  TEST_ASSERT(timers.pending() == N);
+
+  std::this_thread::sleep_for(150ms);
+  TEST_ASSERT(n == N);
+
+  // far away timer, beyond the range of the wheel
+  auto far = timers.schedule_after(std::chrono::hours(24 * 7), [&] { n++; });
+  TEST_ASSERT(far.valid());
+  TEST_ASSERT(timers.cancel(far));
+}
+
+inline void TestTimerService()
+{
+  TestTimerOrder();
+  TestTimerAt();
+  TestTimerCancel();
+  TestTimerPeriodic();
+  TestTimerMany();
+}
+
+#endif //__TIMER_SERVICE_TEST_H__
@@ -0,0 +1,127 @@
+/// Copyright 2018-2023 Piotr Grygorczuk <grygorek@gmail.com>
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to deal
+/// in the Software without restriction, including without limitation the rights
+/// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+/// copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in all
+/// copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+/// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+/// THE SOFTWARE.
+
+#ifndef __TRACE_TEST_H__
+#define __TRACE_TEST_H__
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "freertos_trace.h"
+#include "test_helpers.h"
+
+#if (configSTD_TRACE == 1)
+
+using free_rtos_std::trace::event;
+
+inline free_rtos_std::trace::record s_traceRecords[64];
+
+// Position of the first record of type 'e' and 'object' starting at 'from'.
+// Returns 'n' if not found.
+inline std::size_t FindTraceRecord(std::size_t from, std::size_t n, event e, const void *object)
+{
+  for (auto i = from; i < n; i++)
+  {
+    const auto &rec = s_traceRecords[i];
+    if (rec.type == static_cast<std::uint8_t>(e) &&
+        rec.object == static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(object)))
+      return i;
+  }
+  return n;
+}
+
+inline void TestTraceThread()
+{
+  namespace trace = free_rtos_std::trace;
+  trace::clear();
+
+  TaskHandle_t hnd{};
+  std::thread t{[&] { hnd = xTaskGetCurrentTaskHandle(); }};
+  t.join();
+
+  auto n = trace::snapshot(s_traceRecords, std::size(s_traceRecords));
+
+  // expected order: create, start, exit, join
+  auto create = FindTraceRecord(0, n, event::thread_create, hnd);
+  auto start = FindTraceRecord(create, n, event::thread_start, hnd);
+  auto exit = FindTraceRecord(start, n, event::thread_exit, hnd);
+  auto join = FindTraceRecord(exit, n, event::thread_join, hnd);
+  TEST_ASSERT(create < n);
+  TEST_ASSERT(start < n);
+  TEST_ASSERT(exit < n);
+  TEST_ASSERT(join < n);
+
+  // thread start is recorded by the new task itself
+  TEST_EQ(static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(hnd)), s_traceRecords[start].task);
+}
+
+inline void TestTraceMutexCv()
+{
+  namespace trace = free_rtos_std::trace;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool fReady{false};
+  const void *mtxHandle = free_rtos_std::mutex_handle(mtx.native_handle());
+
+  trace::clear();
+  std::thread t{[&] {
+    std::lock_guard<std::mutex> lg{mtx};
+    fReady = true;
+    cv.notify_one();
+  }};
+
+  {
+    std::unique_lock<std::mutex> lock{mtx};
+    cv.wait(lock, [&] { return fReady; });
+  }
+  t.join();
+
+  auto n = trace::snapshot(s_traceRecords, std::size(s_traceRecords));
+  TEST_ASSERT(FindTraceRecord(0, n, event::mutex_take, mtxHandle) < n);
+  TEST_ASSERT(FindTraceRecord(0, n, event::mutex_give, mtxHandle) < n);
+  TEST_ASSERT(FindTraceRecord(0, n, event::cv_signal, cv.native_handle()) < n);
+}
+
+inline void TestTraceDisable()
+{
+  namespace trace = free_rtos_std::trace;
+  trace::clear();
+  trace::enable(false);
+
+  std::mutex mtx;
+  mtx.lock();
+  mtx.unlock();
+
+  trace::enable(true);
+  TEST_EQ(0U, trace::snapshot(s_traceRecords, std::size(s_traceRecords)));
+}
+
+inline void TestTrace()
+{
+  TestTraceThread();
+  TestTraceMutexCv();
+  TestTraceDisable();
+}
+
+#endif // configSTD_TRACE == 1
+
+#endif //__TRACE_TEST_H__
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+# Copyright 2018-2025 Piotr Grygorczuk <grygorek@gmail.com>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""Convert a trace of FreeRTOS/cpp11_gcc/freertos_trace.h to Chrome trace JSON.
+
+The input is either a binary file written by trace::export_binary or a console
+log containing the output of trace::export_text. The result can be opened in
+https://ui.perfetto.dev or chrome://tracing.
+
+usage: trace2perfetto.py <input> <output.json>
+"""
+
+import json
+import struct
+import sys
+
+FILE_MAGIC = 0x52545246
+HEADER = struct.Struct("<IHHII")
+RECORD = struct.Struct("<IIIBBH")
+
+# Must match free_rtos_std::trace::event
+EVENTS = {
+    1: "thread_create",
+    2: "thread_start",
+    3: "thread_exit",
+    4: "thread_join",
+    5: "thread_detach",
+    6: "mutex_take",
+    7: "mutex_give",
+    8: "cv_wait",
+    9: "cv_wake",
+    10: "cv_signal",
+    11: "cv_broadcast",
+    12: "once",
+    13: "key_set",
+}
+
+
+def read_binary(data):
+    magic, version, record_size, clock_hz, count = HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC:
+        raise ValueError("not a trace file")
+    records = []
+    offset = HEADER.size
+    for _ in range(count):
+        ts, task, obj, ev, core, _ = RECORD.unpack_from(data, offset)
+        records.append((core, ts, task, ev, obj))
+        offset += record_size
+    return clock_hz, records
+
+
+def read_text(text):
+    clock_hz = None
+    records = []
+    for line in text.splitlines():
+        fields = line.split()
+        if not fields:
+            continue
+        if fields[0] == "TRACE_BEGIN":
+            # a new dump replaces the previous one
+            clock_hz = int(fields[2], 16)
+            records = []
+        elif fields[0] == "TR" and len(fields) == 6:
+            records.append(tuple(int(f, 16) for f in fields[1:]))
+    if clock_hz is None:
+        raise ValueError("TRACE_BEGIN not found")
+    return clock_hz, records
+
+
+def unwrap(records):
+    """Extend 32 bit timestamps to 64 bits, per core."""
+    last = {}
+    result = []
+    for core, ts, task, ev, obj in records:
+        prev = last.get(core)
+        if prev is None:
+            full = ts
+        else:
+            full = prev + ((ts - (prev & 0xFFFFFFFF)) & 0xFFFFFFFF)
+        last[core] = full
+        result.append((core, full, task, ev, obj))
+    return result
+
+
+def convert(clock_hz, records):
+    out = []
+    tasks = set()
+    for core, ts, task, ev, obj in unwrap(records):
+        us = ts * 1e6 / clock_hz
+        name = EVENTS.get(ev, "event_%d" % ev)
+        base = {"pid": core, "tid": task, "ts": us}
+        tasks.add((core, task))
+
+        if ev == 2:  # thread_start .. thread_exit
+            out.append(dict(base, ph="B", name="thread"))
+        elif ev == 3:
+            out.append(dict(base, ph="E", name="thread"))
+        elif ev in (6, 7):  # lock held, may not nest
+            ph = "b" if ev == 6 else "e"
+            out.append(dict(base, ph=ph, cat="mutex", name="mutex 0x%08x" % obj,
+                            id="0x%08x-0x%08x" % (obj, task)))
+        elif ev in (8, 9):  # cv wait
+            ph = "b" if ev == 8 else "e"
+            out.append(dict(base, ph=ph, cat="cv", name="cv wait 0x%08x" % obj,
+                            id="0x%08x-0x%08x" % (obj, task)))
+        else:
+            out.append(dict(base, ph="i", s="t", name=name,
+                            args={"object": "0x%08x" % obj}))
+
+    for core, task in sorted(tasks):
+        out.append({"ph": "M", "pid": core, "tid": task, "name": "thread_name",
+                    "args": {"name": "task 0x%08x" % task}})
+        out.append({"ph": "M", "pid": core, "name": "process_name",
+                    "args": {"name": "core %d" % core}})
+    return {"traceEvents": out, "displayTimeUnit": "ns"}
+
+
+def main(argv):
+    if len(argv) != 3:
+        print(__doc__)
+        return 1
+
+    with open(argv[1], "rb") as f:
+        data = f.read()
+
+    if len(data) >= HEADER.size and struct.unpack_from("<I", data)[0] == FILE_MAGIC:
+        clock_hz, records = read_binary(data)
+    else:
+        clock_hz, records = read_text(data.decode("utf-8", errors="replace"))
+
+    with open(argv[2], "w") as f:
+        json.dump(convert(clock_hz, records), f)
+    print("%d records converted" % len(records))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -53,7 +53,7 @@ SET(COMPILE_COMMON_FLAGS "${CONFIG_DEFS} ${COMPILE_PART_FLAGS} -Wall -Wextra -Wp
 
 # When enabling exceptions, change the linker script to link libstdc++.a instead of libstdc++_nano.a
 SET(CMAKE_C_FLAGS   "${COMPILE_COMMON_FLAGS} -std=c17  -nostdlib  -fno-builtin " CACHE INTERNAL "" FORCE)
-SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -nostdlib -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
+SET(CMAKE_CXX_FLAGS "${COMPILE_COMMON_FLAGS} -std=c++2a -fcoroutines -nostdlib -fno-builtin -fno-exceptions -fno-rtti -fno-unwind-tables" CACHE INTERNAL "" FORCE)
 SET(CMAKE_ASM_FLAGS "-x assembler-with-cpp ${COMPILE_PART_FLAGS}"  CACHE INTERNAL "" FORCE)
 
 include_directories( 
@@ -61,6 +61,7 @@ include_directories(
   ${APPLICATION_DIR}/cmsis
   
   test
+  bench
 
   FreeRTOS/Source/include 
   FreeRTOS 
@@ -80,22 +81,38 @@ endif(CMAKE_CXX_COMPILER_VERSION LESS 11)
 add_subdirectory(FreeRTOS)
 add_subdirectory(libstdc++_gcc/${GCC_VER_DIR})
 
-add_executable(${PROJECT_NAME}.elf  
+set(PLATFORM_SOURCES
   ${APPLICATION_DIR}/startup_ARMCA9.cpp
   ${APPLICATION_DIR}/system_ARMCA9.c
   ${APPLICATION_DIR}/console.cpp
   ${APPLICATION_DIR}/ca9_global_timer.c
   ${APPLICATION_DIR}/cmsis/irq_ctrl_gic.c
   ${APPLICATION_DIR}/FreeRTOS_ca9_hooks.c
-  ${APPLICATION_DIR}/main.cpp
 
   sys_common/FreeRTOS_hooks.cpp
   sys_common/FreeRTOS_memory.cpp
   sys_common/sys.cpp
 )
 
+add_executable(${PROJECT_NAME}.elf  
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/main.cpp
+)
+
 target_link_libraries(
   ${PROJECT_NAME}.elf
   freeRTOS
   std++_freertos
 )
+
+# Micro-benchmarks
+add_executable(bench_ca9.elf
+  ${PLATFORM_SOURCES}
+  ${APPLICATION_DIR}/bench_main.cpp
+)
+
+target_link_libraries(
+  bench_ca9.elf
+  freeRTOS
+  std++_freertos
+)